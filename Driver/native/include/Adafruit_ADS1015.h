@@ -0,0 +1,59 @@
+#ifndef __NATIVE_ADAFRUIT_ADS1015_H__
+#define __NATIVE_ADAFRUIT_ADS1015_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the Adafruit ADS1X15 library (1.x). Talks to the simulated ADS1115 on the I2C bus.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define ADS1015_ADDRESS (0x48)
+
+#define ADS1015_REG_POINTER_CONVERT (0x00)
+#define ADS1015_REG_POINTER_CONFIG (0x01)
+
+#define ADS1015_REG_CONFIG_OS_MASK (0x8000)
+#define ADS1015_REG_CONFIG_OS_SINGLE (0x8000)
+#define ADS1015_REG_CONFIG_OS_BUSY (0x0000)
+#define ADS1015_REG_CONFIG_OS_NOTBUSY (0x8000)
+#define ADS1015_REG_CONFIG_MUX_SINGLE_0 (0x4000)
+#define ADS1015_REG_CONFIG_MUX_SINGLE_1 (0x5000)
+#define ADS1015_REG_CONFIG_MUX_SINGLE_2 (0x6000)
+#define ADS1015_REG_CONFIG_MUX_SINGLE_3 (0x7000)
+#define ADS1015_REG_CONFIG_MODE_SINGLE (0x0100)
+#define ADS1015_REG_CONFIG_DR_1600SPS (0x0080)
+#define ADS1015_REG_CONFIG_CMODE_TRAD (0x0000)
+#define ADS1015_REG_CONFIG_CPOL_ACTVLOW (0x0000)
+#define ADS1015_REG_CONFIG_CLAT_NONLAT (0x0000)
+#define ADS1015_REG_CONFIG_CQUE_NONE (0x0003)
+
+typedef enum {
+    GAIN_TWOTHIRDS = 0x0000,
+    GAIN_ONE = 0x0200,
+    GAIN_TWO = 0x0400,
+    GAIN_FOUR = 0x0600,
+    GAIN_EIGHT = 0x0800,
+    GAIN_SIXTEEN = 0x0A00
+} adsGain_t;
+
+class Adafruit_ADS1015 {
+public:
+    Adafruit_ADS1015(uint8_t address = ADS1015_ADDRESS) : m_i2cAddress(address), m_gain(GAIN_TWOTHIRDS) { }
+    void begin(void) { Wire.begin(); }
+    uint16_t readADC_SingleEnded(uint8_t channel);
+    void setGain(adsGain_t gain) { m_gain = gain; }
+    adsGain_t getGain(void) { return m_gain; }
+
+protected:
+    uint8_t m_i2cAddress;
+    adsGain_t m_gain;
+};
+
+class Adafruit_ADS1115 : public Adafruit_ADS1015 {
+public:
+    Adafruit_ADS1115(uint8_t address = ADS1015_ADDRESS) : Adafruit_ADS1015(address) { }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef __NATIVE_ADAFRUIT_BME280_H__
+#define __NATIVE_ADAFRUIT_BME280_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the Adafruit BME280 library (2.1.x). Keeps the protected members of the original, so
+// subclasses compile unchanged. Talks to the simulated BME280 on the I2C bus.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_Sensor.h>
+
+#define BME280_ADDRESS (0x77)
+#define BME280_ADDRESS_ALTERNATE (0x76)
+
+typedef struct {
+    uint16_t dig_T1;
+    int16_t dig_T2;
+    int16_t dig_T3;
+    uint16_t dig_P1;
+    int16_t dig_P2;
+    int16_t dig_P3;
+    int16_t dig_P4;
+    int16_t dig_P5;
+    int16_t dig_P6;
+    int16_t dig_P7;
+    int16_t dig_P8;
+    int16_t dig_P9;
+    uint8_t dig_H1;
+    int16_t dig_H2;
+    uint8_t dig_H3;
+    int16_t dig_H4;
+    int16_t dig_H5;
+    int8_t dig_H6;
+} bme280_calib_data;
+
+class Adafruit_BME280 {
+public:
+    enum sensor_sampling {
+        SAMPLING_NONE = 0b000,
+        SAMPLING_X1 = 0b001,
+        SAMPLING_X2 = 0b010,
+        SAMPLING_X4 = 0b011,
+        SAMPLING_X8 = 0b100,
+        SAMPLING_X16 = 0b101
+    };
+    enum sensor_mode {
+        MODE_SLEEP = 0b00,
+        MODE_FORCED = 0b01,
+        MODE_NORMAL = 0b11
+    };
+    enum sensor_filter {
+        FILTER_OFF = 0b000,
+        FILTER_X2 = 0b001,
+        FILTER_X4 = 0b010,
+        FILTER_X8 = 0b011,
+        FILTER_X16 = 0b100
+    };
+    enum standby_duration {
+        STANDBY_MS_0_5 = 0b000,
+        STANDBY_MS_10 = 0b110,
+        STANDBY_MS_20 = 0b111,
+        STANDBY_MS_62_5 = 0b001,
+        STANDBY_MS_125 = 0b010,
+        STANDBY_MS_250 = 0b011,
+        STANDBY_MS_500 = 0b100,
+        STANDBY_MS_1000 = 0b101
+    };
+
+    Adafruit_BME280(void);
+
+    bool begin(uint8_t addr = BME280_ADDRESS, TwoWire *theWire = &Wire);
+    bool init(void);
+
+    void setSampling(sensor_mode mode = MODE_NORMAL,
+                     sensor_sampling tempSampling = SAMPLING_X16,
+                     sensor_sampling pressSampling = SAMPLING_X16,
+                     sensor_sampling humSampling = SAMPLING_X16,
+                     sensor_filter filter = FILTER_OFF,
+                     standby_duration duration = STANDBY_MS_0_5);
+
+    void takeForcedMeasurement(void);
+    float readTemperature(void);
+    float readPressure(void);
+    float readHumidity(void);
+    uint32_t sensorID(void) { return _sensorID; }
+
+protected:
+    TwoWire *_wire;
+
+    void readCoefficients(void);
+    bool isReadingCalibration(void);
+
+    void write8(byte reg, byte value);
+    uint8_t read8(byte reg);
+
+    uint8_t _i2caddr;
+    int32_t _sensorID;
+    int32_t t_fine;
+
+    bme280_calib_data _bme280_calib;
+
+    struct config {
+        unsigned int t_sb : 3;
+        unsigned int filter : 3;
+        unsigned int none : 1;
+        unsigned int spi3w_en : 1;
+        unsigned int get() { return (t_sb << 5) | (filter << 2) | spi3w_en; }
+    };
+    config _configReg;
+
+    struct ctrl_meas {
+        unsigned int osrs_t : 3;
+        unsigned int osrs_p : 3;
+        unsigned int mode : 2;
+        unsigned int get() { return (osrs_t << 5) | (osrs_p << 2) | mode; }
+    };
+    ctrl_meas _measReg;
+
+    struct ctrl_hum {
+        unsigned int none : 5;
+        unsigned int osrs_h : 3;
+        unsigned int get() { return (osrs_h); }
+    };
+    ctrl_hum _humReg;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef __NATIVE_ADAFRUIT_SENSOR_H__
+#define __NATIVE_ADAFRUIT_SENSOR_H__
+
+#include <Arduino.h>
+
+typedef struct {
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    int32_t reserved0;
+    int32_t timestamp;
+    union {
+        float data[4];
+        float temperature;
+        float pressure;
+        float relative_humidity;
+        float light;
+    };
+} sensors_event_t;
+
+typedef struct {
+    char name[12];
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    float max_value;
+    float min_value;
+    float resolution;
+    int32_t min_delay;
+} sensor_t;
+
+class Adafruit_Sensor {
+public:
+    virtual ~Adafruit_Sensor() { }
+    virtual bool getEvent(sensors_event_t *event) = 0;
+    virtual void getSensor(sensor_t *sensor) = 0;
+};
+
+#endif
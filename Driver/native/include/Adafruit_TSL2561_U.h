@@ -0,0 +1,32 @@
+#ifndef __NATIVE_ADAFRUIT_TSL2561_U_H__
+#define __NATIVE_ADAFRUIT_TSL2561_U_H__
+
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+
+#define TSL2561_ADDR_LOW (0x29)
+#define TSL2561_ADDR_FLOAT (0x39)
+#define TSL2561_ADDR_HIGH (0x49)
+
+typedef enum {
+    TSL2561_INTEGRATIONTIME_13MS = 0x00,
+    TSL2561_INTEGRATIONTIME_101MS = 0x01,
+    TSL2561_INTEGRATIONTIME_402MS = 0x02
+} tsl2561IntegrationTime_t;
+
+class Adafruit_TSL2561_Unified : public Adafruit_Sensor {
+public:
+    Adafruit_TSL2561_Unified(uint8_t addr, int32_t sensorID = -1) : addr(addr), sensorID(sensorID) { }
+    bool begin(void) { return true; }
+    void enableAutoRange(bool enable) { (void) enable; }
+    void setIntegrationTime(tsl2561IntegrationTime_t time) { integration = time; }
+    bool getEvent(sensors_event_t *event) override;
+    void getSensor(sensor_t *sensor) override { memset(sensor, 0, sizeof(sensor_t)); }
+
+private:
+    uint8_t addr;
+    int32_t sensorID;
+    tsl2561IntegrationTime_t integration = TSL2561_INTEGRATIONTIME_13MS;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef __NATIVE_ADAFRUIT_VEML6070_H__
+#define __NATIVE_ADAFRUIT_VEML6070_H__
+
+#include <Arduino.h>
+
+#define VEML6070_ADDR_H (0x39)
+#define VEML6070_ADDR_L (0x38)
+
+typedef enum veml6070_integrationtime {
+    VEML6070_HALF_T,
+    VEML6070_1_T,
+    VEML6070_2_T,
+    VEML6070_4_T
+} veml6070_integrationtime_t;
+
+class Adafruit_VEML6070 {
+public:
+    Adafruit_VEML6070(void) { }
+    void begin(veml6070_integrationtime_t itime) { (void) itime; }
+    uint16_t readUV(void) { return 100; }
+};
+
+#endif
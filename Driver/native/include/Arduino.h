@@ -0,0 +1,315 @@
+#ifndef __NATIVE_ARDUINO_H__
+#define __NATIVE_ARDUINO_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Minimal Arduino core for running the driver on a host system. Time is virtual: millis() and
+// micros() only advance by calls to delay() or delayMicroseconds() (see Hardware.h).
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x00
+#define OUTPUT 0x01
+#define INPUT_PULLUP 0x02
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define LED_BUILTIN 2
+#define A0 17
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_float(addr) (*reinterpret_cast<const float *>(addr))
+#define pgm_read_ptr(addr) (*reinterpret_cast<const void * const *>(addr))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define memcpy_P memcpy
+
+using std::isnan;
+using std::isinf;
+
+class __FlashStringHelper;
+
+size_t strlcpy(char *dst, const char *src, size_t size);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// time and pins
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+long random(long max);
+long random(long min, long max);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// String
+
+class String;
+
+class StringSumHelper;
+
+class String {
+public:
+    String(void) { }
+    String(const char *s) : s(s ? s : "") { }
+    String(const String &other) : s(other.s) { }
+    String(const __FlashStringHelper *s) : s(reinterpret_cast<const char *>(s)) { }
+    explicit String(char c) : s(1, c) { }
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimals = 2);
+    explicit String(double value, unsigned char decimals = 2);
+
+    String &operator =(const String &rhs) { s = rhs.s; return *this; }
+    String &operator =(const char *rhs) { s = rhs ? rhs : ""; return *this; }
+
+    unsigned int length(void) const { return s.length(); }
+    const char *c_str(void) const { return s.c_str(); }
+    bool reserve(unsigned int size) { s.reserve(size); return true; }
+
+    bool concat(const String &str) { s += str.s; return true; }
+    bool concat(const char *cstr) { if (cstr) s += cstr; return true; }
+    bool concat(char c) { s += c; return true; }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(float value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+    bool concat(const __FlashStringHelper *str) { return concat(reinterpret_cast<const char *>(str)); }
+
+    template <typename T> String &operator +=(const T &rhs) { concat(rhs); return *this; }
+
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, const String &rhs);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, const char *cstr);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, char c);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, int num);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, unsigned int num);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, long num);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, unsigned long num);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, float num);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, double num);
+    friend StringSumHelper &operator +(const StringSumHelper &lhs, const __FlashStringHelper *rhs);
+
+    bool equals(const String &other) const { return s == other.s; }
+    bool equals(const char *cstr) const { return s == (cstr ? cstr : ""); }
+    bool operator ==(const String &rhs) const { return equals(rhs); }
+    bool operator ==(const char *rhs) const { return equals(rhs); }
+    bool operator !=(const String &rhs) const { return !equals(rhs); }
+    bool operator !=(const char *rhs) const { return !equals(rhs); }
+    bool operator <(const String &rhs) const { return s < rhs.s; }
+    bool startsWith(const String &prefix) const { return s.compare(0, prefix.s.length(), prefix.s) == 0; }
+    bool endsWith(const String &suffix) const;
+
+    char charAt(unsigned int index) const { return index < s.length() ? s[index] : 0; }
+    char operator [](unsigned int index) const { return charAt(index); }
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &str, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int index) { if (index < s.length()) s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < s.length()) s.erase(index, count); }
+    void toLowerCase(void);
+    void toUpperCase(void);
+    void trim(void);
+
+    long toInt(void) const { return atol(s.c_str()); }
+    float toFloat(void) const { return atof(s.c_str()); }
+
+private:
+    std::string s;
+};
+
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String &s) : String(s) { }
+    StringSumHelper(const char *p) : String(p) { }
+    StringSumHelper(char c) : String(c) { }
+    StringSumHelper(int num) : String(num) { }
+    StringSumHelper(unsigned int num) : String(num) { }
+    StringSumHelper(long num) : String(num) { }
+    StringSumHelper(unsigned long num) : String(num) { }
+    StringSumHelper(float num) : String(num) { }
+    StringSumHelper(double num) : String(num) { }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Print, Printable, Stream
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() { }
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() { }
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return str ? write(reinterpret_cast<const uint8_t *>(str), strlen(str)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write(reinterpret_cast<const uint8_t *>(buffer), size); }
+    virtual int availableForWrite(void) { return 0; }
+    virtual void flush(void) { }
+
+    size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+    size_t print(const String &s) { return write(s.c_str(), s.length()); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(unsigned char value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(int value, int base = DEC) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned int value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(long long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned long long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+    size_t print(const Printable &p) { return p.printTo(*this); }
+    size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+    size_t println(void) { return write("\r\n"); }
+    template <typename T> size_t println(const T &value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(const T &value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual int peek(void) = 0;
+
+    void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes(reinterpret_cast<char *>(buffer), length); }
+    String readString(void);
+    String readStringUntil(char terminator);
+
+protected:
+    unsigned long timeout = 1000;
+    int timedRead(void);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Serial
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { this->baud = baud; }
+    void end(void) { }
+    void setDebugOutput(bool) { }
+    operator bool() const { return true; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite(void) override;
+    void flush(void) override;
+
+    int available(void) override { return 0; }
+    int read(void) override { return -1; }
+    int peek(void) override { return -1; }
+
+    unsigned long baudRate(void) const { return baud; }
+
+private:
+    unsigned long baud = 0;
+};
+
+extern HardwareSerial Serial;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IPAddress
+
+class IPAddress : public Printable {
+public:
+    IPAddress(void) { address.dword = 0; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+        address.bytes[0] = a; address.bytes[1] = b; address.bytes[2] = c; address.bytes[3] = d;
+    }
+    IPAddress(uint32_t dword) { address.dword = dword; }
+
+    operator uint32_t() const { return address.dword; }
+    uint8_t operator [](int index) const { return address.bytes[index]; }
+    uint8_t &operator [](int index) { return address.bytes[index]; }
+    bool operator ==(const IPAddress &rhs) const { return address.dword == rhs.address.dword; }
+    bool isSet(void) const { return address.dword != 0; }
+    bool fromString(const char *string);
+    String toString(void) const;
+
+    size_t printTo(Print &p) const override { return p.print(toString()); }
+
+private:
+    union {
+        uint8_t bytes[4];
+        uint32_t dword;
+    } address;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ESP
+
+#if defined(ESP8266)
+#include "Esp.h"
+#define ADC_MODE(mode) int __get_adc_mode(void) { return (int) (mode); }
+#define ADC_VCC 1
+#define ADC_TOUT 0
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef __NATIVE_ARDUINOHTTPCLIENT_H__
+#define __NATIVE_ARDUINOHTTPCLIENT_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Subset of the ArduinoHttpClient library that is used by the driver. Speaks real HTTP/1.1 over
+// the given client, so it works against a local stand-in server.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <Client.h>
+
+static const int HTTP_SUCCESS = 0;
+static const int HTTP_ERROR_CONNECTION_FAILED = -1;
+static const int HTTP_ERROR_API = -2;
+static const int HTTP_ERROR_TIMED_OUT = -3;
+static const int HTTP_ERROR_INVALID_RESPONSE = -4;
+
+class HttpClient : public Client {
+public:
+    static const int kNoContentLengthHeader = -1;
+    static const int kHttpPort = 80;
+
+    HttpClient(Client &client, const char *serverName, uint16_t port = kHttpPort);
+    HttpClient(Client &client, const String &serverName, uint16_t port = kHttpPort);
+
+    void beginRequest(void);
+    void endRequest(void);
+    void beginBody(void);
+
+    int get(const char *path);
+    int get(const String &path) { return get(path.c_str()); }
+    int post(const char *path);
+    int post(const String &path) { return post(path.c_str()); }
+    int startRequest(const char *path, const char *method);
+
+    void sendHeader(const char *header);
+    void sendHeader(const String &header) { sendHeader(header.c_str()); }
+    void sendHeader(const char *name, const char *value);
+    void sendHeader(const String &name, const String &value) { sendHeader(name.c_str(), value.c_str()); }
+    void sendHeader(const char *name, const String &value) { sendHeader(name, value.c_str()); }
+    void sendHeader(const char *name, int value);
+    void sendHeader(const String &name, int value) { sendHeader(name.c_str(), value); }
+
+    int responseStatusCode(void);
+    bool headerAvailable(void);
+    int readHeader(void);
+    String readHeaderName(void);
+    String readHeaderValue(void);
+    int skipResponseHeaders(void);
+    bool endOfHeadersReached(void) { return headersDone; }
+    int contentLength(void) { return length; }
+    bool isResponseChunked(void) { return false; }
+    String responseBody(void);
+
+    void setHttpResponseTimeout(uint32_t timeout) { responseTimeout = timeout; }
+    void connectionKeepAlive(void) { keepAlive = true; }
+    void noDefaultRequestHeaders(void) { defaultHeaders = false; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available(void) override;
+    int read(void) override;
+    int read(uint8_t *buffer, size_t size) override;
+    int peek(void) override;
+    void flush(void) override;
+
+    int connect(IPAddress ip, uint16_t port) override { return client.connect(ip, port); }
+    int connect(const char *host, uint16_t port) override { return client.connect(host, port); }
+    void stop(void) override;
+    uint8_t connected(void) override { return client.connected(); }
+    operator bool() override { return bool(client); }
+
+private:
+    String readLine(void);
+
+    Client &client;
+    String serverName;
+    uint16_t serverPort;
+    bool inRequest = false;
+    bool headersDone = false;
+    bool keepAlive = false;
+    bool defaultHeaders = true;
+    int statusCode = 0;
+    int length = kNoContentLengthHeader;
+    int bodyRead = 0;
+    uint32_t responseTimeout = 30000;
+    String currentHeaderName;
+    bool headerLineEmpty = true;
+    String currentHeaderValue;
+};
+
+#endif
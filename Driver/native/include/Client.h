@@ -0,0 +1,17 @@
+#ifndef __NATIVE_CLIENT_H__
+#define __NATIVE_CLIENT_H__
+
+#include <Arduino.h>
+
+class Client : public Stream {
+public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char *host, uint16_t port) = 0;
+    virtual int read(uint8_t *buffer, size_t size) = 0;
+    using Stream::read;
+    virtual void stop(void) = 0;
+    virtual uint8_t connected(void) = 0;
+    virtual operator bool() = 0;
+};
+
+#endif
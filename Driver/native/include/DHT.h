@@ -0,0 +1,21 @@
+#ifndef __NATIVE_DHT_H__
+#define __NATIVE_DHT_H__
+
+#include <Arduino.h>
+
+#define DHT11 11
+#define DHT22 22
+
+class DHT {
+public:
+    DHT(uint8_t pin, uint8_t type) : pin(pin), type(type) { }
+    void begin(void) { }
+    float readTemperature(bool fahrenheit = false, bool force = false);
+    float readHumidity(bool force = false);
+
+private:
+    uint8_t pin;
+    uint8_t type;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef __NATIVE_DALLASTEMPERATURE_H__
+#define __NATIVE_DALLASTEMPERATURE_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the DallasTemperature library. Simulates the DS18B20 probes of the hardware model,
+// every search of the bus and every conversion takes virtual time.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <OneWire.h>
+
+typedef uint8_t DeviceAddress[8];
+
+#define DEVICE_DISCONNECTED_C -127
+#define DEVICE_DISCONNECTED_RAW -7040
+
+class DallasTemperature {
+public:
+    DallasTemperature(OneWire *wire) : wire(wire) { }
+
+    void begin(void);
+    uint8_t getDeviceCount(void);
+    uint8_t getDS18Count(void) { return getDeviceCount(); }
+    bool getAddress(uint8_t *address, uint8_t index);
+    bool isConnected(const uint8_t *address);
+    bool validAddress(const uint8_t *address);
+    bool isParasitePowerMode(void) { return parasite; }
+    bool readPowerSupply(const uint8_t *address = NULL);
+
+    uint8_t getResolution(void) { return resolution; }
+    uint8_t getResolution(const uint8_t *address);
+    void setResolution(uint8_t resolution);
+    bool setResolution(const uint8_t *address, uint8_t resolution, bool skipGlobalBitResolutionCalculation = false);
+
+    void setWaitForConversion(bool wait) { waitForConversion = wait; }
+    bool getWaitForConversion(void) { return waitForConversion; }
+    void setCheckForConversion(bool check) { checkForConversion = check; }
+
+    void requestTemperatures(void);
+    bool requestTemperaturesByAddress(const uint8_t *address);
+    bool requestTemperaturesByIndex(uint8_t index);
+    bool isConversionComplete(void);
+    int16_t millisToWaitForConversion(uint8_t resolution);
+
+    float getTempC(const uint8_t *address);
+    float getTempCByIndex(uint8_t index);
+
+private:
+    OneWire *wire;
+    uint8_t resolution = 12;
+    bool waitForConversion = true;
+    bool checkForConversion = true;
+    bool parasite = false;
+    uint64_t conversion_end_us = 0;
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef __NATIVE_ESP8266WIFI_H__
+#define __NATIVE_ESP8266WIFI_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the ESP8266 WiFi station. Association and DHCP take virtual time as configured by the
+// hardware model. Clients connect to the host and port of the model through real TCP sockets.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <Client.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_WRONG_PASSWORD = 6,
+    WL_DISCONNECTED = 7
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} WiFiMode_t;
+
+#include <functional>
+
+struct WiFiEventStationModeConnected {
+    String ssid;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+class WiFiEventHandlerOpaque {
+public:
+    virtual ~WiFiEventHandlerOpaque() { }
+};
+
+typedef std::shared_ptr<WiFiEventHandlerOpaque> WiFiEventHandler;
+
+class ESP8266WiFiClass {
+public:
+    WiFiEventHandler onStationModeConnected(std::function<void(const WiFiEventStationModeConnected &)> handler);
+
+    bool mode(WiFiMode_t mode);
+    WiFiMode_t getMode(void) { return current_mode; }
+    void persistent(bool persistent) { this->persistent_credentials = persistent; }
+    bool getPersistent(void) { return persistent_credentials; }
+    bool setAutoConnect(bool) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+    bool forceSleepBegin(uint32_t us = 0) { (void) us; return mode(WIFI_OFF); }
+    bool forceSleepWake(void) { return true; }
+
+    bool hostname(const char *name) { host = name; return true; }
+    String hostname(void) { return host; }
+
+    bool config(IPAddress local_ip, IPAddress gateway, IPAddress subnet, IPAddress dns1 = (uint32_t) 0, IPAddress dns2 = (uint32_t) 0);
+    wl_status_t begin(const char *ssid, const char *passphrase = NULL, int32_t channel = 0, const uint8_t *bssid = NULL, bool connect = true);
+    wl_status_t begin(void);
+    uint8_t waitForConnectResult(unsigned long timeout = 60000);
+    bool disconnect(bool wifioff = false);
+    bool isConnected(void) { return status() == WL_CONNECTED; }
+    wl_status_t status(void);
+
+    String macAddress(void);
+    String SSID(void) const { return ssid; }
+    String psk(void) const { return passphrase; }
+    uint8_t *BSSID(void) { return bssid; }
+    String BSSIDstr(void);
+    int32_t channel(void) { return current_channel; }
+    int32_t RSSI(void) { return -60; }
+    IPAddress localIP(void) { return local_ip; }
+    IPAddress gatewayIP(void) { return gateway; }
+    IPAddress subnetMask(void) { return subnet; }
+    IPAddress dnsIP(uint8_t number = 0) { return number == 0 ? dns : IPAddress(); }
+
+    int hostByName(const char *name, IPAddress &result);
+
+private:
+    void associated(void);
+
+    WiFiMode_t current_mode = WIFI_STA;
+    wl_status_t current_status = WL_DISCONNECTED;
+    bool persistent_credentials = true;
+    bool static_ip = false;
+    String host;
+    String ssid;
+    String passphrase;
+    uint8_t bssid[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    int32_t current_channel = 6;
+    IPAddress local_ip;
+    IPAddress gateway;
+    IPAddress subnet;
+    IPAddress dns;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+class WiFiClient : public Client {
+public:
+    WiFiClient(void);
+    ~WiFiClient(void);
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available(void) override;
+    int read(void) override;
+    int read(uint8_t *buffer, size_t size) override;
+    int peek(void) override;
+    void flush(void) override { }
+    void stop(void) override;
+    uint8_t connected(void) override;
+    operator bool() override { return connected(); }
+
+    void setNoDelay(bool) { }
+
+private:
+    int fd;
+    int peeked;
+};
+
+#endif
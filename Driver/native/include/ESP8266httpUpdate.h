@@ -0,0 +1,23 @@
+#ifndef __NATIVE_ESP8266HTTPUPDATE_H__
+#define __NATIVE_ESP8266HTTPUPDATE_H__
+
+#include <Arduino.h>
+
+enum HTTPUpdateResult {
+    HTTP_UPDATE_FAILED,
+    HTTP_UPDATE_NO_UPDATES,
+    HTTP_UPDATE_OK
+};
+
+class ESP8266HTTPUpdate {
+public:
+    HTTPUpdateResult update(const String &url, const String &version) {
+        (void) url; (void) version;
+        return HTTP_UPDATE_NO_UPDATES;
+    }
+    String getLastErrorString(void) { return String(); }
+};
+
+extern ESP8266HTTPUpdate ESPhttpUpdate;
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef __NATIVE_ESP_H__
+#define __NATIVE_ESP_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the ESP8266 system object. Deep sleep ends the current run of the driver (see
+// Hardware.h), RTC user memory survives deep sleep just like on the chip.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <user_interface.h>
+
+class String;
+
+enum RFMode {
+    RF_DEFAULT = 0,
+    RF_CAL = 1,
+    RF_NO_CAL = 2,
+    RF_DISABLED = 4
+};
+
+#define WAKE_RF_DEFAULT  RF_DEFAULT
+#define WAKE_RFCAL       RF_CAL
+#define WAKE_NO_RFCAL    RF_NO_CAL
+#define WAKE_RF_DISABLED RF_DISABLED
+
+class EspClass {
+public:
+    uint32_t getChipId(void);
+    uint16_t getVcc(void);
+    uint32_t getFreeHeap(void);
+    uint32_t getCycleCount(void);
+    uint64_t deepSleepMax(void);
+
+    void deepSleep(uint64_t time_us, RFMode mode = RF_DEFAULT);
+    void restart(void);
+    void reset(void);
+
+    bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+    bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+
+    void wdtDisable(void);
+    void wdtEnable(uint32_t) { }
+    void wdtFeed(void) { }
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef __NATIVE_FS_H__
+#define __NATIVE_FS_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the SPIFFS file system backed by a directory of the host (see Hardware.h).
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#include <stdio.h>
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File : public Stream {
+public:
+    File(void) { }
+    File(FILE *file, const String &name) : file(file, fclose), filename(name) { }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available(void) override;
+    int read(void) override;
+    size_t read(uint8_t *buffer, size_t size);
+    int peek(void) override;
+    void flush(void) override;
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position(void) const;
+    size_t size(void) const;
+    void close(void);
+    const char *name(void) const { return filename.c_str(); }
+    operator bool() const { return file != nullptr; }
+
+private:
+    std::shared_ptr<FILE> file;
+    String filename;
+};
+
+class Dir {
+public:
+    Dir(const String &path) : path(path), index(-1) { }
+
+    bool next(void);
+    String fileName(void) const;
+    size_t fileSize(void) const;
+
+private:
+    String path;
+    int index;
+    String current;
+};
+
+struct FSInfo {
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+class FS {
+public:
+    bool begin(void);
+    void end(void) { }
+    bool format(void);
+    bool info(FSInfo &info);
+
+    File open(const char *path, const char *mode);
+    File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    Dir openDir(const char *path) { return Dir(String(path)); }
+    Dir openDir(const String &path) { return Dir(path); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *from, const char *to);
+    bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+};
+
+extern FS SPIFFS;
+
+// Returns the directory of the host that backs the file system.
+const char *native_fs_root(void);
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef __NATIVE_HARDWARE_H__
+#define __NATIVE_HARDWARE_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Virtual hardware the native fakes operate on. Holds the virtual time, the RTC user memory and
+// the parameters of the simulated peripherals.
+//
+// Everything a deep sleep must survive lives in one hardware_t block. A host program can place
+// that block into shared memory and run every wake of the driver in a fresh child process, which
+// resets all other state just like a reset of the chip does.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+
+namespace native {
+
+// Reset reasons as defined by the ESP8266 SDK.
+enum reset_reason {
+    reset_power_on = 0,
+    reset_soft_restart = 4,
+    reset_deep_sleep_awake = 5
+};
+
+// Phases the virtual hardware accounts time for. Phases may overlap, e.g. the CPU is active
+// during all other phases except sleep.
+enum phase {
+    phase_cpu = 0,      // awake
+    phase_radio = 1,    // radio powered up
+    phase_transmit = 2, // radio transmitting
+    phase_sensor = 3,   // sensor converting
+    phase_led = 4,      // signaling LED on
+    phase_sleep = 5,    // deep sleep
+    PHASE_MAX = phase_sleep
+};
+
+// State of the virtual hardware that survives deep sleep.
+typedef struct {
+    uint64_t time_us;                  // virtual time since power on
+    uint64_t boot_us;                  // virtual time of the last reset
+    uint32_t wakes;                    // number of resets since power on
+    uint32_t reset_reason;             // reason of the last reset
+    uint64_t sleep_us;                 // requested duration of the last deep sleep
+    uint32_t sleep_rf_mode;            // requested RF mode of the last deep sleep
+    uint32_t rtc_memory[128];          // RTC user memory (512 bytes)
+    uint64_t phase_us[PHASE_MAX + 1];  // accumulated time per phase
+    uint32_t associations;             // number of attempted WiFi associations
+    uint32_t association_failures;     // number of failed WiFi associations
+    uint32_t ntp_requests;             // number of NTP round trips
+    uint64_t tx_bytes;                 // number of bytes sent over TCP
+    uint32_t ds18b20_searches;         // number of searches of the 1-Wire bus
+    uint32_t ds18b20_writes;           // number of writes to the EEPROM of DS18B20 probes
+} hardware_t;
+
+// Parameters of the simulated hardware.
+typedef struct {
+    uint32_t chip_id;
+    uint32_t epoch;                    // wall-clock time at power on (unix seconds)
+    uint16_t vcc_millivolts;
+    float temperature;                 // °C
+    float pressure;                    // Pa
+    float humidity;                    // %
+    float illuminance;                 // lux
+    uint32_t wifi_associate_ms;        // association latency of a full connect (scan)
+    uint32_t wifi_associate_fast_ms;   // association latency when joining a given BSSID/channel
+    uint32_t wifi_dhcp_ms;             // DHCP latency
+    float wifi_failure_rate;           // probability of a failed association
+    uint32_t ntp_ms;                   // NTP round trip latency
+    uint32_t tcp_connect_ms;           // TCP connect latency
+    uint32_t http_response_ms;         // latency from the end of a request to its response
+    uint32_t tcp_bytes_per_ms;         // TX throughput used for transmit accounting
+    double sleep_drift;                // relative error of the deep sleep timer
+    uint8_t led_pin;                   // signaling LED, on while LOW
+    bool serial_echo;                  // copies serial output to stdout
+    const char *server_host;           // TCP connections are redirected to this host and port
+    uint16_t server_port;              //   (0 to use the requested port)
+    std::string (*responder)(const std::string &request); // answers requests without a server
+    const char *fs_root;               // host directory backing the flash file system
+    uint32_t halt_after_ms;            // awake time after which the chip is considered stuck
+    bool has_bme280;                   // I2C devices attached to the bus
+    bool has_bmp280;
+    bool has_sht30;
+    bool has_ads1115;
+    uint8_t ds18b20_count;             // DS18B20 probes attached to the 1-Wire bus
+    bool ds18b20_parasite;             // DS18B20 probes are powered by the data line
+    int extender_pin;                  // pin enabling the I2C extender or -1 if there is none
+    uint32_t extender_settle_ms;       // time until devices behind the extender respond
+    double conversion_scale;           // factor on conversion times of sensors (1 for datasheet)
+} model_t;
+
+extern hardware_t *hardware;
+extern model_t model;
+
+// Resets the virtual hardware to power on state, using the given memory for the state.
+void power_on(hardware_t *memory);
+// Resets the chip after a deep sleep, keeping RTC memory and file system.
+void wake(void);
+// Resets the chip after a restart, keeping RTC memory and file system.
+void reboot(void);
+
+// Returns the virtual time since power on in microseconds.
+uint64_t now(void);
+// Returns the virtual time since the last reset in microseconds.
+uint64_t uptime(void);
+// Advances the virtual time by the given amount of microseconds, accounting all active phases.
+void advance(uint64_t us);
+
+// Returns the true wall-clock time in unix seconds.
+uint32_t wallclock(void);
+
+// Marks a phase as active or inactive for the accounting of time.
+void activate(phase phase, bool active);
+
+// Marks a sensor as converting for the given amount of microseconds, scaled by the conversion
+// scale of the model. Returns the scaled amount.
+uint64_t convert(uint64_t us);
+
+// Called by the fakes when a digital output or input is accessed.
+void output_changed(uint8_t pin, uint8_t value);
+int input(uint8_t pin, uint8_t value);
+
+// Returns the virtual time of the last change of the given digital output.
+uint64_t output_changed_at(uint8_t pin);
+
+// Thrown by ESP.deepSleep to end the current run of the driver.
+struct deep_sleep {
+    uint64_t us;
+    uint32_t rf_mode;
+};
+
+// Thrown by ESP.restart and a hardware watchdog reset to end the current run of the driver.
+struct restart {
+};
+
+// Thrown when the driver stays awake longer than the model allows, e.g. blinking forever.
+struct halt {
+};
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef __NATIVE_INFLUX_H__
+#define __NATIVE_INFLUX_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Handling of write requests like InfluxDB 1.8 handles them on its /write endpoint. Requests are
+// decoded (chunked transfer encoding, gzip) and their lines are parsed and validated with the
+// same rules and error messages as InfluxDB, so a request accepted here is accepted by InfluxDB.
+// Used by the stand-in server of the simulator and by the ingest tool (see tools/).
+// Independent of the fakes of the hardware, only needs the standard library and zlib.
+//
+// As with InfluxDB, valid lines of a request are written even if other lines are invalid
+// (partial write), the request is answered with status 400 then.
+// See https://docs.influxdata.com/influxdb/v1.8/tools/api/#write-http-endpoint
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <time.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace native {
+namespace influx {
+
+enum field_type {
+    type_float,
+    type_integer,
+    type_unsigned,
+    type_string,
+    type_boolean
+};
+
+typedef struct {
+    std::string key;
+    field_type type;
+    std::string value;                 // as given in the line, strings without quotes
+} field_t;
+
+typedef struct {
+    std::string measurement;
+    std::vector<std::pair<std::string, std::string>> tags; // sorted by key
+    std::vector<field_t> fields;
+    bool timestamped;                  // false if the server takes the time of the write
+    int64_t timestamp;                 // nanoseconds since 1970-01-01
+} point_t;
+
+// Result of a request.
+typedef struct {
+    int status;                        // HTTP status code of the response
+    std::string error;                 // message of the response, empty if successful
+    std::string database;
+    std::string user_agent;
+    size_t body_size;                  // size of the body as sent (compressed)
+    size_t text_size;                  // size of the lines (uncompressed)
+    unsigned int lines;                // number of lines (without comments and empty lines)
+    std::vector<point_t> points;       // points written
+} write_t;
+
+// Returns the size of the first complete request of the given data received on a connection,
+// 0 if the request is not complete yet or -1 if the request is malformed.
+long request_size(const std::string &data);
+
+// Handles the given complete request. Answers /ping and /write (with POST). The given database
+// is the only database accepted (empty to accept any database).
+write_t handle(const std::string &request, const std::string &database = std::string());
+
+// Parses the given lines with the given precision ("n", "u", "ms", "s", "m" or "h"). Gives all
+// valid points and returns the errors of invalid lines (empty if all are valid).
+std::string parse(const std::string &text, const std::string &precision,
+    std::vector<point_t> &points, unsigned int &lines);
+
+// Returns the response to the given result with the given time for the Date header.
+std::string response(const write_t &result, time_t date);
+
+// Returns the name of the given field type as used in InfluxDB’s messages.
+const char *type_name(field_type type);
+
+// Types of the fields of all measurements written so far. InfluxDB refuses points with a field
+// of another type than written before (per shard, which is simplified to the whole database).
+class Schema {
+public:
+    // Removes points from the given result conflicting with types known so far and learns the
+    // types of the remaining points. Adjusts status and error of the result like InfluxDB does.
+    void admit(write_t &result);
+
+    void clear(void) { types.clear(); }
+
+private:
+    std::map<std::string, std::map<std::string, field_type>> types;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef __NATIVE_NTPCLIENT_H__
+#define __NATIVE_NTPCLIENT_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the NTPClient library. Answers with the virtual wall-clock time of the hardware model
+// after a simulated round trip.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+class NTPClient {
+public:
+    NTPClient(UDP &udp, const char *poolServerName) : udp(udp), server(poolServerName) { }
+    NTPClient(UDP &udp, const char *poolServerName, long timeOffset, unsigned long updateInterval)
+        : udp(udp), server(poolServerName) { (void) timeOffset; (void) updateInterval; }
+
+    void begin(void) { }
+    void end(void) { }
+    bool update(void) { return forceUpdate(); }
+    bool forceUpdate(void);
+    unsigned long getEpochTime(void) const;
+
+private:
+    UDP &udp;
+    const char *server;
+    unsigned long epoch = 0;
+    unsigned long lastUpdate = 0;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef __NATIVE_ONEWIRE_H__
+#define __NATIVE_ONEWIRE_H__
+
+#include <Arduino.h>
+
+class OneWire {
+public:
+    OneWire(uint8_t pin) : pin(pin) { }
+
+    uint8_t reset(void) { return 1; }
+    void reset_search(void) { }
+    uint8_t read_bit(void) { return 1; }
+
+private:
+    uint8_t pin;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef __NATIVE_RTCLIB_H__
+#define __NATIVE_RTCLIB_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the RTClib library. The software RTC runs on virtual time, there is no DS3231.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define SECONDS_FROM_1970_TO_2000 946684800
+
+class DateTime {
+public:
+    DateTime(uint32_t t = SECONDS_FROM_1970_TO_2000);
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+    DateTime(const char *date, const char *time);
+
+    uint16_t year(void) const { return 2000U + yOff; }
+    uint8_t month(void) const { return m; }
+    uint8_t day(void) const { return d; }
+    uint8_t hour(void) const { return hh; }
+    uint8_t minute(void) const { return mm; }
+    uint8_t second(void) const { return ss; }
+    uint32_t unixtime(void) const;
+
+protected:
+    uint8_t yOff, m, d, hh, mm, ss;
+};
+
+class RTC_Millis {
+public:
+    void begin(const DateTime &dt) { adjust(dt); }
+    void adjust(const DateTime &dt);
+    DateTime now(void);
+
+protected:
+    uint32_t lastUnix = 0;
+    uint32_t lastMillis = 0;
+};
+
+class RTC_DS3231 {
+public:
+    bool begin(void) { return false; }
+    bool lostPower(void) { return true; }
+    void adjust(const DateTime &dt) { (void) dt; }
+    DateTime now(void) { return DateTime(); }
+};
+
+#endif
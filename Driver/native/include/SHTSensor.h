@@ -0,0 +1,31 @@
+#ifndef __NATIVE_SHTSENSOR_H__
+#define __NATIVE_SHTSENSOR_H__
+
+#include <Arduino.h>
+
+class SHTSensor {
+public:
+    enum SHTSensorType {
+        AUTO_DETECT,
+        SHT3X,
+        SHT85,
+        SHT3X_ALT,
+        SHTC1,
+        SHTW1,
+        SHTW2,
+        SHT4X
+    };
+
+    SHTSensor(SHTSensorType type = AUTO_DETECT) : type(type) { }
+    bool init(void) { return true; }
+    bool readSample(void);
+    float getTemperature(void) const { return temperature; }
+    float getHumidity(void) const { return humidity; }
+
+private:
+    SHTSensorType type;
+    float temperature = NAN;
+    float humidity = NAN;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef __NATIVE_SPI_H__
+#define __NATIVE_SPI_H__
+
+#include <Arduino.h>
+
+class SPIClass {
+public:
+    void begin(void) { }
+    void end(void) { }
+};
+
+extern SPIClass SPI;
+
+#endif
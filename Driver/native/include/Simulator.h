@@ -0,0 +1,60 @@
+#ifndef __NATIVE_SIMULATOR_H__
+#define __NATIVE_SIMULATOR_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Simulation of a station over a long time. Runs wake after wake of the driver on the virtual
+// hardware, drains a battery by the current drawn in each phase of the hardware and lets the
+// environment follow a daily cycle. Requests are answered by a stand-in server, which counts the
+// readings it receives, so readings that never arrive are found.
+//
+// Parameters are given as key=value settings (see configure), so configurations can be swept
+// by scripts and the same configuration can be run against different firmware builds.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "Hardware.h"
+
+namespace native {
+
+// Parameters of the simulation beyond the hardware model.
+typedef struct {
+    uint32_t wakes;                    // number of wakes to run (0 for no limit)
+    double days;                       // virtual time to run (0 for no limit)
+    float current_ma[PHASE_MAX + 1];   // current per phase, in addition to the CPU if awake
+    float battery_mah;                 // capacity of the battery (0 for no battery)
+    uint16_t vcc_full_millivolts;      // supply voltage of a full battery
+    uint16_t vcc_empty_millivolts;     // supply voltage of an empty battery (end of simulation)
+    float temperature_mean;            // °C
+    float temperature_swing;           // °C, amplitude of the daily cycle (warmest at 15:00)
+    float http_failure_rate;           // probability of a request failing with status 500
+} simulation_t;
+
+extern simulation_t simulation;
+
+// Sets the parameter of the simulation or of the hardware model given as key=value. Returns false
+// if the key is unknown or the value is invalid.
+bool configure(const char *setting);
+// Sets the parameters given as key=value lines of the given file (# starts a comment).
+bool configure_file(const char *path);
+// Prints all keys with their current values.
+void print_configuration(FILE *file);
+
+// Answers a request like InfluxDB answers a write and counts the readings of the request. Fails
+// requests as often as configured. Used as responder of the hardware model.
+std::string stand_in(const std::string &request);
+
+// Runs the simulation until the number of wakes or days is reached or the battery is empty.
+// Prints a line for each wake if verbose.
+void simulate(bool verbose);
+
+// Prints the results of the last simulation as key=value lines.
+void print_report(FILE *file);
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef __NATIVE_TICKER_H__
+#define __NATIVE_TICKER_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the ESP8266 Ticker. Millisecond tickers are run by delay() (like os_timer callbacks,
+// which only run while the loop yields). Others are ignored.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <functional>
+
+namespace native {
+    void ticker_attach(void *ticker, uint32_t ms, std::function<void(void)> callback);
+    void ticker_detach(void *ticker);
+}
+
+class Ticker {
+public:
+    typedef void (*callback_t)(void);
+    ~Ticker() { detach(); }
+    void attach(float seconds, callback_t callback) { (void) seconds; (void) callback; }
+    void attach_ms(uint32_t ms, callback_t callback) { native::ticker_attach(this, ms, callback); }
+    template <typename TArg> void attach_ms(uint32_t ms, void (*callback)(TArg), TArg arg) {
+        native::ticker_attach(this, ms, [callback, arg]() { callback(arg); });
+    }
+    void detach(void) { native::ticker_detach(this); }
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef __NATIVE_WIFIMANAGER_H__
+#define __NATIVE_WIFIMANAGER_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the WiFiManager. There is no configuration portal, autoConnect just joins the network.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <ESP8266WiFi.h>
+
+class WiFiManagerParameter {
+public:
+    WiFiManagerParameter(const char *id, const char *placeholder, const char *value, int length)
+        : id(id), placeholder(placeholder), value(value), length(length) { }
+    const char *getValue(void) const { return value; }
+
+private:
+    const char *id;
+    const char *placeholder;
+    const char *value;
+    int length;
+};
+
+class WiFiManager {
+public:
+    void setDebugOutput(bool) { }
+    void setConnectTimeout(unsigned long) { }
+    void setConfigPortalTimeout(unsigned long) { }
+    void addParameter(WiFiManagerParameter *) { }
+    void setAPCallback(void (*)(WiFiManager *)) { }
+    void setSaveConfigCallback(void (*)(void)) { }
+    bool autoConnect(const char *ssid, const char *password) {
+        (void) ssid; (void) password;
+        WiFi.begin();
+        return WiFi.waitForConnectResult() == WL_CONNECTED;
+    }
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef __NATIVE_WIFIUDP_H__
+#define __NATIVE_WIFIUDP_H__
+
+#include <Arduino.h>
+
+class UDP : public Stream {
+};
+
+class WiFiUDP : public UDP {
+public:
+    uint8_t begin(uint16_t port) { (void) port; return 1; }
+    void stop(void) { }
+    int beginPacket(const char *host, uint16_t port) { (void) host; (void) port; return 1; }
+    int endPacket(void) { return 1; }
+    int parsePacket(void) { return 0; }
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t *, size_t size) override { return size; }
+    using Print::write;
+    int available(void) override { return 0; }
+    int read(void) override { return -1; }
+    int read(unsigned char *, size_t) { return 0; }
+    int peek(void) override { return -1; }
+};
+
+#endif
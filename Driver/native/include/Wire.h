@@ -0,0 +1,41 @@
+#ifndef __NATIVE_WIRE_H__
+#define __NATIVE_WIRE_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Fake of the I2C bus. Devices are simulated as register files (see Devices.h).
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+class TwoWire : public Stream {
+public:
+    void begin(void) { }
+    void begin(int sda, int scl) { (void) sda; (void) scl; }
+    void setClock(uint32_t) { }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission(static_cast<uint8_t>(address)); }
+    uint8_t endTransmission(bool stop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool stop = true);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom(static_cast<uint8_t>(address), static_cast<uint8_t>(quantity)); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available(void) override;
+    int read(void) override;
+    int peek(void) override;
+
+private:
+    uint8_t address = 0;
+    uint8_t tx[32];
+    size_t tx_length = 0;
+    uint8_t rx[32];
+    size_t rx_length = 0;
+    size_t rx_index = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
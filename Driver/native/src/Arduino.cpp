@@ -0,0 +1,371 @@
+#include <Arduino.h>
+#include <Ticker.h>
+
+#include <map>
+#include <functional>
+
+#include <stdarg.h>
+
+#include "Hardware.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t strlcpy(char *dst, const char *src, size_t size) {
+    size_t length = strlen(src);
+    if (size > 0) {
+        size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// time and pins
+
+// every access to the clock costs some virtual time, so busy polling loops terminate
+static const uint64_t CLOCK_ACCESS_US = 5;
+
+unsigned long millis(void) {
+    native::advance(CLOCK_ACCESS_US);
+    return static_cast<unsigned long>(native::uptime() / 1000);
+}
+
+unsigned long micros(void) {
+    native::advance(CLOCK_ACCESS_US);
+    return static_cast<unsigned long>(native::uptime());
+}
+
+namespace {
+struct ticker_entry {
+    uint64_t period_us;
+    uint64_t due_us;
+    std::function<void(void)> callback;
+};
+// never destroyed, tickers of globals detach during exit
+std::map<void *, ticker_entry> &tickers = *new std::map<void *, ticker_entry>();
+bool ticking = false;
+
+// Runs due tickers, as the SDK does whenever the loop yields.
+void run_tickers(void) {
+    if (ticking) return;
+    ticking = true;
+    for (auto &entry : tickers) {
+        if (entry.second.due_us <= native::now()) {
+            entry.second.due_us = native::now() + entry.second.period_us;
+            entry.second.callback();
+        }
+    }
+    ticking = false;
+}
+}
+
+void native::ticker_attach(void *ticker, uint32_t ms, std::function<void(void)> callback) {
+    tickers[ticker] = ticker_entry { ms * 1000ULL, native::now() + ms * 1000ULL, callback };
+}
+
+void native::ticker_detach(void *ticker) {
+    tickers.erase(ticker);
+}
+
+void delay(unsigned long ms) {
+    uint64_t until = native::now() + static_cast<uint64_t>(ms) * 1000;
+    while (!tickers.empty()) {
+        uint64_t next = until;
+        for (auto &entry : tickers) next = std::min(next, entry.second.due_us);
+        if (next >= until) break;
+        if (next > native::now()) native::advance(next - native::now());
+        run_tickers();
+    }
+    if (until > native::now()) native::advance(until - native::now());
+    run_tickers();
+}
+
+void delayMicroseconds(unsigned int us) {
+    native::advance(us);
+}
+
+void yield(void) {
+    native::advance(CLOCK_ACCESS_US);
+    run_tickers();
+}
+
+static uint8_t pin_modes[32];
+static uint8_t pin_values[32];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < 32) {
+        pin_modes[pin] = mode;
+        if (mode == INPUT_PULLUP) pin_values[pin] = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < 32) {
+        pin_values[pin] = value ? HIGH : LOW;
+        native::output_changed(pin, pin_values[pin]);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < 32 ? native::input(pin, pin_values[pin]) : LOW;
+}
+
+int analogRead(uint8_t pin) {
+    (void) pin;
+    return 512;
+}
+
+long random(long max) {
+    return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max) {
+    return max > min ? min + random(max - min) : min;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// String
+
+static std::string format_unsigned(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 16) base = 10;
+    char buffer[72];
+    char *p = buffer + sizeof(buffer) - 1;
+    *p = '\0';
+    do {
+        *--p = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value);
+    return std::string(p);
+}
+
+static std::string format_signed(long long value, unsigned char base) {
+    if (value < 0 && base == 10) {
+        return "-" + format_unsigned(static_cast<unsigned long long>(-(value + 1)) + 1, base);
+    }
+    return format_unsigned(static_cast<unsigned long long>(value), base);
+}
+
+String::String(unsigned char value, unsigned char base) : s(format_unsigned(value, base)) { }
+String::String(int value, unsigned char base)
+    : s(base == 10 ? format_signed(value, base) : format_unsigned(static_cast<unsigned int>(value), base)) { }
+String::String(unsigned int value, unsigned char base) : s(format_unsigned(value, base)) { }
+String::String(long value, unsigned char base)
+    : s(base == 10 ? format_signed(value, base) : format_unsigned(static_cast<unsigned long>(value), base)) { }
+String::String(unsigned long value, unsigned char base) : s(format_unsigned(value, base)) { }
+String::String(long long value, unsigned char base) : s(format_signed(value, base)) { }
+String::String(unsigned long long value, unsigned char base) : s(format_unsigned(value, base)) { }
+String::String(float value, unsigned char decimals) : String(static_cast<double>(value), decimals) { }
+String::String(double value, unsigned char decimals) {
+    if (isnan(value)) { s = "nan"; return; }
+    if (isinf(value)) { s = "inf"; return; }
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(decimals), value);
+    s = buffer;
+}
+
+StringSumHelper &operator +(const StringSumHelper &lhs, const String &rhs) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(rhs); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, const char *cstr) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(cstr); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, char c) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(c); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, int num) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(num); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, unsigned int num) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(num); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, long num) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(num); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, unsigned long num) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(num); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, float num) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(num); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, double num) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(num); return a;
+}
+StringSumHelper &operator +(const StringSumHelper &lhs, const __FlashStringHelper *rhs) {
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(rhs); return a;
+}
+
+bool String::endsWith(const String &suffix) const {
+    return s.length() >= suffix.s.length() &&
+        s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t index = s.find(c, from);
+    return index == std::string::npos ? -1 : static_cast<int>(index);
+}
+
+int String::indexOf(const String &str, unsigned int from) const {
+    size_t index = s.find(str.s, from);
+    return index == std::string::npos ? -1 : static_cast<int>(index);
+}
+
+int String::lastIndexOf(char c) const {
+    size_t index = s.rfind(c);
+    return index == std::string::npos ? -1 : static_cast<int>(index);
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= s.length()) return String();
+    if (to > s.length()) to = s.length();
+    return String(s.substr(from, to - from).c_str());
+}
+
+void String::replace(const String &find, const String &replace) {
+    if (find.s.empty()) return;
+    size_t index = 0;
+    while ((index = s.find(find.s, index)) != std::string::npos) {
+        s.replace(index, find.s.length(), replace.s);
+        index += replace.s.length();
+    }
+}
+
+void String::toLowerCase(void) {
+    for (char &c : s) c = static_cast<char>(tolower(c));
+}
+
+void String::toUpperCase(void) {
+    for (char &c : s) c = static_cast<char>(toupper(c));
+}
+
+void String::trim(void) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    size_t end = s.find_last_not_of(" \t\r\n");
+    s = begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Print, Stream
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++)) n++;
+        else break;
+    }
+    return n;
+}
+
+size_t Print::printf(const char *format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    return write(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+}
+
+int Stream::timedRead(void) {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        *buffer++ = static_cast<char>(c);
+        count++;
+    }
+    return count;
+}
+
+String Stream::readString(void) {
+    String string;
+    int c;
+    while ((c = timedRead()) >= 0) string += static_cast<char>(c);
+    return string;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String string;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) string += static_cast<char>(c);
+    return string;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Serial
+// The UART is modelled with a transmit FIFO of 128 bytes draining at the configured baud rate.
+// Writing to a full FIFO blocks, so printing costs the same virtual time as on the device.
+
+HardwareSerial Serial;
+
+static const int UART_FIFO_SIZE = 128;
+
+static uint64_t uart_drained_us = 0;
+
+static uint64_t uart_byte_us(unsigned long baud) {
+    return baud > 0 ? (10ULL * 1000000ULL + baud - 1) / baud : 0;
+}
+
+int HardwareSerial::availableForWrite(void) {
+    uint64_t byte_us = uart_byte_us(baud);
+    uint64_t now = native::now();
+    if (byte_us == 0 || uart_drained_us <= now) return UART_FIFO_SIZE;
+    int pending = static_cast<int>((uart_drained_us - now + byte_us - 1) / byte_us);
+    return std::max(0, UART_FIFO_SIZE - pending);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    uint64_t byte_us = uart_byte_us(baud);
+    if (byte_us > 0) {
+        while (availableForWrite() == 0) {
+            native::advance(byte_us);
+        }
+        uart_drained_us = std::max(uart_drained_us, native::now()) + byte_us;
+    }
+    if (native::model.serial_echo) {
+        fputc(c, stdout);
+    }
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+}
+
+void HardwareSerial::flush(void) {
+    if (uart_drained_us > native::now()) {
+        native::advance(uart_drained_us - native::now());
+    }
+    if (native::model.serial_echo) {
+        fflush(stdout);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IPAddress
+
+bool IPAddress::fromString(const char *string) {
+    unsigned int a, b, c, d;
+    if (sscanf(string, "%u.%u.%u.%u", &a, &b, &c, &d) != 4) return false;
+    if (a > 255 || b > 255 || c > 255 || d > 255) return false;
+    *this = IPAddress(a, b, c, d);
+    return true;
+}
+
+String IPAddress::toString(void) const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u",
+        address.bytes[0], address.bytes[1], address.bytes[2], address.bytes[3]);
+    return String(buffer);
+}
@@ -0,0 +1,181 @@
+#include <Arduino.h>
+#include <FS.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Hardware.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The flat SPIFFS namespace is mapped to files of one host directory, slashes in names are
+// encoded. Flash writes cost virtual time.
+
+FS SPIFFS;
+
+static const uint64_t FLASH_OPEN_US = 800;
+static const uint64_t FLASH_WRITE_BYTE_US = 12;
+static const size_t FLASH_TOTAL_BYTES = 1024 * 1024;
+
+const char *native_fs_root(void) {
+    const char *root = native::model.fs_root;
+    return root ? root : ".native_fs";
+}
+
+static std::string host_path(const char *path) {
+    std::string name;
+    for (const char *p = path; *p; p++) {
+        if (*p == '/') name += "%2F";
+        else name += *p;
+    }
+    return std::string(native_fs_root()) + "/" + name;
+}
+
+static std::string decode(const std::string &name) {
+    std::string path;
+    for (size_t i = 0; i < name.size(); i++) {
+        if (name.compare(i, 3, "%2F") == 0) { path += '/'; i += 2; }
+        else path += name[i];
+    }
+    return path;
+}
+
+bool FS::begin(void) {
+    mkdir(native_fs_root(), 0755);
+    return true;
+}
+
+bool FS::format(void) {
+    Dir dir = openDir("");
+    while (dir.next()) remove(dir.fileName());
+    return true;
+}
+
+bool FS::info(FSInfo &info) {
+    memset(&info, 0, sizeof(info));
+    info.totalBytes = FLASH_TOTAL_BYTES;
+    Dir dir = openDir("");
+    while (dir.next()) info.usedBytes += dir.fileSize();
+    info.blockSize = 8192;
+    info.pageSize = 256;
+    info.maxOpenFiles = 5;
+    info.maxPathLength = 32;
+    return true;
+}
+
+File FS::open(const char *path, const char *mode) {
+    native::advance(FLASH_OPEN_US);
+    std::string m = mode;
+    std::string host_mode = m.substr(0, 1) + (m.find('+') != std::string::npos ? "+b" : "b");
+    FILE *file = fopen(host_path(path).c_str(), host_mode.c_str());
+    return file ? File(file, String(path)) : File();
+}
+
+bool FS::exists(const char *path) {
+    return access(host_path(path).c_str(), F_OK) == 0;
+}
+
+bool FS::remove(const char *path) {
+    native::advance(FLASH_OPEN_US);
+    return ::unlink(host_path(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to) {
+    native::advance(FLASH_OPEN_US);
+    return ::rename(host_path(from).c_str(), host_path(to).c_str()) == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Dir::next(void) {
+    DIR *dir = opendir(native_fs_root());
+    if (!dir) return false;
+    int i = -1;
+    bool found = false;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        std::string name = decode(entry->d_name);
+        if (name.compare(0, path.length(), path.c_str()) != 0) continue;
+        if (++i > index) {
+            index = i;
+            current = String(name.c_str());
+            found = true;
+            break;
+        }
+    }
+    closedir(dir);
+    return found;
+}
+
+String Dir::fileName(void) const {
+    return current;
+}
+
+size_t Dir::fileSize(void) const {
+    struct stat st;
+    if (stat(host_path(current.c_str()).c_str(), &st) != 0) return 0;
+    return static_cast<size_t>(st.st_size);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+    if (!file) return 0;
+    native::advance(FLASH_WRITE_BYTE_US * size);
+    return fwrite(buffer, 1, size, file.get());
+}
+
+int File::available(void) {
+    if (!file) return 0;
+    long position = ftell(file.get());
+    return static_cast<int>(size() - static_cast<size_t>(position));
+}
+
+int File::read(void) {
+    if (!file) return -1;
+    int c = fgetc(file.get());
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t *buffer, size_t size) {
+    if (!file) return 0;
+    return fread(buffer, 1, size, file.get());
+}
+
+int File::peek(void) {
+    if (!file) return -1;
+    int c = fgetc(file.get());
+    if (c != EOF) ungetc(c, file.get());
+    return c == EOF ? -1 : c;
+}
+
+void File::flush(void) {
+    if (file) fflush(file.get());
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!file) return false;
+    int whence = mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END);
+    return fseek(file.get(), static_cast<long>(pos), whence) == 0;
+}
+
+size_t File::position(void) const {
+    return file ? static_cast<size_t>(ftell(file.get())) : 0;
+}
+
+size_t File::size(void) const {
+    if (!file) return 0;
+    fflush(file.get());
+    struct stat st;
+    if (fstat(fileno(file.get()), &st) != 0) return 0;
+    return static_cast<size_t>(st.st_size);
+}
+
+void File::close(void) {
+    file.reset();
+}
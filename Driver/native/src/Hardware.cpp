@@ -0,0 +1,218 @@
+#include <Arduino.h>
+
+#include "Hardware.h"
+
+#include <user_interface.h>
+
+namespace native {
+
+static hardware_t local_hardware;
+
+hardware_t *hardware = &local_hardware;
+
+model_t model = {
+    .chip_id = 0x00C0FFEE,
+    .epoch = 1609459200, // 2021-01-01T00:00:00Z
+    .vcc_millivolts = 3300,
+    .temperature = 21.5f,
+    .pressure = 101325.0f,
+    .humidity = 45.0f,
+    .illuminance = 250.0f,
+    .wifi_associate_ms = 2500,
+    .wifi_associate_fast_ms = 250,
+    .wifi_dhcp_ms = 700,
+    .wifi_failure_rate = 0.0f,
+    .ntp_ms = 60,
+    .tcp_connect_ms = 15,
+    .http_response_ms = 40,
+    .tcp_bytes_per_ms = 100,
+    .sleep_drift = 0.0,
+    .led_pin = LED_BUILTIN,
+    .serial_echo = true,
+    .server_host = "127.0.0.1",
+    .server_port = 0,
+    .responder = NULL,
+    .fs_root = NULL,
+    .halt_after_ms = 10 * 60 * 1000,
+    .has_bme280 = true,
+    .has_bmp280 = false,
+    .has_sht30 = false,
+    .has_ads1115 = false,
+    .ds18b20_count = 1,
+    .ds18b20_parasite = false,
+    .extender_pin = D7,
+    .extender_settle_ms = 15,
+    .conversion_scale = 1.0
+};
+
+static bool active[PHASE_MAX + 1];
+
+static uint64_t converting_until_us = 0;
+
+void power_on(hardware_t *memory) {
+    hardware = memory ? memory : &local_hardware;
+    memset(hardware, 0, sizeof(hardware_t));
+    for (size_t i = 0; i < sizeof(hardware->rtc_memory) / sizeof(uint32_t); i++) {
+        // RTC memory holds garbage after power on
+        hardware->rtc_memory[i] = static_cast<uint32_t>(rand()) ^ (static_cast<uint32_t>(rand()) << 16);
+    }
+    hardware->reset_reason = reset_power_on;
+    memset(active, 0, sizeof(active));
+    active[phase_cpu] = true;
+    converting_until_us = 0;
+}
+
+static void reset(reset_reason reason) {
+    hardware->boot_us = hardware->time_us;
+    hardware->wakes++;
+    hardware->reset_reason = reason;
+    memset(active, 0, sizeof(active));
+    active[phase_cpu] = true;
+    converting_until_us = 0;
+}
+
+void wake(void) {
+    uint64_t us = hardware->sleep_us;
+    us = static_cast<uint64_t>(static_cast<double>(us) * (1.0 + model.sleep_drift));
+    hardware->phase_us[phase_sleep] += us;
+    hardware->time_us += us;
+    reset(reset_deep_sleep_awake);
+}
+
+void reboot(void) {
+    reset(reset_soft_restart);
+}
+
+uint64_t now(void) {
+    return hardware->time_us;
+}
+
+uint64_t uptime(void) {
+    return hardware->time_us - hardware->boot_us;
+}
+
+uint32_t wallclock(void) {
+    return model.epoch + static_cast<uint32_t>(hardware->time_us / 1000000ULL);
+}
+
+void advance(uint64_t us) {
+    if (converting_until_us > hardware->time_us) {
+        hardware->phase_us[phase_sensor] += std::min(us, converting_until_us - hardware->time_us);
+    }
+    hardware->time_us += us;
+    for (int phase = 0; phase <= PHASE_MAX; phase++) {
+        if (active[phase]) {
+            hardware->phase_us[phase] += us;
+        }
+    }
+    if (model.halt_after_ms > 0 && uptime() > static_cast<uint64_t>(model.halt_after_ms) * 1000) {
+        throw halt();
+    }
+}
+
+void activate(phase phase, bool on) {
+    active[phase] = on;
+}
+
+uint64_t convert(uint64_t us) {
+    us = static_cast<uint64_t>(static_cast<double>(us) * model.conversion_scale);
+    converting_until_us = std::max(converting_until_us, hardware->time_us + us);
+    return us;
+}
+
+static uint64_t outputs_changed_us[32];
+
+uint64_t output_changed_at(uint8_t pin) {
+    return pin < 32 ? outputs_changed_us[pin] : 0;
+}
+
+void output_changed(uint8_t pin, uint8_t value) {
+    if (pin < 32) {
+        outputs_changed_us[pin] = hardware->time_us;
+    }
+    if (pin == model.led_pin) {
+        activate(phase_led, value == LOW);
+    }
+}
+
+int input(uint8_t pin, uint8_t value) {
+    (void) pin;
+    return value;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ESP
+
+EspClass ESP;
+
+uint32_t EspClass::getChipId(void) {
+    return native::model.chip_id;
+}
+
+uint16_t EspClass::getVcc(void) {
+    return native::model.vcc_millivolts;
+}
+
+uint32_t EspClass::getFreeHeap(void) {
+    return 40 * 1024;
+}
+
+uint32_t EspClass::getCycleCount(void) {
+    return static_cast<uint32_t>(native::now() * 80);
+}
+
+uint64_t EspClass::deepSleepMax(void) {
+    return 71ULL * 60 * 1000000;
+}
+
+void EspClass::deepSleep(uint64_t time_us, RFMode mode) {
+    if (time_us > deepSleepMax()) {
+        time_us = deepSleepMax();
+    }
+    native::hardware->sleep_us = time_us;
+    native::hardware->sleep_rf_mode = mode;
+    throw native::deep_sleep { time_us, static_cast<uint32_t>(mode) };
+}
+
+void EspClass::restart(void) {
+    throw native::restart();
+}
+
+void EspClass::reset(void) {
+    throw native::restart();
+}
+
+void EspClass::wdtDisable(void) {
+    // the hardware watchdog resets the chip some seconds after the software watchdog stopped
+    native::advance(6 * 1000000ULL);
+    throw native::restart();
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size) {
+    if (offset * 4 + size > sizeof(native::hardware->rtc_memory) || size % 4 != 0) {
+        return false;
+    }
+    memcpy(data, &native::hardware->rtc_memory[offset], size);
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size) {
+    if (offset * 4 + size > sizeof(native::hardware->rtc_memory) || size % 4 != 0) {
+        return false;
+    }
+    memcpy(&native::hardware->rtc_memory[offset], data, size);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SDK
+
+static struct rst_info reset_info;
+
+struct rst_info *system_get_rst_info(void) {
+    memset(&reset_info, 0, sizeof(reset_info));
+    reset_info.reason = native::hardware->reset_reason;
+    return &reset_info;
+}
@@ -0,0 +1,231 @@
+#include <Arduino.h>
+#include <ArduinoHttpClient.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+HttpClient::HttpClient(Client &client, const char *serverName, uint16_t port)
+    : client(client), serverName(serverName), serverPort(port) {
+}
+
+HttpClient::HttpClient(Client &client, const String &serverName, uint16_t port)
+    : client(client), serverName(serverName), serverPort(port) {
+}
+
+void HttpClient::beginRequest(void) {
+    inRequest = true;
+}
+
+int HttpClient::startRequest(const char *path, const char *method) {
+    headersDone = false;
+    statusCode = 0;
+    length = kNoContentLengthHeader;
+    bodyRead = 0;
+    if (!client.connected()) {
+        if (!client.connect(serverName.c_str(), serverPort)) {
+            return HTTP_ERROR_CONNECTION_FAILED;
+        }
+    }
+    client.print(method);
+    client.print(" ");
+    client.print(path);
+    client.print(" HTTP/1.1\r\n");
+    if (defaultHeaders) {
+        sendHeader("Host", serverName.c_str());
+        sendHeader("User-Agent", "Arduino/2.2.0");
+    }
+    if (keepAlive) {
+        sendHeader("Connection", "keep-alive");
+    }
+    else {
+        sendHeader("Connection", "close");
+    }
+    if (!inRequest) {
+        client.print("\r\n");
+    }
+    return HTTP_SUCCESS;
+}
+
+int HttpClient::get(const char *path) {
+    return startRequest(path, "GET");
+}
+
+int HttpClient::post(const char *path) {
+    return startRequest(path, "POST");
+}
+
+void HttpClient::sendHeader(const char *header) {
+    client.print(header);
+    client.print("\r\n");
+}
+
+void HttpClient::sendHeader(const char *name, const char *value) {
+    client.print(name);
+    client.print(": ");
+    client.print(value);
+    client.print("\r\n");
+}
+
+void HttpClient::sendHeader(const char *name, int value) {
+    client.print(name);
+    client.print(": ");
+    client.print(value);
+    client.print("\r\n");
+}
+
+void HttpClient::beginBody(void) {
+    if (inRequest) {
+        client.print("\r\n");
+        inRequest = false;
+    }
+}
+
+void HttpClient::endRequest(void) {
+    beginBody();
+}
+
+String HttpClient::readLine(void) {
+    String line;
+    unsigned long start = millis();
+    while (millis() - start < responseTimeout) {
+        if (client.available()) {
+            int c = client.read();
+            if (c == '\n') return line;
+            if (c != '\r') line += static_cast<char>(c);
+            start = millis();
+        }
+        else if (!client.connected()) {
+            break;
+        }
+    }
+    return line;
+}
+
+int HttpClient::responseStatusCode(void) {
+    String line;
+    do {
+        line = readLine();
+        if (line.length() == 0) return HTTP_ERROR_TIMED_OUT;
+        if (!line.startsWith("HTTP/")) return HTTP_ERROR_INVALID_RESPONSE;
+        int space = line.indexOf(' ');
+        statusCode = space >= 0 ? static_cast<int>(line.substring(space + 1).toInt()) : 0;
+        if (statusCode == 100) {
+            // skip the headers of an informational response
+            while (readLine().length() > 0) { }
+        }
+    } while (statusCode == 100);
+    return statusCode;
+}
+
+bool HttpClient::headerAvailable(void) {
+    if (headersDone) return false;
+    String line = readLine();
+    if (line.length() == 0) {
+        headersDone = true;
+        return false;
+    }
+    int colon = line.indexOf(':');
+    currentHeaderName = colon >= 0 ? line.substring(0, colon) : line;
+    currentHeaderValue = colon >= 0 ? line.substring(colon + 1) : String();
+    currentHeaderValue.trim();
+    String lower = currentHeaderName;
+    lower.toLowerCase();
+    if (lower == "content-length") {
+        length = static_cast<int>(currentHeaderValue.toInt());
+    }
+    return true;
+}
+
+int HttpClient::readHeader(void) {
+    if (headersDone) return -1;
+    unsigned long start = millis();
+    while (millis() - start < responseTimeout) {
+        if (client.available()) {
+            int c = client.read();
+            if (c == '\n') {
+                if (headerLineEmpty) headersDone = true;
+                headerLineEmpty = true;
+            }
+            else if (c != '\r') {
+                headerLineEmpty = false;
+            }
+            return c;
+        }
+        else if (!client.connected()) {
+            break;
+        }
+    }
+    return -1;
+}
+
+String HttpClient::readHeaderName(void) {
+    return currentHeaderName;
+}
+
+String HttpClient::readHeaderValue(void) {
+    return currentHeaderValue;
+}
+
+int HttpClient::skipResponseHeaders(void) {
+    while (headerAvailable()) { }
+    return HTTP_SUCCESS;
+}
+
+String HttpClient::responseBody(void) {
+    skipResponseHeaders();
+    String body;
+    while (length < 0 || bodyRead < length) {
+        int c = read();
+        if (c < 0) break;
+        body += static_cast<char>(c);
+    }
+    return body;
+}
+
+size_t HttpClient::write(uint8_t c) {
+    return client.write(c);
+}
+
+size_t HttpClient::write(const uint8_t *buffer, size_t size) {
+    return client.write(buffer, size);
+}
+
+int HttpClient::available(void) {
+    int available = client.available();
+    if (length >= 0 && available > length - bodyRead) available = length - bodyRead;
+    return available;
+}
+
+int HttpClient::read(void) {
+    if (length >= 0 && bodyRead >= length) return -1;
+    unsigned long start = millis();
+    while (millis() - start < responseTimeout) {
+        if (client.available()) {
+            bodyRead++;
+            return client.read();
+        }
+        if (!client.connected()) break;
+    }
+    return -1;
+}
+
+int HttpClient::read(uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (n < size) {
+        int c = read();
+        if (c < 0) break;
+        buffer[n++] = static_cast<uint8_t>(c);
+    }
+    return static_cast<int>(n);
+}
+
+int HttpClient::peek(void) {
+    return client.peek();
+}
+
+void HttpClient::flush(void) {
+    client.flush();
+}
+
+void HttpClient::stop(void) {
+    client.stop();
+}
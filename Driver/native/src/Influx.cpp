@@ -0,0 +1,591 @@
+#include "Influx.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+
+namespace native {
+namespace influx {
+
+namespace {
+
+// Limit of timestamps in nanoseconds.
+const int64_t time_min = INT64_MIN + 2;
+const int64_t time_max = INT64_MAX - 1;
+
+std::string lowercase(const std::string &string) {
+    std::string lower(string);
+    for (char &c : lower) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return lower;
+}
+
+std::string trimmed(const std::string &string) {
+    size_t start = string.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return std::string();
+    }
+    return string.substr(start, string.find_last_not_of(" \t") - start + 1);
+}
+
+// Returns the value of the given header (lower case) of the given request head.
+std::string header(const std::string &head, const char *name) {
+    std::string lower = lowercase(head);
+    std::string key = std::string("\r\n") + name + ":";
+    size_t index = lower.find(key);
+    if (index == std::string::npos) {
+        return std::string();
+    }
+    index += key.size();
+    return trimmed(head.substr(index, head.find("\r\n", index) - index));
+}
+
+// Returns the size of the chunked body at the start of the given data, 0 if not complete yet or
+// -1 if malformed. Gives the data of the chunks if not NULL.
+long chunked_size(const std::string &body, std::string *data) {
+    size_t index = 0;
+    for (;;) {
+        size_t end = body.find("\r\n", index);
+        if (end == std::string::npos) {
+            return 0;
+        }
+        char *digits_end;
+        const char *digits = body.c_str() + index;
+        unsigned long size = strtoul(digits, &digits_end, 16);
+        if (digits_end == digits) {
+            return -1;
+        }
+        index = end + 2;
+        if (size == 0) {
+            // no trailers are sent by the stations
+            if (body.size() < index + 2) {
+                return 0;
+            }
+            return body.compare(index, 2, "\r\n") == 0 ? static_cast<long>(index + 2) : -1;
+        }
+        if (body.size() < index + size + 2) {
+            return 0;
+        }
+        if (body.compare(index + size, 2, "\r\n") != 0) {
+            return -1;
+        }
+        if (data != NULL) {
+            data->append(body, index, size);
+        }
+        index += size + 2;
+    }
+}
+
+bool gunzip(const std::string &data, std::string &text) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    char buffer[4096];
+    int result;
+    do {
+        stream.next_out = reinterpret_cast<Bytef *>(buffer);
+        stream.avail_out = sizeof(buffer);
+        result = inflate(&stream, Z_NO_FLUSH);
+        text.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (result == Z_OK);
+    inflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+
+// Decodes the given query string component.
+std::string url_decoded(const std::string &string) {
+    std::string decoded;
+    for (size_t i = 0; i < string.size(); i++) {
+        if (string[i] == '+') {
+            decoded += ' ';
+        }
+        else if (string[i] == '%' && i + 2 < string.size() &&
+            isxdigit(static_cast<unsigned char>(string[i + 1])) &&
+            isxdigit(static_cast<unsigned char>(string[i + 2]))) {
+            decoded += static_cast<char>(strtoul(string.substr(i + 1, 2).c_str(), NULL, 16));
+            i += 2;
+        }
+        else {
+            decoded += string[i];
+        }
+    }
+    return decoded;
+}
+
+// Returns the value of the given parameter of the given query string.
+std::string parameter(const std::string &query, const char *name) {
+    size_t index = 0;
+    while (index <= query.size()) {
+        size_t end = query.find('&', index);
+        if (end == std::string::npos) end = query.size();
+        std::string pair = query.substr(index, end - index);
+        size_t equals = pair.find('=');
+        if (url_decoded(pair.substr(0, equals)) == name) {
+            return equals == std::string::npos ? std::string() : url_decoded(pair.substr(equals + 1));
+        }
+        index = end + 1;
+    }
+    return std::string();
+}
+
+// Returns the nanoseconds of one unit of the given precision.
+int64_t multiplier(const std::string &precision) {
+    if (precision == "u" || precision == "us") return 1000LL;
+    if (precision == "ms") return 1000000LL;
+    if (precision == "s") return 1000000000LL;
+    if (precision == "m") return 60LL * 1000000000LL;
+    if (precision == "h") return 3600LL * 1000000000LL;
+    return 1;
+}
+
+// Scans the given line from the given position up to the first of the given separators, which
+// is not escaped by a backslash (or quoted if quotes is true). Returns the position of the
+// separator or the end of the line.
+size_t scan(const std::string &line, size_t index, const char *separators, bool quotes = false) {
+    bool quoted = false;
+    for (; index < line.size(); index++) {
+        char c = line[index];
+        if (c == '\\') {
+            index++;
+        }
+        else if (quotes && c == '"') {
+            quoted = !quoted;
+        }
+        else if (!quoted && strchr(separators, c) != NULL) {
+            break;
+        }
+    }
+    return std::min(index, line.size());
+}
+
+// Returns the given string with the escaping backslashes of the given specials removed.
+std::string unescaped(const std::string &string, const char *specials) {
+    std::string result;
+    for (size_t i = 0; i < string.size(); i++) {
+        if (string[i] == '\\' && i + 1 < string.size() && strchr(specials, string[i + 1]) != NULL) {
+            i++;
+        }
+        result += string[i];
+    }
+    return result;
+}
+
+bool valid_number(const std::string &value, bool integer) {
+    const char *start = value.c_str();
+    char *end;
+    errno = 0;
+    if (integer) {
+        strtoll(start, &end, 10);
+    }
+    else {
+        double number = strtod(start, &end);
+        if (!isfinite(number)) {
+            return false;
+        }
+    }
+    // strtod also accepts hexadecimal numbers and leading spaces, InfluxDB does not
+    for (const char *c = start; c < end; c++) {
+        if (!isdigit(static_cast<unsigned char>(*c)) && strchr("+-.eE", *c) == NULL) {
+            return false;
+        }
+    }
+    return end != start && *end == '\0' && errno == 0;
+}
+
+// Parses the given value of a field. Returns an error or NULL if valid.
+const char *parse_value(const std::string &value, field_t &field) {
+    if (value.empty()) {
+        return "missing field value";
+    }
+    char first = value[0];
+    if (first == '"') {
+        if (value.size() < 2 || value.back() != '"' || value[value.size() - 2] == '\\') {
+            return "unbalanced quotes";
+        }
+        field.type = type_string;
+        field.value = unescaped(value.substr(1, value.size() - 2), "\"\\");
+        return NULL;
+    }
+    if (isdigit(static_cast<unsigned char>(first)) || first == '-' || first == '+' || first == '.') {
+        char suffix = value.back();
+        if (suffix == 'i' || suffix == 'u') {
+            std::string digits = value.substr(0, value.size() - 1);
+            if (!valid_number(digits, true) || digits.find_first_of(".eE+") != std::string::npos ||
+                (suffix == 'u' && digits[0] == '-')) {
+                return "invalid number";
+            }
+            field.type = suffix == 'i' ? type_integer : type_unsigned;
+            field.value = digits;
+            return NULL;
+        }
+        if (!valid_number(value, false)) {
+            return "invalid number";
+        }
+        field.type = type_float;
+        field.value = value;
+        return NULL;
+    }
+    static const char *booleans[] = {
+        "t", "T", "true", "True", "TRUE", "f", "F", "false", "False", "FALSE"
+    };
+    for (const char *boolean : booleans) {
+        if (value == boolean) {
+            field.type = type_boolean;
+            field.value = value;
+            return NULL;
+        }
+    }
+    return "invalid boolean";
+}
+
+// Parses the given line into the given point. Returns an error or NULL if valid.
+const char *parse_line(const std::string &line, int64_t unit, point_t &point) {
+    // measurement and tags
+    size_t key_end = scan(line, 0, " ");
+    size_t index = scan(line, 0, ", ");
+    if (index == 0) {
+        return "missing measurement";
+    }
+    point.measurement = unescaped(line.substr(0, index), ", ");
+    while (index < key_end) {
+        size_t start = index + 1;
+        size_t end = scan(line, start, ", ");
+        std::string tag = line.substr(start, end - start);
+        size_t equals = scan(tag, 0, "=");
+        if (equals == 0) {
+            return "missing tag key";
+        }
+        if (equals >= tag.size() - 1) {
+            return "missing tag value";
+        }
+        if (scan(tag, equals + 1, "=") != tag.size()) {
+            return "invalid tag format";
+        }
+        point.tags.push_back(std::make_pair(
+            unescaped(tag.substr(0, equals), ",= "), unescaped(tag.substr(equals + 1), ",= ")
+        ));
+        index = end;
+    }
+    std::sort(point.tags.begin(), point.tags.end());
+    for (size_t i = 1; i < point.tags.size(); i++) {
+        if (point.tags[i].first == point.tags[i - 1].first) {
+            return "duplicate tags";
+        }
+    }
+    if (key_end >= line.size()) {
+        return "missing fields";
+    }
+
+    // fields
+    size_t fields_end = scan(line, key_end + 1, " ", true);
+    index = key_end + 1;
+    if (index >= fields_end) {
+        return "missing fields";
+    }
+    while (index < fields_end) {
+        size_t end = scan(line, index, ",", true);
+        if (end > fields_end) {
+            end = fields_end;
+        }
+        std::string pair = line.substr(index, end - index);
+        size_t equals = scan(pair, 0, "=");
+        if (equals == 0) {
+            return "missing field key";
+        }
+        if (equals >= pair.size()) {
+            return "missing field value";
+        }
+        field_t field;
+        field.key = unescaped(pair.substr(0, equals), ",= ");
+        const char *error = parse_value(pair.substr(equals + 1), field);
+        if (error != NULL) {
+            return error;
+        }
+        point.fields.push_back(field);
+        index = end + 1;
+    }
+
+    // timestamp
+    point.timestamped = false;
+    point.timestamp = 0;
+    std::string time = trimmed(line.substr(std::min(fields_end, line.size())));
+    if (!time.empty()) {
+        if (!valid_number(time, true) || time.find_first_of(".eE+") != std::string::npos) {
+            return "bad timestamp";
+        }
+        long long value = strtoll(time.c_str(), NULL, 10);
+        if (value > time_max / unit || value < time_min / unit) {
+            return "time outside range -9223372036854775806 - 9223372036854775806";
+        }
+        point.timestamped = true;
+        point.timestamp = value * unit;
+    }
+    return NULL;
+}
+
+const char *reason(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Unknown";
+    }
+}
+
+// Returns the given string as JSON string.
+std::string json_quoted(const std::string &string) {
+    std::string quoted("\"");
+    for (char c : string) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if (c == '\n') {
+            quoted += "\\n";
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            quoted += escape;
+        }
+        else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+long request_size(const std::string &data) {
+    size_t separator = data.find("\r\n\r\n");
+    if (separator == std::string::npos) {
+        // a head of this size is not sent by any station
+        return data.size() > 8192 ? -1 : 0;
+    }
+    std::string head = data.substr(0, separator);
+    size_t start = separator + 4;
+    if (lowercase(header(head, "transfer-encoding")) == "chunked") {
+        long size = chunked_size(data.substr(start), NULL);
+        return size > 0 ? static_cast<long>(start) + size : size;
+    }
+    std::string length = header(head, "content-length");
+    char *end;
+    unsigned long size = strtoul(length.c_str(), &end, 10);
+    if (!length.empty() && *end != '\0') {
+        return -1;
+    }
+    return data.size() >= start + size ? static_cast<long>(start + size) : 0;
+}
+
+write_t handle(const std::string &request, const std::string &database) {
+    write_t result;
+    result.status = 204;
+    result.body_size = 0;
+    result.text_size = 0;
+    result.lines = 0;
+
+    size_t separator = request.find("\r\n\r\n");
+    size_t line_end = request.find("\r\n");
+    std::string request_line = request.substr(0, line_end);
+    size_t path_start = request_line.find(' ');
+    size_t path_end = request_line.find(' ', path_start + 1);
+    if (separator == std::string::npos || path_start == std::string::npos ||
+        path_end == std::string::npos) {
+        result.status = 400;
+        result.error = "malformed request";
+        return result;
+    }
+    std::string method = request_line.substr(0, path_start);
+    std::string target = request_line.substr(path_start + 1, path_end - path_start - 1);
+    size_t query_start = target.find('?');
+    std::string path = target.substr(0, query_start);
+    std::string query = query_start == std::string::npos ? std::string() : target.substr(query_start + 1);
+    std::string head = request.substr(0, separator);
+    result.user_agent = header(head, "user-agent");
+
+    if (path == "/ping") {
+        return result;
+    }
+    if (path != "/write") {
+        result.status = 404;
+        result.error = "404 page not found";
+        return result;
+    }
+    if (method != "POST") {
+        result.status = 405;
+        result.error = "405 method not allowed";
+        return result;
+    }
+    result.database = parameter(query, "db");
+    if (result.database.empty()) {
+        result.status = 400;
+        result.error = "database is required";
+        return result;
+    }
+    if (!database.empty() && result.database != database) {
+        result.status = 404;
+        result.error = "database not found: \"" + result.database + "\"";
+        return result;
+    }
+
+    std::string body = request.substr(separator + 4);
+    std::string data;
+    if (lowercase(header(head, "transfer-encoding")) == "chunked") {
+        if (chunked_size(body, &data) <= 0) {
+            result.status = 400;
+            result.error = "unexpected EOF";
+            return result;
+        }
+    }
+    else {
+        data = body.substr(0, strtoul(header(head, "content-length").c_str(), NULL, 10));
+    }
+    result.body_size = data.size();
+    std::string text;
+    if (lowercase(header(head, "content-encoding")) == "gzip") {
+        if (!gunzip(data, text)) {
+            result.status = 400;
+            result.error = "gzip: invalid header";
+            return result;
+        }
+    }
+    else {
+        text = data;
+    }
+    result.text_size = text.size();
+
+    std::string precision = parameter(query, "precision");
+    result.error = parse(text, precision.empty() ? "n" : precision, result.points, result.lines);
+    if (!result.error.empty()) {
+        result.status = 400;
+    }
+    return result;
+}
+
+std::string parse(const std::string &text, const std::string &precision,
+    std::vector<point_t> &points, unsigned int &lines)
+{
+    std::string errors;
+    int64_t unit = multiplier(precision);
+    size_t index = 0;
+    lines = 0;
+    while (index < text.size()) {
+        size_t end = text.find('\n', index);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(index, end - index);
+        index = end + 1;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        line = line.substr(start);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        lines++;
+        point_t point;
+        const char *error = parse_line(line, unit, point);
+        if (error != NULL) {
+            if (!errors.empty()) {
+                errors += "\n";
+            }
+            errors += "unable to parse '" + line + "': " + error;
+            continue;
+        }
+        points.push_back(point);
+    }
+    return errors;
+}
+
+std::string response(const write_t &result, time_t date) {
+    char date_text[40];
+    strftime(date_text, sizeof(date_text), "%a, %d %b %Y %H:%M:%S GMT", gmtime(&date));
+    std::string body;
+    if (!result.error.empty()) {
+        body = "{\"error\":" + json_quoted(result.error) + "}\n";
+    }
+    char status[64];
+    snprintf(status, sizeof(status), "HTTP/1.1 %d %s\r\n", result.status, reason(result.status));
+    std::string response(status);
+    response += "Content-Type: application/json\r\n";
+    response += "Date: ";
+    response += date_text;
+    response += "\r\n";
+    response += "X-Influxdb-Build: OSS\r\n";
+    response += "X-Influxdb-Version: 1.8.10\r\n";
+    if (!result.error.empty()) {
+        response += "X-Influxdb-Error: " + result.error.substr(0, result.error.find('\n')) + "\r\n";
+    }
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+    return response + body;
+}
+
+const char *type_name(field_type type) {
+    switch (type) {
+    case type_float: return "float";
+    case type_integer: return "integer";
+    case type_unsigned: return "unsigned";
+    case type_string: return "string";
+    case type_boolean: return "boolean";
+    }
+    return "unknown";
+}
+
+void Schema::admit(write_t &result) {
+    std::string conflict;
+    size_t dropped = 0;
+    std::vector<point_t> admitted;
+    for (point_t &point : result.points) {
+        std::map<std::string, field_type> &fields = types[point.measurement];
+        bool conflicting = false;
+        for (const field_t &field : point.fields) {
+            auto known = fields.find(field.key);
+            if (known != fields.end() && known->second != field.type) {
+                if (conflict.empty()) {
+                    conflict = "field type conflict: input field \"" + field.key +
+                        "\" on measurement \"" + point.measurement + "\" is type " +
+                        type_name(field.type) + ", already exists as type " +
+                        type_name(known->second);
+                }
+                conflicting = true;
+                break;
+            }
+        }
+        if (conflicting) {
+            dropped++;
+            continue;
+        }
+        for (const field_t &field : point.fields) {
+            fields[field.key] = field.type;
+        }
+        admitted.push_back(point);
+    }
+    if (dropped > 0) {
+        result.points.swap(admitted);
+        result.status = 400;
+        std::string error = "partial write: " + conflict + " dropped=" + std::to_string(dropped);
+        result.error = result.error.empty() ? error : result.error + "\n" + error;
+    }
+}
+
+}
+}
@@ -0,0 +1,22 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <NTPClient.h>
+
+#include "Hardware.h"
+
+bool NTPClient::forceUpdate(void) {
+    if (WiFi.status() != WL_CONNECTED) {
+        // no answer: the original waits one second for a response
+        delay(1000);
+        return false;
+    }
+    native::hardware->ntp_requests++;
+    native::advance(native::model.ntp_ms * 1000ULL);
+    epoch = native::wallclock();
+    lastUpdate = millis();
+    return true;
+}
+
+unsigned long NTPClient::getEpochTime(void) const {
+    return epoch + (millis() - lastUpdate) / 1000;
+}
@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include <RTClib.h>
+
+// Based on RTClib by JeeLabs and Adafruit (public domain).
+
+static const uint8_t daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static uint16_t date2days(uint16_t y, uint8_t m, uint8_t d) {
+    if (y >= 2000U) y -= 2000U;
+    uint16_t days = d;
+    for (uint8_t i = 1; i < m; ++i) days += daysInMonth[i - 1];
+    if (m > 2 && y % 4 == 0) ++days;
+    return days + 365 * y + (y + 3) / 4 - 1;
+}
+
+static uint32_t time2ulong(uint16_t days, uint8_t h, uint8_t m, uint8_t s) {
+    return ((days * 24UL + h) * 60 + m) * 60 + s;
+}
+
+static uint8_t conv2d(const char *p) {
+    uint8_t v = 0;
+    if ('0' <= *p && *p <= '9') v = static_cast<uint8_t>(*p - '0');
+    return static_cast<uint8_t>(10 * v + *++p - '0');
+}
+
+DateTime::DateTime(uint32_t t) {
+    t -= SECONDS_FROM_1970_TO_2000;
+    ss = t % 60; t /= 60;
+    mm = t % 60; t /= 60;
+    hh = t % 24;
+    uint16_t days = static_cast<uint16_t>(t / 24);
+    uint8_t leap;
+    for (yOff = 0;; ++yOff) {
+        leap = yOff % 4 == 0;
+        if (days < 365U + leap) break;
+        days -= 365 + leap;
+    }
+    for (m = 1; m < 12; ++m) {
+        uint8_t daysPerMonth = daysInMonth[m - 1];
+        if (leap && m == 2) ++daysPerMonth;
+        if (days < daysPerMonth) break;
+        days -= daysPerMonth;
+    }
+    d = static_cast<uint8_t>(days + 1);
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec) {
+    if (year >= 2000U) year -= 2000U;
+    yOff = static_cast<uint8_t>(year);
+    m = month; d = day; hh = hour; mm = min; ss = sec;
+}
+
+DateTime::DateTime(const char *date, const char *time) {
+    yOff = conv2d(date + 9);
+    switch (date[0]) {
+    case 'J': m = (date[1] == 'a') ? 1 : ((date[2] == 'n') ? 6 : 7); break;
+    case 'F': m = 2; break;
+    case 'A': m = date[2] == 'r' ? 4 : 8; break;
+    case 'M': m = date[2] == 'r' ? 3 : 5; break;
+    case 'S': m = 9; break;
+    case 'O': m = 10; break;
+    case 'N': m = 11; break;
+    case 'D': m = 12; break;
+    default: m = 1; break;
+    }
+    d = conv2d(date + 4);
+    hh = conv2d(time);
+    mm = conv2d(time + 3);
+    ss = conv2d(time + 6);
+}
+
+uint32_t DateTime::unixtime(void) const {
+    uint16_t days = date2days(yOff, m, d);
+    return time2ulong(days, hh, mm, ss) + SECONDS_FROM_1970_TO_2000;
+}
+
+void RTC_Millis::adjust(const DateTime &dt) {
+    lastMillis = millis();
+    lastUnix = dt.unixtime();
+}
+
+DateTime RTC_Millis::now(void) {
+    uint32_t elapsedSeconds = (millis() - lastMillis) / 1000;
+    lastMillis += elapsedSeconds * 1000;
+    lastUnix += elapsedSeconds;
+    return DateTime(lastUnix);
+}
@@ -0,0 +1,357 @@
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <Adafruit_ADS1015.h>
+#include <Adafruit_BME280.h>
+#include <Adafruit_BMP280.h>
+#include <Adafruit_TSL2561_U.h>
+#include <DallasTemperature.h>
+#include <DHT.h>
+#include <SHTSensor.h>
+
+#include "Hardware.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// register access helpers
+
+static void write_register(TwoWire *wire, uint8_t address, uint8_t reg, uint8_t value) {
+    wire->beginTransmission(address);
+    wire->write(reg);
+    wire->write(value);
+    wire->endTransmission();
+}
+
+static uint8_t read_register(TwoWire *wire, uint8_t address, uint8_t reg) {
+    wire->beginTransmission(address);
+    wire->write(reg);
+    if (wire->endTransmission() != 0) return 0;
+    if (wire->requestFrom(address, static_cast<uint8_t>(1)) != 1) return 0;
+    return static_cast<uint8_t>(wire->read());
+}
+
+static void read_registers(TwoWire *wire, uint8_t address, uint8_t reg, uint8_t *data, uint8_t length) {
+    wire->beginTransmission(address);
+    wire->write(reg);
+    wire->endTransmission();
+    wire->requestFrom(address, length);
+    for (uint8_t i = 0; i < length; i++) data[i] = static_cast<uint8_t>(wire->read());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BME280
+
+Adafruit_BME280::Adafruit_BME280(void) : _wire(&Wire), _i2caddr(BME280_ADDRESS), _sensorID(0), t_fine(0) {
+    memset(&_bme280_calib, 0, sizeof(_bme280_calib));
+    memset(&_configReg, 0, sizeof(_configReg));
+    memset(&_measReg, 0, sizeof(_measReg));
+    memset(&_humReg, 0, sizeof(_humReg));
+}
+
+bool Adafruit_BME280::begin(uint8_t addr, TwoWire *theWire) {
+    _i2caddr = addr;
+    _wire = theWire;
+    return init();
+}
+
+bool Adafruit_BME280::init(void) {
+    _wire->begin();
+    _sensorID = read8(0xD0);
+    if (_sensorID != 0x60) return false;
+    write8(0xE0, 0xB6);
+    delay(10);
+    while (isReadingCalibration()) delay(10);
+    readCoefficients();
+    setSampling();
+    delay(100);
+    return true;
+}
+
+void Adafruit_BME280::setSampling(sensor_mode mode, sensor_sampling tempSampling,
+        sensor_sampling pressSampling, sensor_sampling humSampling, sensor_filter filter,
+        standby_duration duration) {
+    _measReg.mode = mode;
+    _measReg.osrs_t = tempSampling;
+    _measReg.osrs_p = pressSampling;
+    _humReg.osrs_h = humSampling;
+    _configReg.filter = filter;
+    _configReg.t_sb = duration;
+    _configReg.spi3w_en = 0;
+    write8(0xF4, MODE_SLEEP);
+    write8(0xF2, static_cast<byte>(_humReg.get()));
+    write8(0xF5, static_cast<byte>(_configReg.get()));
+    write8(0xF4, static_cast<byte>(_measReg.get()));
+}
+
+void Adafruit_BME280::takeForcedMeasurement(void) {
+    if (_measReg.mode == MODE_FORCED) {
+        write8(0xF4, static_cast<byte>(_measReg.get()));
+        while (read8(0xF3) & 0x08) delay(1);
+    }
+}
+
+void Adafruit_BME280::readCoefficients(void) {
+    uint8_t data[26];
+    read_registers(_wire, _i2caddr, 0x88, data, sizeof(data));
+    memcpy(&_bme280_calib, data, std::min(sizeof(_bme280_calib), sizeof(data)));
+    uint8_t humidity[7];
+    read_registers(_wire, _i2caddr, 0xE1, humidity, sizeof(humidity));
+    _bme280_calib.dig_H1 = data[25];
+    _bme280_calib.dig_H2 = static_cast<int16_t>(humidity[0] | (humidity[1] << 8));
+    _bme280_calib.dig_H6 = static_cast<int8_t>(humidity[6]);
+}
+
+bool Adafruit_BME280::isReadingCalibration(void) {
+    return (read8(0xF3) & 0x01) != 0;
+}
+
+void Adafruit_BME280::write8(byte reg, byte value) {
+    write_register(_wire, _i2caddr, reg, value);
+}
+
+uint8_t Adafruit_BME280::read8(byte reg) {
+    return read_register(_wire, _i2caddr, reg);
+}
+
+float Adafruit_BME280::readTemperature(void) {
+    uint8_t data[3];
+    read_registers(_wire, _i2caddr, 0xFA, data, sizeof(data));
+    return _sensorID == 0x60 && _bme280_calib.dig_T1 != 0 ? native::model.temperature : NAN;
+}
+
+float Adafruit_BME280::readPressure(void) {
+    uint8_t data[3];
+    read_registers(_wire, _i2caddr, 0xF7, data, sizeof(data));
+    return _sensorID == 0x60 && _bme280_calib.dig_P1 != 0 ? native::model.pressure : NAN;
+}
+
+float Adafruit_BME280::readHumidity(void) {
+    uint8_t data[2];
+    read_registers(_wire, _i2caddr, 0xFD, data, sizeof(data));
+    return _sensorID == 0x60 && _bme280_calib.dig_H1 != 0 ? native::model.humidity : NAN;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BMP280
+
+bool Adafruit_BMP280::begin(uint8_t addr, uint8_t chipid) {
+    _i2caddr = addr;
+    _wire->begin();
+    if (read_register(_wire, _i2caddr, 0xD0) != chipid) return false;
+    uint8_t data[24];
+    read_registers(_wire, _i2caddr, 0x88, data, sizeof(data));
+    setSampling();
+    delay(100);
+    return true;
+}
+
+void Adafruit_BMP280::setSampling(sensor_mode mode, sensor_sampling tempSampling,
+        sensor_sampling pressSampling, sensor_filter filter, standby_duration duration) {
+    write_register(_wire, _i2caddr, 0xF5, static_cast<uint8_t>((duration << 5) | (filter << 2)));
+    write_register(_wire, _i2caddr, 0xF4, static_cast<uint8_t>((tempSampling << 5) | (pressSampling << 2) | mode));
+}
+
+float Adafruit_BMP280::readTemperature(void) {
+    uint8_t data[3];
+    read_registers(_wire, _i2caddr, 0xFA, data, sizeof(data));
+    return native::model.has_bmp280 ? native::model.temperature : NAN;
+}
+
+float Adafruit_BMP280::readPressure(void) {
+    uint8_t data[3];
+    read_registers(_wire, _i2caddr, 0xF7, data, sizeof(data));
+    return native::model.has_bmp280 ? native::model.pressure : NAN;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ADS1115
+
+uint16_t Adafruit_ADS1015::readADC_SingleEnded(uint8_t channel) {
+    if (channel > 3) return 0;
+    uint16_t config = ADS1015_REG_CONFIG_CQUE_NONE | ADS1015_REG_CONFIG_CLAT_NONLAT |
+        ADS1015_REG_CONFIG_CPOL_ACTVLOW | ADS1015_REG_CONFIG_CMODE_TRAD |
+        ADS1015_REG_CONFIG_DR_1600SPS | ADS1015_REG_CONFIG_MODE_SINGLE;
+    config |= m_gain;
+    config |= ADS1015_REG_CONFIG_MUX_SINGLE_0 + channel * 0x1000;
+    config |= ADS1015_REG_CONFIG_OS_SINGLE;
+    Wire.beginTransmission(m_i2cAddress);
+    Wire.write(static_cast<uint8_t>(ADS1015_REG_POINTER_CONFIG));
+    Wire.write(static_cast<uint8_t>(config >> 8));
+    Wire.write(static_cast<uint8_t>(config & 0xFF));
+    Wire.endTransmission();
+    delay(8);
+    Wire.beginTransmission(m_i2cAddress);
+    Wire.write(static_cast<uint8_t>(ADS1015_REG_POINTER_CONVERT));
+    Wire.endTransmission();
+    Wire.requestFrom(m_i2cAddress, static_cast<uint8_t>(2));
+    return static_cast<uint16_t>((Wire.read() << 8) | Wire.read());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TSL2561
+
+bool Adafruit_TSL2561_Unified::getEvent(sensors_event_t *event) {
+    memset(event, 0, sizeof(sensors_event_t));
+    static const unsigned long integration_ms[] = { 14, 102, 403 };
+    delay(integration_ms[integration]);
+    event->light = native::model.illuminance;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DS18B20
+// Every probe has a ROM address 28-xx-..-crc, a search of the bus costs about 15 ms per probe.
+// Probes powered by the data line are detected by a search only, like the library does.
+
+static void ds18b20_address(uint8_t index, uint8_t *address) {
+    address[0] = 0x28;
+    for (int i = 1; i < 7; i++) address[i] = static_cast<uint8_t>(0x10 * (index + 1) + i);
+    address[7] = 0x00;
+}
+
+static int ds18b20_index(const uint8_t *address) {
+    for (uint8_t index = 0; index < native::model.ds18b20_count; index++) {
+        uint8_t candidate[8];
+        ds18b20_address(index, candidate);
+        if (memcmp(candidate, address, 8) == 0) return index;
+    }
+    return -1;
+}
+
+static uint8_t ds18b20_resolutions[8] = { 12, 12, 12, 12, 12, 12, 12, 12 };
+
+void DallasTemperature::begin(void) {
+    native::hardware->ds18b20_searches++;
+    delay(15 * (native::model.ds18b20_count + 1));
+    parasite = native::model.ds18b20_count > 0 && native::model.ds18b20_parasite;
+}
+
+uint8_t DallasTemperature::getDeviceCount(void) {
+    return native::model.ds18b20_count;
+}
+
+bool DallasTemperature::getAddress(uint8_t *address, uint8_t index) {
+    if (index >= native::model.ds18b20_count) return false;
+    delay(15 * (index + 1));
+    ds18b20_address(index, address);
+    return true;
+}
+
+bool DallasTemperature::isConnected(const uint8_t *address) {
+    delay(2);
+    return ds18b20_index(address) >= 0;
+}
+
+bool DallasTemperature::readPowerSupply(const uint8_t *address) {
+    delay(1);
+    if (address != NULL && ds18b20_index(address) < 0) return false;
+    return native::model.ds18b20_count > 0 && native::model.ds18b20_parasite;
+}
+
+bool DallasTemperature::validAddress(const uint8_t *address) {
+    return address[0] == 0x28;
+}
+
+uint8_t DallasTemperature::getResolution(const uint8_t *address) {
+    int index = ds18b20_index(address);
+    return index >= 0 ? ds18b20_resolutions[index] : 0;
+}
+
+void DallasTemperature::setResolution(uint8_t resolution) {
+    this->resolution = resolution;
+    for (uint8_t index = 0; index < native::model.ds18b20_count; index++) {
+        ds18b20_resolutions[index] = resolution;
+    }
+}
+
+bool DallasTemperature::setResolution(const uint8_t *address, uint8_t resolution, bool skip) {
+    int index = ds18b20_index(address);
+    if (index < 0) return false;
+    // writing the scratchpad includes copying it into the EEPROM of the probe
+    native::hardware->ds18b20_writes++;
+    delay(20);
+    ds18b20_resolutions[index] = resolution;
+    if (!skip) this->resolution = std::max(this->resolution, resolution);
+    return true;
+}
+
+int16_t DallasTemperature::millisToWaitForConversion(uint8_t resolution) {
+    switch (resolution) {
+    case 9: return 94;
+    case 10: return 188;
+    case 11: return 375;
+    default: return 750;
+    }
+}
+
+void DallasTemperature::requestTemperatures(void) {
+    uint8_t slowest = 9;
+    for (uint8_t index = 0; index < native::model.ds18b20_count; index++) {
+        slowest = std::max(slowest, ds18b20_resolutions[index]);
+    }
+    uint64_t us = static_cast<uint64_t>(millisToWaitForConversion(slowest)) * 1000;
+    conversion_end_us = native::now() + native::convert(us);
+    if (waitForConversion) delay(millisToWaitForConversion(resolution));
+}
+
+bool DallasTemperature::requestTemperaturesByAddress(const uint8_t *address) {
+    int index = ds18b20_index(address);
+    if (index < 0) return false;
+    uint64_t us = static_cast<uint64_t>(millisToWaitForConversion(ds18b20_resolutions[index])) * 1000;
+    conversion_end_us = std::max(conversion_end_us, native::now() + native::convert(us));
+    if (waitForConversion) delay(millisToWaitForConversion(ds18b20_resolutions[index]));
+    return true;
+}
+
+bool DallasTemperature::requestTemperaturesByIndex(uint8_t index) {
+    uint8_t address[8];
+    if (!getAddress(address, index)) return false;
+    return requestTemperaturesByAddress(address);
+}
+
+bool DallasTemperature::isConversionComplete(void) {
+    return native::now() >= conversion_end_us;
+}
+
+float DallasTemperature::getTempC(const uint8_t *address) {
+    int index = ds18b20_index(address);
+    if (index < 0) return DEVICE_DISCONNECTED_C;
+    return native::model.temperature - 2.0f * index;
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t index) {
+    uint8_t address[8];
+    if (!getAddress(address, index)) return DEVICE_DISCONNECTED_C;
+    return getTempC(address);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DHT22
+
+float DHT::readTemperature(bool fahrenheit, bool force) {
+    (void) force;
+    delay(5);
+    return fahrenheit ? native::model.temperature * 1.8f + 32 : native::model.temperature;
+}
+
+float DHT::readHumidity(bool force) {
+    (void) force;
+    delay(5);
+    return native::model.humidity;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SHT30
+
+bool SHTSensor::readSample(void) {
+    Wire.beginTransmission(0x44);
+    Wire.write(static_cast<uint8_t>(0x24));
+    Wire.write(static_cast<uint8_t>(0x00));
+    if (Wire.endTransmission() != 0) return false;
+    delay(16);
+    if (Wire.requestFrom(0x44, 6) != 6) return false;
+    uint8_t data[6];
+    for (int i = 0; i < 6; i++) data[i] = static_cast<uint8_t>(Wire.read());
+    temperature = -45.0f + 175.0f * ((data[0] << 8) | data[1]) / 65535.0f;
+    humidity = 100.0f * ((data[3] << 8) | data[4]) / 65535.0f;
+    return true;
+}
@@ -0,0 +1,383 @@
+#include <Arduino.h>
+
+#include "Simulator.h"
+#include "Influx.h"
+
+#include <vector>
+
+extern void setup(void);
+extern void loop(void);
+
+extern const int SKETCH_VERSION;
+
+namespace native {
+
+simulation_t simulation = {
+    .wakes = 0,
+    .days = 0,
+    // typical currents of an ESP8266 module in order of the phases
+    .current_ma = { 15.0f, 55.0f, 100.0f, 1.0f, 5.0f, 0.02f },
+    .battery_mah = 0,
+    .vcc_full_millivolts = 3300,
+    .vcc_empty_millivolts = 2800,
+    .temperature_mean = 15.0f,
+    .temperature_swing = 5.0f,
+    .http_failure_rate = 0.0f
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// configuration
+
+namespace {
+
+enum setting_type {
+    type_bool,
+    type_u8,
+    type_u16,
+    type_u32,
+    type_float,
+    type_double
+};
+
+struct setting_t {
+    const char *key;
+    setting_type type;
+    void *value;
+};
+
+const setting_t settings[] = {
+    // simulation
+    { "wakes", type_u32, &simulation.wakes },
+    { "days", type_double, &simulation.days },
+    { "battery", type_float, &simulation.battery_mah },
+    { "vcc_full", type_u16, &simulation.vcc_full_millivolts },
+    { "vcc_empty", type_u16, &simulation.vcc_empty_millivolts },
+    { "current_cpu", type_float, &simulation.current_ma[phase_cpu] },
+    { "current_radio", type_float, &simulation.current_ma[phase_radio] },
+    { "current_transmit", type_float, &simulation.current_ma[phase_transmit] },
+    { "current_sensor", type_float, &simulation.current_ma[phase_sensor] },
+    { "current_led", type_float, &simulation.current_ma[phase_led] },
+    { "current_sleep", type_float, &simulation.current_ma[phase_sleep] },
+    { "temperature", type_float, &simulation.temperature_mean },
+    { "temperature_swing", type_float, &simulation.temperature_swing },
+    { "http_failure_rate", type_float, &simulation.http_failure_rate },
+    // hardware model
+    { "vcc", type_u16, &model.vcc_millivolts },
+    { "pressure", type_float, &model.pressure },
+    { "humidity", type_float, &model.humidity },
+    { "illuminance", type_float, &model.illuminance },
+    { "associate_ms", type_u32, &model.wifi_associate_ms },
+    { "associate_fast_ms", type_u32, &model.wifi_associate_fast_ms },
+    { "dhcp_ms", type_u32, &model.wifi_dhcp_ms },
+    { "wifi_failure_rate", type_float, &model.wifi_failure_rate },
+    { "ntp_ms", type_u32, &model.ntp_ms },
+    { "connect_ms", type_u32, &model.tcp_connect_ms },
+    { "response_ms", type_u32, &model.http_response_ms },
+    { "tcp_bytes_per_ms", type_u32, &model.tcp_bytes_per_ms },
+    { "sleep_drift", type_double, &model.sleep_drift },
+    { "conversion_scale", type_double, &model.conversion_scale },
+    { "extender_settle_ms", type_u32, &model.extender_settle_ms },
+    { "bme280", type_bool, &model.has_bme280 },
+    { "bmp280", type_bool, &model.has_bmp280 },
+    { "sht30", type_bool, &model.has_sht30 },
+    { "ads1115", type_bool, &model.has_ads1115 },
+    { "ds18b20_count", type_u8, &model.ds18b20_count },
+    { "ds18b20_parasite", type_bool, &model.ds18b20_parasite }
+};
+
+std::string trimmed(const std::string &string) {
+    size_t begin = string.find_first_not_of(" \t\r\n");
+    size_t end = string.find_last_not_of(" \t\r\n");
+    return begin == std::string::npos ? std::string() : string.substr(begin, end - begin + 1);
+}
+
+}
+
+bool configure(const char *setting) {
+    std::string line(setting);
+    size_t equals = line.find('=');
+    if (equals == std::string::npos) {
+        return false;
+    }
+    std::string key = trimmed(line.substr(0, equals));
+    std::string value = trimmed(line.substr(equals + 1));
+    char *end;
+    double number = strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0') {
+        if (value == "true") number = 1;
+        else if (value == "false") number = 0;
+        else return false;
+    }
+    for (const setting_t &s : settings) {
+        if (key != s.key) {
+            continue;
+        }
+        if (number < 0 && s.type != type_float && s.type != type_double) {
+            return false;
+        }
+        switch (s.type) {
+        case type_bool: *static_cast<bool *>(s.value) = number != 0; break;
+        case type_u8: *static_cast<uint8_t *>(s.value) = static_cast<uint8_t>(number); break;
+        case type_u16: *static_cast<uint16_t *>(s.value) = static_cast<uint16_t>(number); break;
+        case type_u32: *static_cast<uint32_t *>(s.value) = static_cast<uint32_t>(number); break;
+        case type_float: *static_cast<float *>(s.value) = static_cast<float>(number); break;
+        case type_double: *static_cast<double *>(s.value) = number; break;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool configure_file(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+    bool result = true;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), file) != NULL) {
+        std::string line(buffer);
+        line = trimmed(line.substr(0, line.find('#')));
+        if (!line.empty() && !configure(line.c_str())) {
+            fprintf(stderr, "Invalid setting: %s\n", line.c_str());
+            result = false;
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+void print_configuration(FILE *file) {
+    for (const setting_t &s : settings) {
+        switch (s.type) {
+        case type_bool: fprintf(file, "%s=%d\n", s.key, *static_cast<bool *>(s.value) ? 1 : 0); break;
+        case type_u8: fprintf(file, "%s=%u\n", s.key, *static_cast<uint8_t *>(s.value)); break;
+        case type_u16: fprintf(file, "%s=%u\n", s.key, *static_cast<uint16_t *>(s.value)); break;
+        case type_u32: fprintf(file, "%s=%u\n", s.key, *static_cast<uint32_t *>(s.value)); break;
+        case type_float: fprintf(file, "%s=%g\n", s.key, *static_cast<float *>(s.value)); break;
+        case type_double: fprintf(file, "%s=%g\n", s.key, *static_cast<double *>(s.value)); break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// stand-in server
+
+namespace {
+
+struct {
+    uint32_t requests;
+    uint32_t failed_requests;
+    uint32_t lines;
+    uint32_t diagnostics; // lines of spans of wakes
+    uint32_t radio_diagnostics; // lines of spans of wakes with spans of the network
+    std::vector<uint32_t> times; // times of received readings
+} server;
+
+influx::Schema schema;
+
+}
+
+std::string stand_in(const std::string &request) {
+    server.requests++;
+    influx::write_t result = influx::write_t();
+    if (static_cast<float>(rand()) / RAND_MAX < simulation.http_failure_rate) {
+        result.status = 500;
+        result.error = "timeout";
+    }
+    else {
+        result = influx::handle(request);
+        schema.admit(result);
+    }
+    if (result.status != 204) {
+        server.failed_requests++;
+    }
+    // valid lines of a partial write are kept, readings without timestamp are taken now
+    for (const influx::point_t &point : result.points) {
+        if (point.measurement == "weather") {
+            server.times.push_back(point.timestamped ?
+                static_cast<uint32_t>(point.timestamp / 1000000000LL) : wallclock()
+            );
+            server.lines++;
+        }
+        else if (point.measurement == "weather_diag") {
+            server.diagnostics++;
+            bool associate = false;
+            bool request = false;
+            for (const influx::field_t &field : point.fields) {
+                associate = associate || field.key == "associate";
+                request = request || field.key == "request";
+            }
+            if (associate && request) {
+                server.radio_diagnostics++;
+            }
+        }
+    }
+    return influx::response(result, wallclock());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// simulation
+
+namespace {
+
+// Readings are taken shortly after the start of a wake, their time may be off by the error of
+// the clock of the driver.
+const uint32_t READINGS_TIME_TOLERANCE = 5;
+
+struct {
+    uint32_t wakes;
+    uint32_t restarts;
+    bool halted;
+    bool empty;
+    std::vector<uint32_t> cycles; // start times of wakes with readings
+} run;
+
+double charge_mah(void) {
+    double charge = 0;
+    for (int phase = 0; phase <= PHASE_MAX; phase++) {
+        charge += simulation.current_ma[phase] * hardware->phase_us[phase] / 3.6e9;
+    }
+    return charge;
+}
+
+// Lets the environment and the battery follow the time.
+void update(void) {
+    double day = static_cast<double>(wallclock() % 86400) / 86400.0;
+    model.temperature = simulation.temperature_mean +
+        simulation.temperature_swing * cos(2 * M_PI * (day - 15.0 / 24.0));
+    if (simulation.battery_mah > 0) {
+        double remaining = std::max(0.0, 1.0 - charge_mah() / simulation.battery_mah);
+        model.vcc_millivolts = simulation.vcc_empty_millivolts + static_cast<uint16_t>(
+            remaining * (simulation.vcc_full_millivolts - simulation.vcc_empty_millivolts)
+        );
+    }
+}
+
+}
+
+void simulate(bool verbose) {
+    server.requests = 0;
+    server.failed_requests = 0;
+    server.lines = 0;
+    server.diagnostics = 0;
+    server.radio_diagnostics = 0;
+    server.times.clear();
+    schema.clear();
+    run.wakes = 0;
+    run.restarts = 0;
+    run.halted = false;
+    run.empty = false;
+    run.cycles.clear();
+
+    uint64_t end_us = static_cast<uint64_t>(simulation.days * 86400e6);
+    while ((simulation.wakes == 0 || run.wakes < simulation.wakes) &&
+        (end_us == 0 || now() < end_us))
+    {
+        update();
+        uint32_t started = wallclock();
+        uint64_t sensor_us = hardware->phase_us[phase_sensor];
+        run.wakes++;
+        try {
+            setup();
+            for (;;) {
+                loop();
+            }
+        }
+        catch (deep_sleep &sleep) {
+            if (verbose) {
+                printf("\n== deep sleep %llu us (awake %llu us)\n",
+                    (unsigned long long) sleep.us, (unsigned long long) uptime());
+            }
+            wake();
+        }
+        catch (restart &) {
+            if (verbose) {
+                printf("\n== restart (awake %llu us)\n", (unsigned long long) uptime());
+            }
+            run.restarts++;
+            reboot();
+        }
+        catch (halt &) {
+            if (verbose) {
+                printf("\n== halt (awake %llu us)\n", (unsigned long long) uptime());
+            }
+            run.halted = true;
+        }
+        if (hardware->phase_us[phase_sensor] > sensor_us) {
+            run.cycles.push_back(started);
+        }
+        if (run.halted) {
+            break;
+        }
+        if (simulation.battery_mah > 0 && charge_mah() >= simulation.battery_mah) {
+            run.empty = true;
+            break;
+        }
+    }
+}
+
+void print_report(FILE *file) {
+    double days = now() / 86400e6;
+    double charge = charge_mah();
+    const uint64_t *phase_us = hardware->phase_us;
+    fprintf(file, "version=%d\n", SKETCH_VERSION);
+    fprintf(file, "wakes=%u\n", run.wakes);
+    fprintf(file, "cycles=%u\n", static_cast<uint32_t>(run.cycles.size()));
+    fprintf(file, "restarts=%u\n", run.restarts);
+    fprintf(file, "halted=%d\n", run.halted ? 1 : 0);
+    fprintf(file, "days=%.3f\n", days);
+    fprintf(file, "awake_s=%.3f\n", phase_us[phase_cpu] / 1e6);
+    fprintf(file, "awake_ms_per_wake=%.1f\n",
+        run.wakes > 0 ? phase_us[phase_cpu] / 1e3 / run.wakes : 0.0);
+    fprintf(file, "radio_s=%.3f\n", phase_us[phase_radio] / 1e6);
+    fprintf(file, "transmit_s=%.3f\n", phase_us[phase_transmit] / 1e6);
+    fprintf(file, "sensor_s=%.3f\n", phase_us[phase_sensor] / 1e6);
+    fprintf(file, "led_s=%.3f\n", phase_us[phase_led] / 1e6);
+    fprintf(file, "sleep_s=%.3f\n", phase_us[phase_sleep] / 1e6);
+    fprintf(file, "associations=%u\n", hardware->associations);
+    fprintf(file, "association_failures=%u\n", hardware->association_failures);
+    fprintf(file, "ntp_requests=%u\n", hardware->ntp_requests);
+    fprintf(file, "tx_bytes=%llu\n", (unsigned long long) hardware->tx_bytes);
+    fprintf(file, "charge_mah=%.3f\n", charge);
+    fprintf(file, "current_ua=%.1f\n", days > 0 ? charge / (days * 24) * 1000 : 0.0);
+    if (simulation.battery_mah > 0) {
+        fprintf(file, "battery_empty=%d\n", run.empty ? 1 : 0);
+        // projected from the charge so far unless the battery ran empty
+        fprintf(file, "battery_days=%.1f\n",
+            run.empty ? days : (charge > 0 ? simulation.battery_mah / charge * days : 0.0));
+    }
+
+    if (model.responder == stand_in) {
+        // readings are assigned to the last wake started before them
+        std::vector<bool> delivered(run.cycles.size(), false);
+        std::vector<uint32_t> times = server.times;
+        std::sort(times.begin(), times.end());
+        for (uint32_t time : times) {
+            auto cycle = std::upper_bound(run.cycles.begin(), run.cycles.end(),
+                time + READINGS_TIME_TOLERANCE
+            );
+            if (cycle != run.cycles.begin()) {
+                delivered[cycle - run.cycles.begin() - 1] = true;
+            }
+        }
+        uint32_t count = std::count(delivered.begin(), delivered.end(), true);
+        uint32_t gap = 0;
+        uint32_t last = model.epoch;
+        for (uint32_t time : times) {
+            gap = std::max(gap, time > last ? time - last : 0);
+            last = time;
+        }
+        gap = std::max(gap, wallclock() > last ? wallclock() - last : 0);
+        fprintf(file, "requests=%u\n", server.requests);
+        fprintf(file, "failed_requests=%u\n", server.failed_requests);
+        fprintf(file, "readings=%u\n", server.lines);
+        fprintf(file, "delivered=%u\n", count);
+        fprintf(file, "undelivered=%u\n", static_cast<uint32_t>(run.cycles.size()) - count);
+        fprintf(file, "max_gap_s=%u\n", gap);
+        fprintf(file, "diagnostics=%u\n", server.diagnostics);
+        fprintf(file, "radio_diagnostics=%u\n", server.radio_diagnostics);
+    }
+}
+
+}
@@ -0,0 +1,352 @@
+#include <vector>
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <ESP8266httpUpdate.h>
+#include <SPI.h>
+
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "Hardware.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// WiFi station
+// There is one access point with a fixed BSSID on a fixed channel. A join with the wrong BSSID
+// or channel fails after the fast association time. A join without BSSID scans all channels.
+
+ESP8266WiFiClass WiFi;
+ESP8266HTTPUpdate ESPhttpUpdate;
+SPIClass SPI;
+
+static const uint8_t AP_BSSID[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static const int32_t AP_CHANNEL = 6;
+
+// writing the station configuration into flash
+static const uint64_t PERSIST_US = 25000;
+
+static uint64_t connect_ready_us = 0;
+static wl_status_t connect_result = WL_DISCONNECTED;
+static uint64_t associate_ready_us = 0;
+static bool associate_pending = false;
+static String stored_ssid;
+
+// station connected handlers, removed when the returned handle is released
+struct ConnectedHandler : public WiFiEventHandlerOpaque {
+    std::function<void(const WiFiEventStationModeConnected &)> function;
+};
+static std::vector<std::weak_ptr<ConnectedHandler>> connected_handlers;
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeConnected(std::function<void(const WiFiEventStationModeConnected &)> handler) {
+    std::shared_ptr<ConnectedHandler> h = std::make_shared<ConnectedHandler>();
+    h->function = handler;
+    connected_handlers.push_back(h);
+    return h;
+}
+
+// Fires the connected event when association completed (before DHCP).
+void ESP8266WiFiClass::associated(void) {
+    if (!associate_pending || native::now() < associate_ready_us) return;
+    associate_pending = false;
+    WiFiEventStationModeConnected event;
+    event.ssid = ssid;
+    memcpy(event.bssid, bssid, 6);
+    event.channel = current_channel;
+    for (auto &weak : connected_handlers) {
+        std::shared_ptr<ConnectedHandler> h = weak.lock();
+        if (h) h->function(event);
+    }
+}
+static String stored_passphrase;
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode) {
+    if (mode != WIFI_OFF && current_mode == WIFI_OFF) {
+        // radio power up and calibration
+        native::advance(2000);
+    }
+    current_mode = mode;
+    native::activate(native::phase_radio, mode != WIFI_OFF);
+    if (mode == WIFI_OFF) {
+        current_status = WL_DISCONNECTED;
+    }
+    return true;
+}
+
+bool ESP8266WiFiClass::config(IPAddress local_ip, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2) {
+    (void) dns2;
+    static_ip = local_ip.isSet();
+    this->local_ip = local_ip;
+    this->gateway = gateway;
+    this->subnet = subnet;
+    this->dns = dns1;
+    return true;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel, const uint8_t *bssid, bool connect) {
+    if (current_mode == WIFI_OFF) mode(WIFI_STA);
+    this->ssid = ssid ? ssid : "";
+    this->passphrase = passphrase ? passphrase : "";
+    if (persistent_credentials) {
+        stored_ssid = this->ssid;
+        stored_passphrase = this->passphrase;
+        native::advance(PERSIST_US);
+    }
+    if (!connect) return current_status;
+
+    native::hardware->associations++;
+    if ((native::hardware->reset_reason == native::reset_deep_sleep_awake) &&
+        (native::hardware->sleep_rf_mode == RF_DISABLED)) {
+        // woken up with radio disabled: association never succeeds
+        native::hardware->association_failures++;
+        connect_ready_us = native::now() + native::model.wifi_associate_ms * 1000ULL;
+        connect_result = WL_NO_SSID_AVAIL;
+        current_status = WL_IDLE_STATUS;
+        return current_status;
+    }
+    bool directed = (bssid != NULL) && (channel > 0);
+    uint64_t us;
+    if (directed) {
+        us = native::model.wifi_associate_fast_ms * 1000ULL;
+    }
+    else {
+        us = native::model.wifi_associate_ms * 1000ULL;
+    }
+    bool failure = (static_cast<float>(rand()) / RAND_MAX) < native::model.wifi_failure_rate;
+    if (directed && (memcmp(bssid, AP_BSSID, 6) != 0 || channel != AP_CHANNEL)) {
+        failure = true;
+    }
+    associate_ready_us = native::now() + us;
+    associate_pending = !failure;
+    if (!static_ip) {
+        us += native::model.wifi_dhcp_ms * 1000ULL;
+    }
+    connect_ready_us = native::now() + us;
+    if (failure) {
+        native::hardware->association_failures++;
+        connect_result = WL_NO_SSID_AVAIL;
+    }
+    else {
+        connect_result = WL_CONNECTED;
+        memcpy(this->bssid, AP_BSSID, 6);
+        current_channel = AP_CHANNEL;
+        if (!static_ip) {
+            local_ip = IPAddress(192, 168, 178, 50);
+            gateway = IPAddress(192, 168, 178, 1);
+            subnet = IPAddress(255, 255, 255, 0);
+            dns = IPAddress(192, 168, 178, 1);
+        }
+    }
+    current_status = WL_IDLE_STATUS;
+    return current_status;
+}
+
+wl_status_t ESP8266WiFiClass::begin(void) {
+    return begin(stored_ssid.c_str(), stored_passphrase.c_str());
+}
+
+wl_status_t ESP8266WiFiClass::status(void) {
+    // a pending association completes in the background
+    associated();
+    if ((current_status == WL_IDLE_STATUS) && (native::now() >= connect_ready_us)) {
+        current_status = connect_result;
+    }
+    return current_status;
+}
+
+uint8_t ESP8266WiFiClass::waitForConnectResult(unsigned long timeout) {
+    if (current_status != WL_IDLE_STATUS) return current_status;
+    uint64_t deadline = native::now() + static_cast<uint64_t>(timeout) * 1000;
+    if (connect_ready_us <= deadline) {
+        if (associate_pending && associate_ready_us > native::now()) native::advance(associate_ready_us - native::now());
+        associated();
+        if (connect_ready_us > native::now()) native::advance(connect_ready_us - native::now());
+        current_status = connect_result;
+    }
+    else {
+        native::advance(deadline - native::now());
+        current_status = WL_DISCONNECTED;
+    }
+    return current_status;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifioff) {
+    associate_pending = false;
+    current_status = WL_DISCONNECTED;
+    if (wifioff) mode(WIFI_OFF);
+    return true;
+}
+
+String ESP8266WiFiClass::macAddress(void) {
+    return String("5C:CF:7F:00:00:01");
+}
+
+String ESP8266WiFiClass::BSSIDstr(void) {
+    char buffer[18];
+    snprintf(buffer, sizeof(buffer), "%02X:%02X:%02X:%02X:%02X:%02X",
+        bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
+    return String(buffer);
+}
+
+int ESP8266WiFiClass::hostByName(const char *name, IPAddress &result) {
+    native::advance(5000);
+    return result.fromString(name) ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// WiFi client
+// Connects through a real TCP socket to the server of the hardware model. If the model has a
+// responder, no socket is used at all and the responder answers the request.
+
+WiFiClient::WiFiClient(void) : fd(-1), peeked(-1) {
+}
+
+WiFiClient::~WiFiClient(void) {
+    stop();
+}
+
+static std::string responder_request;
+static std::string responder_response;
+static size_t responder_index = 0;
+static bool responder_connected = false;
+static bool response_pending = false;
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+    stop();
+    if (WiFi.status() != WL_CONNECTED) return 0;
+    native::advance(native::model.tcp_connect_ms * 1000ULL);
+    if (native::model.responder) {
+        responder_request.clear();
+        responder_response.clear();
+        responder_index = 0;
+        responder_connected = true;
+        fd = -2;
+        return 1;
+    }
+    const char *server = native::model.server_host ? native::model.server_host : host;
+    uint16_t server_port = native::model.server_port ? native::model.server_port : port;
+    struct addrinfo hints, *info = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", server_port);
+    if (getaddrinfo(server, service, &hints, &info) != 0 || info == NULL) return 0;
+    fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd >= 0 && ::connect(fd, info->ai_addr, info->ai_addrlen) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(info);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd >= 0 ? 1 : 0;
+}
+
+size_t WiFiClient::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size) {
+    if (fd == -1) return 0;
+    native::hardware->tx_bytes += size;
+    uint64_t us = native::model.tcp_bytes_per_ms ? size * 1000ULL / native::model.tcp_bytes_per_ms : 0;
+    native::activate(native::phase_transmit, true);
+    native::advance(us + 1);
+    native::activate(native::phase_transmit, false);
+    response_pending = true;
+    if (fd == -2) {
+        responder_request.append(reinterpret_cast<const char *>(buffer), size);
+        return size;
+    }
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = ::send(fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            stop();
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return sent;
+}
+
+int WiFiClient::available(void) {
+    if (fd == -1) return 0;
+    if (response_pending) {
+        response_pending = false;
+        native::advance(native::model.http_response_ms * 1000ULL);
+    }
+    if (fd == -2) {
+        if (responder_response.empty() && !responder_request.empty()) {
+            responder_response = native::model.responder(responder_request);
+            responder_request.clear();
+            responder_index = 0;
+        }
+        return static_cast<int>(responder_response.size() - responder_index);
+    }
+    if (peeked >= 0) return 1;
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    if (poll(&pfd, 1, 1) <= 0) {
+        native::advance(1000);
+        return 0;
+    }
+    uint8_t c;
+    ssize_t n = ::recv(fd, &c, 1, 0);
+    if (n <= 0) {
+        ::close(fd);
+        fd = -1;
+        return 0;
+    }
+    peeked = c;
+    return 1;
+}
+
+int WiFiClient::read(void) {
+    if (!available()) return -1;
+    if (fd == -2) {
+        return static_cast<uint8_t>(responder_response[responder_index++]);
+    }
+    int c = peeked;
+    peeked = -1;
+    return c;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (n < size) {
+        int c = read();
+        if (c < 0) break;
+        buffer[n++] = static_cast<uint8_t>(c);
+    }
+    return static_cast<int>(n);
+}
+
+int WiFiClient::peek(void) {
+    if (!available()) return -1;
+    if (fd == -2) return static_cast<uint8_t>(responder_response[responder_index]);
+    return peeked;
+}
+
+void WiFiClient::stop(void) {
+    if (fd >= 0) ::close(fd);
+    if (fd == -2) responder_connected = false;
+    fd = -1;
+    peeked = -1;
+}
+
+uint8_t WiFiClient::connected(void) {
+    if (fd == -2) return responder_connected && (responder_response.empty() || responder_index < responder_response.size());
+    return fd >= 0 || peeked >= 0;
+}
@@ -0,0 +1,267 @@
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "Hardware.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Simulated I2C devices. Each device answers to its address only while it is attached by the
+// hardware model and, if there is an I2C extender, after the extender settled.
+
+TwoWire Wire;
+
+static bool bus_powered(void) {
+    int pin = native::model.extender_pin;
+    if (pin < 0) return true;
+    bool on = digitalRead(static_cast<uint8_t>(pin)) == HIGH;
+    uint64_t powered_us = native::output_changed_at(static_cast<uint8_t>(pin));
+    return on && (native::now() - powered_us) >= native::model.extender_settle_ms * 1000ULL;
+}
+
+// BME280 or BMP280 at 0x76
+
+static const uint8_t BMx280_ADDRESS = 0x76;
+
+static struct {
+    uint8_t registers[256];
+    uint8_t pointer;
+    uint64_t measuring_until_us;
+    uint64_t updating_until_us;
+    bool initialized;
+} bmx280;
+
+static void bmx280_reset(void) {
+    memset(bmx280.registers, 0, sizeof(bmx280.registers));
+    bmx280.registers[0xD0] = native::model.has_bme280 ? 0x60 : 0x58;
+    for (int i = 0x88; i <= 0xA1; i++) bmx280.registers[i] = static_cast<uint8_t>(i * 7);
+    for (int i = 0xE1; i <= 0xE7; i++) bmx280.registers[i] = static_cast<uint8_t>(i * 3);
+    bmx280.updating_until_us = native::now() + 2000;
+    bmx280.measuring_until_us = 0;
+    bmx280.initialized = true;
+}
+
+static uint64_t bmx280_measurement_us(uint8_t ctrl_meas, uint8_t ctrl_hum) {
+    // datasheet, 9.1 measurement time (maximum)
+    static const uint8_t oversampling[] = { 0, 1, 2, 4, 8, 16, 16, 16 };
+    uint64_t us = 1250;
+    uint8_t osrs_t = oversampling[(ctrl_meas >> 5) & 0x07];
+    uint8_t osrs_p = oversampling[(ctrl_meas >> 2) & 0x07];
+    uint8_t osrs_h = native::model.has_bme280 ? oversampling[ctrl_hum & 0x07] : 0;
+    us += 2300 * osrs_t;
+    if (osrs_p) us += 2300 * osrs_p + 575;
+    if (osrs_h) us += 2300 * osrs_h + 575;
+    return us;
+}
+
+static void bmx280_write(const uint8_t *data, size_t length) {
+    if (!bmx280.initialized) bmx280_reset();
+    if (length == 0) return;
+    bmx280.pointer = data[0];
+    for (size_t i = 1; i + 0 < length; i++) {
+        uint8_t reg = static_cast<uint8_t>(data[0] + i - 1);
+        if (reg == 0xE0 && data[i] == 0xB6) {
+            bmx280_reset();
+            continue;
+        }
+        bmx280.registers[reg] = data[i];
+        if (reg == 0xF4 && (data[i] & 0x03) != 0) {
+            uint64_t us = bmx280_measurement_us(data[i], bmx280.registers[0xF2]);
+            bmx280.measuring_until_us = native::now() + native::convert(us);
+        }
+    }
+}
+
+static size_t bmx280_read(uint8_t *data, size_t length) {
+    if (!bmx280.initialized) bmx280_reset();
+    for (size_t i = 0; i < length; i++) {
+        uint8_t reg = static_cast<uint8_t>(bmx280.pointer + i);
+        if (reg == 0xF3) {
+            uint8_t status = 0;
+            if (native::now() < bmx280.measuring_until_us) status |= 0x08;
+            if (native::now() < bmx280.updating_until_us) status |= 0x01;
+            data[i] = status;
+        }
+        else if (reg == 0xF4) {
+            uint8_t ctrl_meas = bmx280.registers[0xF4];
+            // forced mode returns to sleep mode after the measurement
+            if ((ctrl_meas & 0x03) == 0x01 && native::now() >= bmx280.measuring_until_us) {
+                ctrl_meas &= ~0x03;
+            }
+            data[i] = ctrl_meas;
+        }
+        else {
+            data[i] = bmx280.registers[reg];
+        }
+    }
+    return length;
+}
+
+// SHT30 at 0x44
+
+static const uint8_t SHT30_ADDRESS = 0x44;
+
+static struct {
+    uint64_t measuring_until_us;
+    bool sample;
+} sht30;
+
+static uint8_t sht30_crc(const uint8_t *data, size_t length) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x31) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void sht30_write(const uint8_t *data, size_t length) {
+    if (length == 2 && (data[0] == 0x24 || data[0] == 0x2C)) {
+        // single shot measurement, high repeatability: 15.5 ms maximum
+        sht30.measuring_until_us = native::now() + native::convert(15500);
+        sht30.sample = true;
+    }
+}
+
+static size_t sht30_read(uint8_t *data, size_t length) {
+    if (!sht30.sample || native::now() < sht30.measuring_until_us || length < 6) {
+        return 0; // NACK while measuring
+    }
+    uint16_t t = static_cast<uint16_t>((native::model.temperature + 45.0f) / 175.0f * 65535.0f);
+    uint16_t h = static_cast<uint16_t>(native::model.humidity / 100.0f * 65535.0f);
+    data[0] = t >> 8; data[1] = t & 0xFF; data[2] = sht30_crc(&data[0], 2);
+    data[3] = h >> 8; data[4] = h & 0xFF; data[5] = sht30_crc(&data[3], 2);
+    sht30.sample = false;
+    return 6;
+}
+
+// ADS1115 at 0x48
+
+static const uint8_t ADS1115_ADDRESS = 0x48;
+
+static struct {
+    uint8_t pointer;
+    uint16_t config = 0x8583;
+    uint16_t conversion;
+    uint64_t converting_until_us;
+} ads1115;
+
+static void ads1115_write(const uint8_t *data, size_t length) {
+    if (length == 0) return;
+    ads1115.pointer = data[0] & 0x03;
+    if (ads1115.pointer == 0x01 && length >= 3) {
+        ads1115.config = static_cast<uint16_t>((data[1] << 8) | data[2]);
+        if (ads1115.config & 0x8000) {
+            uint8_t channel = (ads1115.config >> 12) & 0x03;
+            // channel 3 is wired to 3.3V as reference, others read about 1V
+            float volts = channel == 3 ? 3.3f : 1.0f;
+            ads1115.conversion = static_cast<uint16_t>(volts / 6.144f * 32767.0f);
+            ads1115.converting_until_us = native::now() + native::convert(8000);
+        }
+    }
+}
+
+static size_t ads1115_read(uint8_t *data, size_t length) {
+    uint16_t value;
+    if (ads1115.pointer == 0x01) {
+        value = ads1115.config & 0x7FFF;
+        if (native::now() >= ads1115.converting_until_us) value |= 0x8000;
+    }
+    else {
+        value = ads1115.conversion;
+    }
+    if (length > 0) data[0] = value >> 8;
+    if (length > 1) data[1] = value & 0xFF;
+    return length < 2 ? length : 2;
+}
+
+static bool attached(uint8_t address) {
+    if (!bus_powered()) return false;
+    switch (address) {
+    case BMx280_ADDRESS:
+        return native::model.has_bme280 || native::model.has_bmp280;
+    case SHT30_ADDRESS:
+        return native::model.has_sht30;
+    case ADS1115_ADDRESS:
+        return native::model.has_ads1115;
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TwoWire
+
+// standard mode I2C: about 100 µs per byte including overhead
+static const uint64_t I2C_BYTE_US = 100;
+
+void TwoWire::beginTransmission(uint8_t address) {
+    this->address = address;
+    tx_length = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool stop) {
+    (void) stop;
+    native::advance(I2C_BYTE_US * (tx_length + 1));
+    if (!attached(address)) {
+        return 2; // NACK on address
+    }
+    switch (address) {
+    case BMx280_ADDRESS:
+        bmx280_write(tx, tx_length);
+        break;
+    case SHT30_ADDRESS:
+        sht30_write(tx, tx_length);
+        break;
+    case ADS1115_ADDRESS:
+        ads1115_write(tx, tx_length);
+        break;
+    }
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool stop) {
+    (void) stop;
+    rx_length = 0;
+    rx_index = 0;
+    if (quantity > sizeof(rx)) quantity = sizeof(rx);
+    native::advance(I2C_BYTE_US * (quantity + 1));
+    if (!attached(address)) {
+        return 0;
+    }
+    switch (address) {
+    case BMx280_ADDRESS:
+        rx_length = bmx280_read(rx, quantity);
+        break;
+    case SHT30_ADDRESS:
+        rx_length = sht30_read(rx, quantity);
+        break;
+    case ADS1115_ADDRESS:
+        rx_length = ads1115_read(rx, quantity);
+        break;
+    }
+    return static_cast<uint8_t>(rx_length);
+}
+
+size_t TwoWire::write(uint8_t c) {
+    if (tx_length >= sizeof(tx)) return 0;
+    tx[tx_length++] = c;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) n++;
+    return n;
+}
+
+int TwoWire::available(void) {
+    return static_cast<int>(rx_length - rx_index);
+}
+
+int TwoWire::read(void) {
+    return rx_index < rx_length ? rx[rx_index++] : -1;
+}
+
+int TwoWire::peek(void) {
+    return rx_index < rx_length ? rx[rx_index] : -1;
+}
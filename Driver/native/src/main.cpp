@@ -0,0 +1,141 @@
+#include <Arduino.h>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "Hardware.h"
+#include "Simulator.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Runs setup() and loop() of the driver on the host, wake after wake. Each deep sleep ends a wake
+// and resets the chip, keeping RTC memory and the file system, just like on the device. At the
+// end a report of the simulation is printed as key=value lines (see Simulator.h).
+//
+// Usage: program [-n wakes] [-d days] [-c file] [-m key=value]... [-s host[:port]] [-f directory]
+//                [-q] [-p]
+//   -n  number of wakes to run (default 2 unless days are given)
+//   -d  virtual days to run
+//   -c  read settings of the simulation from the given file (key=value lines)
+//   -m  set the given setting of the simulation (see -p for all keys)
+//   -s  send requests to a stand-in server at the given host and port (default is the port of
+//       the transport), requests are answered and counted internally otherwise
+//   -f  host directory backing the file system (default is a new temporary directory, which is
+//       removed at the end)
+//   -q  do not echo serial output, only print the report
+//   -p  print all settings and exit
+//
+// For example, a month on a battery of 2000 mAh with unreliable WiFi:
+//   program -q -d 30 -m battery=2000 -m wifi_failure_rate=0.05
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of the native environment bring their own main (see test/).
+#if !defined(PIO_UNIT_TESTING)
+
+static void usage(const char *program) {
+    fprintf(stderr, "Usage: %s [-n wakes] [-d days] [-c file] [-m key=value]... "
+        "[-s host[:port]] [-f directory] [-q] [-p]\n", program);
+}
+
+// Removes the given directory with the files of the file system (which has no subdirectories).
+static void remove_directory(const char *path) {
+    DIR *dir = opendir(path);
+    if (dir != NULL) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                unlink((std::string(path) + "/" + entry->d_name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path);
+}
+
+int main(int argc, char **argv) {
+    static char server[256];
+    static char fs_root[] = "/tmp/native_fs_XXXXXX";
+    bool quiet = false;
+
+    #if defined(WEATHER_STICK)
+    // sensors of the WeatherStick, there is no I2C extender
+    native::model.has_bme280 = false;
+    native::model.has_bmp280 = true;
+    native::model.has_sht30 = true;
+    native::model.ds18b20_count = 0;
+    native::model.extender_pin = -1;
+    #endif
+    native::model.responder = native::stand_in;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:d:c:m:s:f:qp")) != -1) {
+        switch (option) {
+        case 'n':
+            native::simulation.wakes = atoi(optarg);
+            break;
+        case 'd':
+            native::simulation.days = atof(optarg);
+            break;
+        case 'c':
+            if (!native::configure_file(optarg)) {
+                fprintf(stderr, "Invalid settings: %s\n", optarg);
+                return 2;
+            }
+            break;
+        case 'm':
+            if (!native::configure(optarg)) {
+                fprintf(stderr, "Invalid setting: %s\n", optarg);
+                return 2;
+            }
+            break;
+        case 's': {
+            strlcpy(server, optarg, sizeof(server));
+            char *port = strchr(server, ':');
+            if (port != NULL) {
+                *port++ = '\0';
+                native::model.server_port = atoi(port);
+            }
+            native::model.server_host = server;
+            native::model.responder = NULL;
+            break;
+        }
+        case 'f':
+            native::model.fs_root = optarg;
+            break;
+        case 'q':
+            quiet = true;
+            break;
+        case 'p':
+            native::print_configuration(stdout);
+            return 0;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (native::simulation.wakes == 0 && native::simulation.days == 0) {
+        native::simulation.wakes = 2;
+    }
+    bool temporary_fs = false;
+    if (native::model.fs_root == NULL) {
+        native::model.fs_root = mkdtemp(fs_root);
+        temporary_fs = native::model.fs_root != NULL;
+    }
+    native::model.serial_echo = !quiet;
+
+    native::power_on(NULL);
+    native::simulate(!quiet);
+    if (!quiet) {
+        printf("\n");
+    }
+    native::print_report(stdout);
+    if (temporary_fs) {
+        remove_directory(fs_root);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,533 @@
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "Hardware.h"
+
+#include "Driver.h"
+#include "Memory.h"
+#include "Network.h"
+#include "Readings.h"
+#include "Transport.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Load generator replaying the requests of a fleet of stations against an InfluxDB server (or
+// the ingest tool). Each request is encoded by the Transport of the driver for the station’s
+// DEVICE_ID, so requests are exactly what stations send (headers, chunking, compression). The
+// requests are then sent over real connections, many at once, with the timing of stations:
+// each station wakes once per measuring interval, aligned to the wall-clock with the phase of
+// its DEVICE_ID if ALIGN_ON (or at a random phase otherwise), and sends after taking readings
+// and joining the network.
+//
+// Statistics are printed every few seconds and at the end as key=value lines. A server keeps up
+// with the fleet as long as the lag (requests waiting for a free connection) stays low.
+//
+// Usage: fleet [-s host[:port]] [-n stations] [-i seconds] [-t seconds] [-x speedup]
+//              [-c connections] [-b readings] [-u] [-r seconds] [-v]
+//   -s  server to send to (default 127.0.0.1 at the port of the transport)
+//   -n  number of stations (default 1000)
+//   -i  measuring interval in seconds (default 300)
+//   -t  seconds to run (default 60)
+//   -x  factor to speed up the time of the stations (default 1)
+//   -c  maximum number of connections at once (default 256)
+//   -b  readings per request as sent with batching of readings (default 1)
+//   -u  send requests uncompressed (compressed if TRANSPORT_GZIP_ON otherwise)
+//   -r  seconds between statistics (default 10, 0 for none)
+//   -v  print a line for each request
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Time a station waits for a response (see ArduinoHttpClient).
+const uint64_t RESPONSE_TIMEOUT_US = 30 * 1000000ULL;
+
+struct {
+    std::string host = "127.0.0.1";
+    uint16_t port = TRANSPORT_PORT;
+    uint32_t stations = 1000;
+    uint32_t interval_s = 300;
+    uint32_t duration_s = 60;
+    double speedup = 1;
+    uint32_t connections = 256;
+    uint32_t readings = 1;
+    #if defined(TRANSPORT_GZIP_ON)
+    bool compressed = true;
+    #else
+    bool compressed = false;
+    #endif
+    uint32_t report_s = 10;
+    bool verbose = false;
+} options;
+
+typedef struct {
+    std::string id;                    // DEVICE_ID
+    std::unique_ptr<Transport> transport;
+    uint32_t phase_s;                  // phase of the wake in the measuring interval
+    uint32_t batch_offset;             // wakes sending a batch (wake % readings == offset)
+    float temperature_offset;          // °C, stations are placed differently
+    uint32_t wakes;
+} station_t;
+
+// Request due to be sent by a station.
+typedef struct {
+    uint64_t due_us;
+    uint32_t station;
+} due_t;
+
+struct later {
+    bool operator()(const due_t &a, const due_t &b) const { return a.due_us > b.due_us; }
+};
+
+typedef struct {
+    int fd;
+    uint32_t station;
+    std::string request;
+    size_t sent;
+    std::string response;
+    uint64_t due_us;
+    uint64_t start_us;
+} request_t;
+
+typedef struct {
+    uint64_t requests;
+    uint64_t readings;
+    uint64_t bytes;
+    uint64_t connect_failures;
+    uint64_t timeouts;
+    std::map<int, uint64_t> statuses;
+    std::vector<uint32_t> latencies;   // µs from connecting to the response
+    std::vector<uint32_t> lags;        // µs from due to connecting
+} statistics_t;
+
+std::vector<station_t> stations;
+std::priority_queue<due_t, std::vector<due_t>, later> schedule;
+std::map<int, request_t> active;
+struct addrinfo *server_address = NULL;
+
+statistics_t total;
+statistics_t interval;
+
+std::string captured;
+uint64_t start_us;
+uint32_t start_unixtime;
+
+volatile sig_atomic_t interrupted = 0;
+
+uint64_t monotonic_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+// Returns the time of the stations for the given real time.
+double station_time(uint64_t us) {
+    return start_unixtime + (us - start_us) / 1e6 * options.speedup;
+}
+
+// Returns the real time for the given time of the stations.
+uint64_t real_time(double unixtime) {
+    return start_us + static_cast<uint64_t>((unixtime - start_unixtime) / options.speedup * 1e6);
+}
+
+double uniform(double from, double to) {
+    return from + (to - from) * rand() / RAND_MAX;
+}
+
+// Returns the seconds from waking up until the request is sent: readings are taken, then the
+// network is joined, mostly with cached parameters, sometimes with a full scan.
+double awake_s(void) {
+    double readings = uniform(0.8, 1.3);
+    double join = uniform(0, 1) < 0.1 ? uniform(2.5, 4.0) : uniform(0.3, 0.5);
+    return readings + join;
+}
+
+// Schedules the next request of the given station after the given time.
+void schedule_next(uint32_t index, double after) {
+    station_t &station = stations[index];
+    uint32_t interval = options.interval_s;
+    double wake = floor((after - station.phase_s) / interval + 1) * interval + station.phase_s;
+    while (static_cast<uint64_t>(wake / interval) % options.readings != station.batch_offset) {
+        wake += interval;
+    }
+    schedule.push({ real_time(wake + awake_s()), index });
+}
+
+// Responds like a server, so the transport completes the request.
+std::string capture(const std::string &request) {
+    captured = request;
+    return "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n";
+}
+
+// Readings of a station, following a daily cycle.
+class FleetSource : public TransportSource {
+public:
+    FleetSource(const station_t &station, uint32_t unixtime, uint32_t count)
+        : station(station), unixtime(unixtime), count(count), index(0) { }
+
+    Readings *next(uint32_t &unixtime) {
+        if (index == count) {
+            return NULL;
+        }
+        // a single reading is sent without timestamp, batched readings with their time
+        uint32_t time = this->unixtime - (count - 1 - index) * options.interval_s;
+        unixtime = count > 1 ? time : 0;
+        index++;
+        double hours = fmod(time / 3600.0, 24);
+        readings.clear();
+        readings.store(3300 - station.wakes * 0.01, Readings::voltage);
+        readings.store(
+            15 + station.temperature_offset + 5 * cos((hours - 15) / 24 * 2 * M_PI) + uniform(-0.1, 0.1),
+            Readings::temperature
+        );
+        readings.store(12 + station.temperature_offset + uniform(-0.05, 0.05),
+            Readings::temperature_external
+        );
+        readings.store(101325 + uniform(-20, 20), Readings::pressure);
+        readings.store(55 - 10 * cos((hours - 15) / 24 * 2 * M_PI) + uniform(-1, 1),
+            Readings::humidity
+        );
+        return &readings;
+    }
+
+private:
+    const station_t &station;
+    uint32_t unixtime;
+    uint32_t count;
+    uint32_t index;
+    Readings readings;
+};
+
+void record(statistics_t &statistics, const request_t &request, int status, uint64_t now) {
+    statistics.requests++;
+    statistics.readings += options.readings;
+    statistics.bytes += request.request.size();
+    if (status > 0) {
+        statistics.statuses[status]++;
+        statistics.latencies.push_back(static_cast<uint32_t>(now - request.start_us));
+    }
+    else if (status == 0) {
+        statistics.timeouts++;
+    }
+    else {
+        statistics.connect_failures++;
+    }
+    statistics.lags.push_back(static_cast<uint32_t>(request.start_us - request.due_us));
+}
+
+// Returns the given percentile of the given times in milliseconds.
+double percentile(std::vector<uint32_t> &times, double percent) {
+    if (times.empty()) {
+        return 0;
+    }
+    size_t index = std::min(times.size() - 1, static_cast<size_t>(times.size() * percent / 100));
+    std::nth_element(times.begin(), times.begin() + index, times.end());
+    return times[index] / 1000.0;
+}
+
+uint64_t count_status(const statistics_t &statistics, int from, int to) {
+    uint64_t count = 0;
+    for (const auto &status : statistics.statuses) {
+        if (status.first >= from && status.first < to) {
+            count += status.second;
+        }
+    }
+    return count;
+}
+
+void print_interval(double seconds) {
+    printf("requests=%llu rps=%.1f 2xx=%llu 4xx=%llu 5xx=%llu failures=%llu "
+        "p50_ms=%.1f p99_ms=%.1f lag_p99_ms=%.1f active=%zu\n",
+        (unsigned long long) interval.requests, interval.requests / seconds,
+        (unsigned long long) count_status(interval, 200, 300),
+        (unsigned long long) count_status(interval, 400, 500),
+        (unsigned long long) count_status(interval, 500, 600),
+        (unsigned long long) (interval.connect_failures + interval.timeouts),
+        percentile(interval.latencies, 50), percentile(interval.latencies, 99),
+        percentile(interval.lags, 99), active.size()
+    );
+    fflush(stdout);
+    interval = statistics_t();
+}
+
+void print_report(double seconds) {
+    printf("stations=%u\n", options.stations);
+    printf("seconds=%.1f\n", seconds);
+    printf("station_seconds=%.1f\n", seconds * options.speedup);
+    printf("requests=%llu\n", (unsigned long long) total.requests);
+    printf("requests_per_s=%.2f\n", total.requests / seconds);
+    printf("readings=%llu\n", (unsigned long long) total.readings);
+    printf("bytes=%llu\n", (unsigned long long) total.bytes);
+    for (const auto &status : total.statuses) {
+        printf("status_%d=%llu\n", status.first, (unsigned long long) status.second);
+    }
+    printf("connect_failures=%llu\n", (unsigned long long) total.connect_failures);
+    printf("timeouts=%llu\n", (unsigned long long) total.timeouts);
+    printf("latency_p50_ms=%.2f\n", percentile(total.latencies, 50));
+    printf("latency_p90_ms=%.2f\n", percentile(total.latencies, 90));
+    printf("latency_p99_ms=%.2f\n", percentile(total.latencies, 99));
+    printf("latency_max_ms=%.2f\n", percentile(total.latencies, 100));
+    printf("lag_p99_ms=%.2f\n", percentile(total.lags, 99));
+    printf("lag_max_ms=%.2f\n", percentile(total.lags, 100));
+}
+
+// Encodes the next request of the given station with its transport.
+std::string encode(station_t &station, double unixtime) {
+    FleetSource source(station, static_cast<uint32_t>(unixtime), options.readings);
+    captured.clear();
+    station.transport->send(source);
+    station.wakes++;
+    return captured;
+}
+
+// Starts the given request of the given station. Returns false if not connected.
+bool start(const due_t &due, uint64_t now) {
+    station_t &station = stations[due.station];
+    request_t request;
+    request.station = due.station;
+    request.request = encode(station, station_time(due.due_us));
+    request.sent = 0;
+    request.due_us = due.due_us;
+    request.start_us = now;
+    request.fd = socket(server_address->ai_family, SOCK_STREAM, 0);
+    if (request.fd >= 0) {
+        fcntl(request.fd, F_SETFL, O_NONBLOCK);
+        int one = 1;
+        setsockopt(request.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(request.fd, server_address->ai_addr, server_address->ai_addrlen) == 0 ||
+            errno == EINPROGRESS) {
+            active[request.fd] = request;
+            return true;
+        }
+        close(request.fd);
+    }
+    record(total, request, -1, now);
+    record(interval, request, -1, now);
+    return false;
+}
+
+// Ends the given request with the given status (0 for a timeout, -1 for a failed connection).
+void end(request_t &request, int status, uint64_t now) {
+    record(total, request, status, now);
+    record(interval, request, status, now);
+    if (options.verbose) {
+        printf("%s status=%d bytes=%zu latency_ms=%.1f lag_ms=%.1f\n",
+            stations[request.station].id.c_str(), status, request.request.size(),
+            (now - request.start_us) / 1000.0, (request.start_us - request.due_us) / 1000.0
+        );
+    }
+    close(request.fd);
+}
+
+// Returns the status of the given complete response, 0 if not complete yet.
+int response_status(const std::string &response, bool closed) {
+    size_t separator = response.find("\r\n\r\n");
+    if (separator == std::string::npos) {
+        return closed ? -1 : 0;
+    }
+    int status = 0;
+    if (sscanf(response.c_str(), "HTTP/%*s %d", &status) != 1) {
+        return -1;
+    }
+    std::string head = response.substr(0, separator);
+    for (char &c : head) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    size_t length = head.find("\r\ncontent-length:");
+    if (length != std::string::npos &&
+        response.size() < separator + 4 + strtoul(head.c_str() + length + 17, NULL, 10)) {
+        return closed ? -1 : 0;
+    }
+    return status;
+}
+
+// Handles the given events of the given request. Returns false if the request ended.
+bool handle(request_t &request, short events, uint64_t now) {
+    if (events & POLLOUT) {
+        ssize_t n = send(request.fd, request.request.data() + request.sent,
+            request.request.size() - request.sent, MSG_NOSIGNAL);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            end(request, -1, now);
+            return false;
+        }
+        request.sent += std::max<ssize_t>(n, 0);
+        return true;
+    }
+    char buffer[1024];
+    ssize_t n = recv(request.fd, buffer, sizeof(buffer), 0);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;
+    }
+    if (n > 0) {
+        request.response.append(buffer, n);
+    }
+    int status = response_status(request.response, n <= 0);
+    if (status == 0) {
+        return true;
+    }
+    end(request, status, now);
+    return false;
+}
+
+void interrupt(int signal) {
+    interrupted = 1;
+}
+
+void usage(const char *program) {
+    fprintf(stderr, "Usage: %s [-s host[:port]] [-n stations] [-i seconds] [-t seconds] "
+        "[-x speedup] [-c connections] [-b readings] [-u] [-r seconds] [-v]\n", program);
+}
+
+}
+
+int main(int argc, char **argv) {
+    int option;
+    while ((option = getopt(argc, argv, "s:n:i:t:x:c:b:ur:v")) != -1) {
+        switch (option) {
+        case 's': {
+            options.host = optarg;
+            size_t colon = options.host.find(':');
+            if (colon != std::string::npos) {
+                options.port = atoi(options.host.c_str() + colon + 1);
+                options.host.erase(colon);
+            }
+            break;
+        }
+        case 'n': options.stations = atoi(optarg); break;
+        case 'i': options.interval_s = std::max(1, atoi(optarg)); break;
+        case 't': options.duration_s = atoi(optarg); break;
+        case 'x': options.speedup = std::max(0.001, atof(optarg)); break;
+        case 'c': options.connections = std::max(1, atoi(optarg)); break;
+        case 'b': options.readings = std::max(1, atoi(optarg)); break;
+        case 'u': options.compressed = false; break;
+        case 'r': options.report_s = atoi(optarg); break;
+        case 'v': options.verbose = true; break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    std::string port = std::to_string(options.port);
+    if (getaddrinfo(options.host.c_str(), port.c_str(), &hints, &server_address) != 0) {
+        fprintf(stderr, "Unknown server: %s\n", options.host.c_str());
+        return 1;
+    }
+
+    // the transports run on the virtual hardware, which answers all requests by capture
+    native::model.serial_echo = false;
+    native::model.responder = capture;
+    native::power_on(NULL);
+    WiFi.begin("fleet", "fleet");
+    WiFi.waitForConnectResult();
+    Network network("fleet");
+
+    signal(SIGINT, interrupt);
+    signal(SIGTERM, interrupt);
+    srand(1);
+
+    start_us = monotonic_us();
+    start_unixtime = time(NULL);
+    stations.resize(options.stations);
+    for (uint32_t i = 0; i < options.stations; i++) {
+        station_t &station = stations[i];
+        station.id = "ESP" + std::to_string(10000000 + i);
+        station.transport.reset(new Transport(options.host.c_str(), options.port,
+            TRANSPORT_DATABASE.c_str(), station.id.c_str(), PROBE_LOCATION.c_str()
+        ));
+        station.transport->begin(&network, options.compressed);
+        #if defined(ALIGN_ON)
+        station.phase_s = Memory::checksum(station.id.c_str(), station.id.length()) % ALIGN_SPREAD;
+        station.phase_s %= options.interval_s;
+        #else
+        station.phase_s = rand() % options.interval_s;
+        #endif
+        station.batch_offset = rand() % options.readings;
+        station.temperature_offset = uniform(-2, 2);
+        station.wakes = 0;
+        schedule_next(i, start_unixtime);
+    }
+
+    uint64_t interval_start = start_us;
+    std::vector<struct pollfd> fds;
+    while (!interrupted) {
+        uint64_t now = monotonic_us();
+        if (now - start_us >= options.duration_s * 1000000ULL) {
+            break;
+        }
+        if (options.report_s > 0 && now - interval_start >= options.report_s * 1000000ULL) {
+            print_interval((now - interval_start) / 1e6);
+            interval_start = now;
+        }
+        while (!schedule.empty() && schedule.top().due_us <= now &&
+            active.size() < options.connections) {
+            due_t due = schedule.top();
+            schedule.pop();
+            start(due, now);
+            schedule_next(due.station, station_time(due.due_us));
+        }
+
+        fds.clear();
+        for (auto &entry : active) {
+            request_t &request = entry.second;
+            if (now - request.start_us > RESPONSE_TIMEOUT_US) {
+                end(request, 0, now);
+                request.fd = -1;
+                continue;
+            }
+            short events = request.sent < request.request.size() ? POLLOUT : POLLIN;
+            fds.push_back({ entry.first, events, 0 });
+        }
+        for (auto it = active.begin(); it != active.end(); ) {
+            it = it->second.fd < 0 ? active.erase(it) : std::next(it);
+        }
+        int timeout_ms = 100;
+        if (!schedule.empty() && active.size() < options.connections) {
+            timeout_ms = std::min<int64_t>(timeout_ms,
+                schedule.top().due_us > now ? (schedule.top().due_us - now + 999) / 1000 : 0
+            );
+        }
+        if (poll(fds.data(), fds.size(), timeout_ms) < 0) {
+            continue;
+        }
+        now = monotonic_us();
+        for (struct pollfd &fd : fds) {
+            if (fd.revents == 0) {
+                continue;
+            }
+            auto found = active.find(fd.fd);
+            if (found != active.end() && !handle(found->second, fd.revents, now)) {
+                active.erase(found);
+            }
+        }
+    }
+
+    // requests still running are not counted
+    for (auto &entry : active) {
+        close(entry.first);
+    }
+    print_report((monotonic_us() - start_us) / 1e6);
+    freeaddrinfo(server_address);
+    return 0;
+}
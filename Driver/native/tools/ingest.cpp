@@ -0,0 +1,475 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Influx.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Stand-in for the InfluxDB server of the stations. Serves /write and /ping like InfluxDB 1.8,
+// validates the line protocol of each request the way InfluxDB does (see Influx.h) and records
+// the latency of each request, from its first byte received to the last byte of the response
+// sent. Delays and server errors can be injected to see how stations cope with a slow or failing
+// server. Handles many connections at once in a single thread, so it can take the load of a
+// fleet of stations (see fleet.cpp).
+//
+// Statistics are printed every few seconds and at the end as key=value lines.
+//
+// Usage: ingest [-p port] [-d database] [-l delay] [-j jitter] [-e rate] [-x status] [-t seconds]
+//               [-i seconds] [-o file] [-v]
+//   -p  port to listen on (default 18086, the port of the transport)
+//   -d  database to accept (default is any database)
+//   -l  delay of each response in milliseconds
+//   -j  random additional delay of each response of up to the given milliseconds
+//   -e  probability of a request failing with a server error (0 to 1)
+//   -x  status code of failing requests (default 500)
+//   -t  seconds to run (default is until interrupted)
+//   -i  seconds between statistics (default 10, 0 for none)
+//   -o  file to append a record of each request to (tab separated: time in seconds, peer,
+//       user agent, status, lines, points, body bytes, text bytes, latency in milliseconds)
+//   -v  print a line for each request and the errors of failed requests
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace influx = native::influx;
+
+namespace {
+
+struct {
+    uint16_t port = 18086;
+    std::string database;
+    uint32_t delay_ms = 0;
+    uint32_t jitter_ms = 0;
+    float error_rate = 0;
+    int error_status = 500;
+    uint32_t duration_s = 0;
+    uint32_t interval_s = 10;
+    FILE *records = NULL;
+    bool verbose = false;
+} options;
+
+typedef struct {
+    int fd;
+    std::string peer;
+    std::string in;                    // received data not handled yet
+    std::string out;                   // response being sent
+    size_t out_index;
+    bool waiting;                      // response of the current request is delayed
+    bool receiving;                    // first byte of the current request was received
+    uint64_t first_byte_us;
+    bool close_after;                  // connection is closed after the response
+    influx::write_t result;
+} connection_t;
+
+// Delayed response, due at the given time.
+typedef struct {
+    uint64_t due_us;
+    uint64_t id;
+} delayed_t;
+
+struct later {
+    bool operator()(const delayed_t &a, const delayed_t &b) const { return a.due_us > b.due_us; }
+};
+
+typedef struct {
+    uint64_t requests;
+    uint64_t lines;
+    uint64_t points;
+    uint64_t body_bytes;
+    uint64_t text_bytes;
+    std::map<int, uint64_t> statuses;
+    std::vector<uint32_t> latencies;   // µs
+} statistics_t;
+
+std::map<uint64_t, connection_t> connections;
+std::priority_queue<delayed_t, std::vector<delayed_t>, later> delayed;
+influx::Schema schema;
+
+statistics_t total;
+statistics_t interval;
+std::set<std::string> loggers;
+size_t max_connections = 0;
+
+volatile sig_atomic_t interrupted = 0;
+
+uint64_t monotonic_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+// Returns the given percentile of the given latencies in milliseconds.
+double percentile(std::vector<uint32_t> &latencies, double percent) {
+    if (latencies.empty()) {
+        return 0;
+    }
+    size_t index = std::min(latencies.size() - 1, static_cast<size_t>(latencies.size() * percent / 100));
+    std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+    return latencies[index] / 1000.0;
+}
+
+void record(statistics_t &statistics, const connection_t &connection, uint32_t latency_us) {
+    statistics.requests++;
+    statistics.lines += connection.result.lines;
+    statistics.points += connection.result.points.size();
+    statistics.body_bytes += connection.result.body_size;
+    statistics.text_bytes += connection.result.text_size;
+    statistics.statuses[connection.result.status]++;
+    statistics.latencies.push_back(latency_us);
+}
+
+uint64_t count_status(const statistics_t &statistics, int from, int to) {
+    uint64_t count = 0;
+    for (const auto &status : statistics.statuses) {
+        if (status.first >= from && status.first < to) {
+            count += status.second;
+        }
+    }
+    return count;
+}
+
+void print_interval(double seconds) {
+    printf("requests=%llu rps=%.1f points=%llu pps=%.1f 2xx=%llu 4xx=%llu 5xx=%llu "
+        "p50_ms=%.1f p99_ms=%.1f connections=%zu\n",
+        (unsigned long long) interval.requests, interval.requests / seconds,
+        (unsigned long long) interval.points, interval.points / seconds,
+        (unsigned long long) count_status(interval, 200, 300),
+        (unsigned long long) count_status(interval, 400, 500),
+        (unsigned long long) count_status(interval, 500, 600),
+        percentile(interval.latencies, 50), percentile(interval.latencies, 99),
+        connections.size()
+    );
+    fflush(stdout);
+    interval = statistics_t();
+}
+
+void print_report(double seconds) {
+    printf("seconds=%.1f\n", seconds);
+    printf("requests=%llu\n", (unsigned long long) total.requests);
+    printf("requests_per_s=%.2f\n", total.requests / seconds);
+    printf("lines=%llu\n", (unsigned long long) total.lines);
+    printf("points=%llu\n", (unsigned long long) total.points);
+    printf("points_per_s=%.2f\n", total.points / seconds);
+    printf("body_bytes=%llu\n", (unsigned long long) total.body_bytes);
+    printf("text_bytes=%llu\n", (unsigned long long) total.text_bytes);
+    for (const auto &status : total.statuses) {
+        printf("status_%d=%llu\n", status.first, (unsigned long long) status.second);
+    }
+    printf("loggers=%zu\n", loggers.size());
+    printf("max_connections=%zu\n", max_connections);
+    printf("latency_p50_ms=%.2f\n", percentile(total.latencies, 50));
+    printf("latency_p90_ms=%.2f\n", percentile(total.latencies, 90));
+    printf("latency_p99_ms=%.2f\n", percentile(total.latencies, 99));
+    printf("latency_max_ms=%.2f\n", percentile(total.latencies, 100));
+}
+
+void close_connection(uint64_t id) {
+    close(connections[id].fd);
+    connections.erase(id);
+}
+
+// Handles the next request of the given connection if it is complete. Returns false if the
+// request is malformed.
+bool handle_request(uint64_t id, connection_t &connection) {
+    long size = influx::request_size(connection.in);
+    if (size < 0) {
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+    std::string request = connection.in.substr(0, size);
+    connection.in.erase(0, size);
+
+    size_t head_end = request.find("\r\n\r\n");
+    std::string head = request.substr(0, head_end);
+    for (char &c : head) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    connection.close_after = head.find("\r\nconnection: close") != std::string::npos;
+
+    if (static_cast<float>(rand()) / RAND_MAX < options.error_rate) {
+        connection.result = influx::write_t();
+        connection.result.status = options.error_status;
+        connection.result.error = "injected failure";
+    }
+    else {
+        connection.result = influx::handle(request, options.database);
+        schema.admit(connection.result);
+    }
+    for (const influx::point_t &point : connection.result.points) {
+        for (const auto &tag : point.tags) {
+            if (tag.first == "logger") {
+                loggers.insert(tag.second);
+            }
+        }
+    }
+
+    uint32_t delay_ms = options.delay_ms;
+    if (options.jitter_ms > 0) {
+        delay_ms += rand() % (options.jitter_ms + 1);
+    }
+    connection.waiting = true;
+    delayed.push({ monotonic_us() + delay_ms * 1000ULL, id });
+    return true;
+}
+
+// Starts sending the response of the given connection.
+void respond(connection_t &connection) {
+    connection.waiting = false;
+    connection.out = influx::response(connection.result, time(NULL));
+    connection.out_index = 0;
+}
+
+// Finishes the current request of the given connection after its response was sent.
+void finish(connection_t &connection) {
+    uint64_t now = monotonic_us();
+    uint32_t latency_us = static_cast<uint32_t>(now - connection.first_byte_us);
+    record(total, connection, latency_us);
+    record(interval, connection, latency_us);
+    const influx::write_t &result = connection.result;
+    if (options.records != NULL) {
+        struct timespec wallclock;
+        clock_gettime(CLOCK_REALTIME, &wallclock);
+        fprintf(options.records, "%.3f\t%s\t%s\t%d\t%u\t%zu\t%zu\t%zu\t%.3f\n",
+            wallclock.tv_sec + wallclock.tv_nsec / 1e9, connection.peer.c_str(),
+            result.user_agent.c_str(), result.status, result.lines, result.points.size(),
+            result.body_size, result.text_size, latency_us / 1000.0
+        );
+    }
+    if (options.verbose) {
+        printf("%s %s status=%d lines=%u points=%zu bytes=%zu latency_ms=%.1f\n",
+            connection.peer.c_str(), result.user_agent.c_str(), result.status, result.lines,
+            result.points.size(), result.body_size, latency_us / 1000.0
+        );
+        size_t start = 0;
+        while (start < result.error.size()) {
+            size_t end = std::min(result.error.find('\n', start), result.error.size());
+            printf("  %s\n", result.error.substr(start, end - start).c_str());
+            start = end + 1;
+        }
+    }
+    connection.out.clear();
+    connection.receiving = !connection.in.empty();
+    connection.first_byte_us = now;
+}
+
+int listen_on(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+void accept_connections(int listener, uint64_t &next_id) {
+    for (;;) {
+        struct sockaddr_in address;
+        socklen_t length = sizeof(address);
+        int fd = accept(listener, reinterpret_cast<struct sockaddr *>(&address), &length);
+        if (fd < 0) {
+            return;
+        }
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        char peer[INET_ADDRSTRLEN + 8];
+        inet_ntop(AF_INET, &address.sin_addr, peer, INET_ADDRSTRLEN);
+        snprintf(peer + strlen(peer), 8, ":%u", ntohs(address.sin_port));
+        connection_t &connection = connections[next_id++];
+        connection.fd = fd;
+        connection.peer = peer;
+        connection.out_index = 0;
+        connection.waiting = false;
+        connection.receiving = false;
+        connection.first_byte_us = 0;
+        connection.close_after = false;
+        max_connections = std::max(max_connections, connections.size());
+    }
+}
+
+// Receives data of the given connection. Returns false if the connection is to be closed.
+bool receive(uint64_t id, connection_t &connection) {
+    char buffer[4096];
+    ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        return false;
+    }
+    if (n < 0) {
+        return true;
+    }
+    if (!connection.receiving) {
+        connection.receiving = true;
+        connection.first_byte_us = monotonic_us();
+    }
+    connection.in.append(buffer, n);
+    if (!connection.waiting && connection.out.empty()) {
+        return handle_request(id, connection);
+    }
+    return true;
+}
+
+// Sends the pending response of the given connection. Returns false if the connection is to be
+// closed.
+bool transmit(uint64_t id, connection_t &connection) {
+    ssize_t n = send(connection.fd, connection.out.data() + connection.out_index,
+        connection.out.size() - connection.out_index, MSG_NOSIGNAL);
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    connection.out_index += n;
+    if (connection.out_index < connection.out.size()) {
+        return true;
+    }
+    finish(connection);
+    if (connection.close_after) {
+        return false;
+    }
+    // requests may be pipelined
+    return handle_request(id, connection);
+}
+
+void interrupt(int signal) {
+    interrupted = 1;
+}
+
+void usage(const char *program) {
+    fprintf(stderr, "Usage: %s [-p port] [-d database] [-l delay] [-j jitter] [-e rate] "
+        "[-x status] [-t seconds] [-i seconds] [-o file] [-v]\n", program);
+}
+
+}
+
+int main(int argc, char **argv) {
+    int option;
+    while ((option = getopt(argc, argv, "p:d:l:j:e:x:t:i:o:v")) != -1) {
+        switch (option) {
+        case 'p': options.port = atoi(optarg); break;
+        case 'd': options.database = optarg; break;
+        case 'l': options.delay_ms = atoi(optarg); break;
+        case 'j': options.jitter_ms = atoi(optarg); break;
+        case 'e': options.error_rate = atof(optarg); break;
+        case 'x': options.error_status = atoi(optarg); break;
+        case 't': options.duration_s = atoi(optarg); break;
+        case 'i': options.interval_s = atoi(optarg); break;
+        case 'o':
+            options.records = fopen(optarg, "a");
+            if (options.records == NULL) {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'v': options.verbose = true; break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    int listener = listen_on(options.port);
+    if (listener < 0) {
+        perror("listen");
+        return 1;
+    }
+    signal(SIGINT, interrupt);
+    signal(SIGTERM, interrupt);
+    fprintf(stderr, "Listening on port %u\n", options.port);
+
+    uint64_t next_id = 1;
+    uint64_t start = monotonic_us();
+    uint64_t interval_start = start;
+    std::vector<struct pollfd> fds;
+    std::vector<uint64_t> ids;
+    while (!interrupted) {
+        uint64_t now = monotonic_us();
+        if (options.duration_s > 0 && now - start >= options.duration_s * 1000000ULL) {
+            break;
+        }
+        if (options.interval_s > 0 && now - interval_start >= options.interval_s * 1000000ULL) {
+            print_interval((now - interval_start) / 1e6);
+            interval_start = now;
+        }
+        while (!delayed.empty() && delayed.top().due_us <= now) {
+            auto found = connections.find(delayed.top().id);
+            if (found != connections.end()) {
+                respond(found->second);
+            }
+            delayed.pop();
+        }
+
+        fds.clear();
+        ids.clear();
+        fds.push_back({ listener, POLLIN, 0 });
+        ids.push_back(0);
+        for (auto &entry : connections) {
+            short events = 0;
+            if (!entry.second.out.empty()) {
+                events = POLLOUT;
+            }
+            else if (!entry.second.waiting) {
+                events = POLLIN;
+            }
+            fds.push_back({ entry.second.fd, events, 0 });
+            ids.push_back(entry.first);
+        }
+        int timeout_ms = 100;
+        if (!delayed.empty()) {
+            timeout_ms = std::min<int64_t>(timeout_ms, (delayed.top().due_us - now + 999) / 1000);
+        }
+        if (poll(fds.data(), fds.size(), timeout_ms) < 0) {
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            accept_connections(listener, next_id);
+        }
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            connection_t &connection = connections[ids[i]];
+            bool open = true;
+            if (fds[i].revents & POLLOUT) {
+                open = transmit(ids[i], connection);
+            }
+            else if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                open = receive(ids[i], connection);
+            }
+            if (!open) {
+                close_connection(ids[i]);
+            }
+        }
+    }
+
+    print_report((monotonic_us() - start) / 1e6);
+    if (options.records != NULL) {
+        fclose(options.records);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <Arduino.h>
+
+#include "Acquisition.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Acquisition::Acquisition(void) {
+    this->count = 0;
+    this->started_millis = 0;
+}
+
+bool Acquisition::add(start_function start, ready_function ready, unsigned long max_millis) {
+    if (count >= SENSORS_MAX) {
+        return false;
+    }
+    sensors[count].start = start;
+    sensors[count].ready = ready;
+    sensors[count].max_millis = max_millis;
+    sensors[count].done = false;
+    count++;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Acquisition::start(void) {
+    started_millis = millis();
+    for (int i = 0; i < count; i++) {
+        sensors[i].done = false;
+        if (sensors[i].start != NULL) {
+            sensors[i].start();
+        }
+    }
+}
+
+bool Acquisition::wait(void) {
+    bool timeout = false;
+    bool done;
+    do {
+        done = true;
+        unsigned long elapsed = millis() - started_millis;
+        for (int i = 0; i < count; i++) {
+            if (sensors[i].done) {
+                continue;
+            }
+            if (sensors[i].ready != NULL && sensors[i].ready()) {
+                sensors[i].done = true;
+            }
+            else if (elapsed >= sensors[i].max_millis) {
+                // a sensor without ready function is expected to run into its maximum time
+                timeout = timeout || (sensors[i].ready != NULL);
+                sensors[i].done = true;
+            }
+            else {
+                done = false;
+            }
+        }
+        if (!done) {
+            // do not flood the bus with status requests
+            delay(1);
+        }
+    }
+    while (!done);
+    return !timeout;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,50 @@
+#ifndef __ACQUISITION_H__
+#define __ACQUISITION_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to acquire sensor readings in two phases. First the conversions of all sensors get
+// started, then the acquisition waits once until the slowest sensor is ready. Sensors are polled
+// for readiness instead of waiting fixed times for each of them. So, the time needed is the time
+// of the slowest conversion, not the sum of all conversions.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Acquisition {
+public:
+    // Function to start the conversion of a sensor.
+    typedef void (*start_function)(void);
+    // Function to check if the conversion of a sensor is complete.
+    typedef bool (*ready_function)(void);
+
+    Acquisition(void);
+
+    // Adds a sensor with the given functions to start and to poll its conversion. A sensor is
+    // considered ready after the given maximum conversion time in any case. Both functions are
+    // optional. Without a ready function a sensor is ready after the maximum conversion time.
+    bool add(start_function start, ready_function ready, unsigned long max_millis);
+
+    // Starts the conversions of all sensors.
+    void start(void);
+
+    // Waits until the conversions of all sensors are ready. Returns false if any sensor exceeded
+    // its maximum conversion time.
+    bool wait(void);
+
+private:
+    static const int SENSORS_MAX = 8;
+
+    struct {
+        start_function start;
+        ready_function ready;
+        unsigned long max_millis;
+        bool done;
+    } sensors[SENSORS_MAX];
+
+    int count;
+
+    unsigned long started_millis;
+};
+
+#endif
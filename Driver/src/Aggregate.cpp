@@ -0,0 +1,116 @@
+#include <Arduino.h>
+
+#include "Aggregate.h"
+
+#include "Readings.h"
+#include "Memory.h"
+
+extern Memory memory;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define AGGREGATE_TYPES (Readings::READING_TYPE_MAX + 1)
+
+// Statistics of one window. Minimum and maximum are kept packed like readings, mean and sum of
+// squared differences from the mean are updated with every value.
+typedef struct {
+    uint32_t start; // seconds since 1970-01-01, 0 if not known
+    uint16_t cycles;
+    uint16_t counts[AGGREGATE_TYPES];
+    int16_t mins[AGGREGATE_TYPES];
+    int16_t maxs[AGGREGATE_TYPES];
+    float means[AGGREGATE_TYPES];
+    float squares[AGGREGATE_TYPES];
+} aggregate_t;
+
+static_assert(sizeof(aggregate_t) <= MEMORY_BATCH_SIZE, "Aggregate block too small");
+
+static aggregate_t aggregate;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Aggregate::Aggregate(uint32_t window) {
+    this->window = std::max(window, (uint32_t) 1);
+}
+
+bool Aggregate::begin(void) {
+    if (!memory.load(Memory::aggregate, &aggregate, sizeof(aggregate))) {
+        memset(&aggregate, 0, sizeof(aggregate));
+    }
+    return true;
+}
+
+void Aggregate::add(Readings &readings, uint32_t unixtime) {
+    if (aggregate.cycles == 0) {
+        aggregate.start = unixtime - unixtime % window;
+    }
+    if (aggregate.cycles < UINT16_MAX) {
+        aggregate.cycles++;
+    }
+    int16_t packed[AGGREGATE_TYPES];
+    readings.pack(packed);
+    for (int i = 0; i < AGGREGATE_TYPES; i++) {
+        float value = readings.retrieve(static_cast<Readings::reading_type>(i));
+        if (isnan(value) || aggregate.counts[i] == UINT16_MAX) {
+            continue;
+        }
+        uint16_t n = ++aggregate.counts[i];
+        if (n == 1) {
+            aggregate.mins[i] = packed[i];
+            aggregate.maxs[i] = packed[i];
+            aggregate.means[i] = value;
+            aggregate.squares[i] = 0.0;
+            continue;
+        }
+        aggregate.mins[i] = std::min(aggregate.mins[i], packed[i]);
+        aggregate.maxs[i] = std::max(aggregate.maxs[i], packed[i]);
+        float delta = value - aggregate.means[i];
+        aggregate.means[i] += delta / n;
+        aggregate.squares[i] += delta * (value - aggregate.means[i]);
+    }
+    save();
+}
+
+uint16_t Aggregate::count(void) {
+    return aggregate.cycles;
+}
+
+bool Aggregate::isDue(uint32_t unixtime) {
+    if (aggregate.cycles == 0 || unixtime == 0) {
+        return false;
+    }
+    // windows started without time are over as soon as the time is known
+    return aggregate.start == 0
+        || unixtime < aggregate.start || unixtime - aggregate.start >= window;
+}
+
+uint32_t Aggregate::start(void) {
+    return aggregate.start;
+}
+
+bool Aggregate::get(Readings::reading_type type, uint16_t &n, float &mean, float &min,
+    float &max, float &stddev)
+{
+    n = aggregate.counts[type];
+    if (n == 0) {
+        return false;
+    }
+    // minimum and maximum are unpacked like readings, their rounding must not cross the mean
+    mean = aggregate.means[type];
+    Readings readings;
+    readings.unpack(aggregate.mins);
+    min = std::min(readings.retrieve(type), mean);
+    readings.unpack(aggregate.maxs);
+    max = std::max(readings.retrieve(type), mean);
+    stddev = n > 1 ? sqrtf(std::max(aggregate.squares[type], 0.0f) / (n - 1)) : 0.0;
+    return true;
+}
+
+void Aggregate::clear(void) {
+    memset(&aggregate, 0, sizeof(aggregate));
+    save();
+}
+
+void Aggregate::save(void) {
+    memory.save(Memory::aggregate, &aggregate, sizeof(aggregate));
+}
@@ -0,0 +1,57 @@
+#ifndef __AGGREGATE_H__
+#define __AGGREGATE_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to keep statistics of sensor readings over windows of time in RTC memory, so one point
+// per window can be sent instead of the readings of every measuring cycle. For every reading type
+// the number of values, minimum, maximum, mean and variance are accumulated with each measuring
+// cycle (using Welford’s algorithm, no values are kept).
+//
+// Windows are aligned to the wall-clock (multiples of the window duration since 1970-01-01). A
+// window is over with the first measuring cycle in a later window. Until it is cleared after
+// sending, readings are added to the window which is over, too.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Readings.h"
+
+class Aggregate {
+public:
+    // Constructs an aggregate of windows of the given duration in seconds.
+    Aggregate(uint32_t window);
+
+    // Begin managing the aggregate. Loads the statistics kept in RTC memory.
+    // Must be called before any other method.
+    bool begin(void);
+
+    // Adds the given readings taken at the given time (seconds since 1970-01-01, 0 if not known)
+    // to the statistics of the current window.
+    void add(Readings &readings, uint32_t unixtime);
+
+    // Returns the number of measuring cycles added to the current window.
+    uint16_t count(void);
+
+    // Checks if the current window is over at the given time (seconds since 1970-01-01).
+    bool isDue(uint32_t unixtime);
+
+    // Returns the start of the current window (seconds since 1970-01-01), 0 if not known.
+    uint32_t start(void);
+
+    // Gives the statistics of the values of the given reading type in the current window. The
+    // standard deviation is that of a sample (0 for a single value). Returns false if there are
+    // no values of this type.
+    bool get(Readings::reading_type type, uint16_t &n, float &mean, float &min, float &max,
+        float &stddev);
+
+    // Removes all statistics, the next readings start a new window.
+    void clear(void);
+
+private:
+    uint32_t window;
+
+    void save(void);
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include <Arduino.h>
+
+#include "Batch.h"
+
+#include "Readings.h"
+#include "Memory.h"
+
+extern Memory memory;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// A record holds the packed readings of one measuring cycle.
+typedef struct {
+    uint32_t time; // device time in milliseconds
+    int16_t values[Readings::READING_TYPE_MAX + 1];
+    uint16_t reserved;
+} batch_record_t;
+
+typedef struct {
+    uint32_t time; // device time in milliseconds
+    uint8_t head; // index of oldest record
+    uint8_t count;
+    uint16_t reserved;
+    batch_record_t records[BATCH_CAPACITY];
+} batch_t;
+
+static_assert(sizeof(batch_t) <= MEMORY_BATCH_SIZE, "Batch block too small");
+
+static batch_t batch;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Batch::Batch(uint8_t cycles) {
+    this->cycles = constrain(cycles, 1, BATCH_CAPACITY);
+    this->last_millis = 0;
+}
+
+bool Batch::begin(void) {
+    last_millis = millis();
+    if (!memory.load(Memory::batch, &batch, sizeof(batch))) {
+        memset(&batch, 0, sizeof(batch));
+    }
+    return true;
+}
+
+void Batch::add(Readings &readings) {
+    uint8_t index;
+    if (batch.count < BATCH_CAPACITY) {
+        index = (batch.head + batch.count) % BATCH_CAPACITY;
+        batch.count++;
+    }
+    else {
+        // drop oldest record
+        index = batch.head;
+        batch.head = (batch.head + 1) % BATCH_CAPACITY;
+    }
+    batch_record_t &record = batch.records[index];
+    record.time = now();
+    readings.pack(record.values);
+    record.reserved = 0;
+    save();
+}
+
+uint8_t Batch::count(void) {
+    return batch.count;
+}
+
+bool Batch::isDue(uint8_t additional) {
+    return batch.count + additional >= cycles;
+}
+
+bool Batch::get(uint8_t index, Readings &readings, unsigned long &age) {
+    if (index >= batch.count) {
+        return false;
+    }
+    batch_record_t &record = batch.records[(batch.head + index) % BATCH_CAPACITY];
+    readings.unpack(record.values);
+    age = (now() - record.time) / 1000;
+    return true;
+}
+
+void Batch::clear(void) {
+    batch.head = 0;
+    batch.count = 0;
+    save();
+}
+
+void Batch::elapse(unsigned long sleep_millis) {
+    batch.time = now() + sleep_millis;
+    // when delaying instead of deep sleep, millis will have advanced by the sleep duration
+    last_millis = millis() + sleep_millis;
+    save();
+}
+
+uint32_t Batch::now(void) {
+    return batch.time + (millis() - last_millis);
+}
+
+void Batch::save(void) {
+    memory.save(Memory::batch, &batch, sizeof(batch));
+}
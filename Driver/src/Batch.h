@@ -0,0 +1,60 @@
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to keep sensor readings of several measuring cycles in RTC memory, so they can be sent
+// to a server in one go. Readings are stored as compact records in a ring buffer, which will
+// drop the oldest record if full.
+//
+// Records are timestamped with a device time, which is the sum of all awake and sleep durations
+// (see elapse). This is converted into a real time when sending the records.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Readings.h"
+
+// Number of records in RTC memory.
+#define BATCH_CAPACITY 6
+
+class Batch {
+public:
+    // Constructs a batch which is due for sending after the given number of measuring cycles.
+    Batch(uint8_t cycles);
+
+    // Begin managing the batch. Loads records kept in RTC memory.
+    // Must be called before any other method.
+    bool begin(void);
+
+    // Adds the given readings as new record. Drops the oldest record if full.
+    void add(Readings &readings);
+
+    // Returns the number of records.
+    uint8_t count(void);
+
+    // Checks if the batch is due for sending after the given number of additional records.
+    bool isDue(uint8_t additional = 0);
+
+    // Restores the readings of the record at the given index (oldest first) and gives the age of
+    // the record in seconds.
+    bool get(uint8_t index, Readings &readings, unsigned long &age);
+
+    // Removes all records.
+    void clear(void);
+
+    // Advances the device time by the time awake and the given sleep duration. To be called
+    // before sleeping.
+    void elapse(unsigned long sleep_millis);
+
+private:
+    uint8_t cycles;
+
+    unsigned long last_millis;
+
+    uint32_t now(void);
+
+    void save(void);
+};
+
+#endif
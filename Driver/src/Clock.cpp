@@ -6,10 +6,14 @@
 #include "Clock.h"
 
 #include "Notification.h"
+#include "Memory.h"
+#include "Profiler.h"
 
 #include "System.h"
 
 extern Notification notification;
+extern Memory memory;
+extern Profiler profiler;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -19,10 +23,39 @@ NTPClient timeClient(timeUDP, "europe.pool.ntp.org");
 
 DateTime pastpresent(__DATE__, __TIME__);
 
+// State of the soft RTC kept in RTC memory across deep sleep.
+typedef struct {
+    uint32_t seconds; // time when going to sleep (seconds since 1970-01-01)
+    uint16_t millis;  // and milliseconds
+    uint16_t calibrations; // number of times the drift was learned
+    uint32_t sleep; // intended sleep duration in milliseconds
+    uint32_t synced; // time of last sync (seconds since 1970-01-01)
+    uint32_t unsynced; // intended sleep durations since last sync in milliseconds
+    float drift; // relative error of the sleep timer: actual = intended * (1 + drift)
+    uint32_t target; // aligned time of next measuring cycle (seconds since 1970-01-01)
+    uint16_t target_millis; // and milliseconds
+    uint16_t lead; // time needed from waking up to start of measuring cycle in milliseconds
+} clock_state_t;
+
+static_assert(sizeof(clock_state_t) <= MEMORY_CLOCK_SIZE, "Clock block too small");
+
+static clock_state_t clock_state;
+
+// Minimum intended sleep duration since last sync to learn the drift from (milliseconds).
+#define CLOCK_DRIFT_SPAN_MIN (30UL * 60 * 1000)
+// Maximum drift of the sleep timer to accept.
+#define CLOCK_DRIFT_MAX 0.1
+// Maximum time needed from waking up to start of measuring cycle in milliseconds.
+#define CLOCK_LEAD_MAX 10000
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 Clock::Clock(clock_type type) {
     this->type = type;
+    this->synced = false;
+    this->known = false;
+    this->epoch = 0;
+    this->epoch_at = 0;
 }
 
 bool Clock::begin(void) {
@@ -32,7 +65,23 @@ bool Clock::begin(void) {
     case real:
         return rtc.begin();
     case soft:
-        rtc0.begin(DateTime(2000,1,1,0,0,0));
+        // restore the time only after deep sleep, the sleep duration is unknown otherwise
+        if (memory.load(Memory::clock, &clock_state, sizeof(clock_state))) {
+            if (System::lastResetReasonIsDeepSleepAwake() && clock_state.seconds > 0) {
+                epoch = (uint64_t) clock_state.seconds * 1000 + clock_state.millis;
+                epoch += (uint64_t) (clock_state.sleep * (1.0 + clock_state.drift));
+                epoch_at = 0; // boot
+                known = true;
+            }
+            else {
+                clock_state.seconds = 0;
+                clock_state.millis = 0;
+                clock_state.target = 0;
+            }
+        }
+        else {
+            memset(&clock_state, 0, sizeof(clock_state));
+        }
         return true;
     case off:
         return true;
@@ -45,19 +94,27 @@ DateTime Clock::now(void) {
     case real:
         return rtc.now();
     case soft:
-        return rtc0.now();
+        return DateTime((uint32_t) (now_millis() / 1000));
     case off:
         return DateTime();
     }
     TERMINATE_FATAL(F("Invalid clock type!"));
 }
 
+uint64_t Clock::now_millis(void) {
+    return epoch + (millis() - epoch_at);
+}
+
 void Clock::adjust(const DateTime& dt) {
     switch (type) {
     case real:
         rtc.adjust(dt);
+        return;
     case soft:
-        rtc0.adjust(dt);
+        epoch = (uint64_t) dt.unixtime() * 1000;
+        epoch_at = millis();
+        known = true;
+        return;
     case off:
         return;
     }
@@ -82,8 +139,32 @@ bool Clock::isIndeterminate(void) {
         }
         return false;
     case soft:
-        // always true for soft rtc
-        return true;
+        return !known;
+    case off:
+        return false;
+    }
+    TERMINATE_FATAL(F("Invalid clock type!"));
+}
+
+bool Clock::isSyncDue(void) {
+    switch (type) {
+    case real:
+        return isIndeterminate();
+    case soft: {
+        if (!known || clock_state.synced == 0) {
+            return true;
+        }
+        // learn the drift as soon as possible
+        if (clock_state.calibrations == 0 && clock_state.unsynced >= CLOCK_DRIFT_SPAN_MIN) {
+            return true;
+        }
+        float error = clock_state.unsynced / 1000.0 * CLOCK_DRIFT_UNCERTAINTY;
+        if (error > CLOCK_ERROR_MAX) {
+            NOTIFICATION_INFO(F("*CLOCK: Estimated error "), String(error));
+            return true;
+        }
+        return now().unixtime() - clock_state.synced > CLOCK_SYNC_HOURS * 3600UL;
+    }
     case off:
         return false;
     }
@@ -91,11 +172,14 @@ bool Clock::isIndeterminate(void) {
 }
 
 void Clock::sync(void) {
+    profiler.start(Profiler::ntp);
     timeClient.begin();
-    if (timeClient.update()) {
+    bool updated = timeClient.update();
+    profiler.stop(Profiler::ntp);
+    if (updated) {
         DateTime datetime = DateTime(timeClient.getEpochTime());
-        adjust(datetime);
-        notification.info(F("Time (NTP): "), formatDateTimeISO8601(datetime));
+        sync(datetime.unixtime(), millis());
+        NOTIFICATION_INFO(F("Time (NTP): "), formatDateTimeISO8601(datetime));
     }
     else {
         notification.warn(F("Failure to sync time!"));
@@ -103,10 +187,91 @@ void Clock::sync(void) {
     timeClient.end();
 }
 
+void Clock::sync(uint32_t unixtime, unsigned long at) {
+    if (type == soft) {
+        // time is truncated to seconds, so expect the middle of the second
+        uint64_t time = (uint64_t) unixtime * 1000 + 500 + (millis() - at);
+        // learn drift of the sleep timer from the error accumulated since last sync
+        if (known && clock_state.unsynced >= CLOCK_DRIFT_SPAN_MIN) {
+            long error = (long) ((int64_t) time - (int64_t) now_millis());
+            float drift = clock_state.drift + (float) error / clock_state.unsynced;
+            clock_state.drift = constrain(drift, -CLOCK_DRIFT_MAX, CLOCK_DRIFT_MAX);
+            if (clock_state.calibrations < UINT16_MAX) {
+                clock_state.calibrations++;
+            }
+            notification.info(F("*CLOCK: Error (ms) "), error);
+        }
+        clock_state.synced = unixtime;
+        clock_state.unsynced = 0;
+        epoch = time;
+        epoch_at = millis();
+        known = true;
+    }
+    else {
+        adjust(DateTime(unixtime));
+    }
+    synced = true;
+}
+
+void Clock::elapse(unsigned long sleep_millis) {
+    if (type != soft) {
+        return;
+    }
+    if (known) {
+        uint64_t time = now_millis();
+        clock_state.seconds = time / 1000;
+        clock_state.millis = time % 1000;
+    }
+    clock_state.sleep = sleep_millis;
+    clock_state.unsynced += sleep_millis;
+    memory.save(Memory::clock, &clock_state, sizeof(clock_state));
+}
+
+unsigned long Clock::align(unsigned long interval, unsigned long phase, unsigned long sleep_min) {
+    if (type != soft || !known || interval == 0) {
+        return 0;
+    }
+    uint64_t time = now_millis();
+    uint64_t earliest = time + sleep_min + clock_state.lead;
+    // boundaries are aligned to midnight, so intervals not dividing a day still line up daily
+    uint64_t midnight = time - time % (24ULL * 3600 * 1000);
+    uint64_t target = midnight + (phase % interval);
+    if (earliest > target) {
+        target += ((earliest - target + interval - 1) / interval) * interval;
+    }
+    clock_state.target = target / 1000;
+    clock_state.target_millis = target % 1000;
+    return target - clock_state.lead - time;
+}
+
+void Clock::mark(void) {
+    if (type != soft || !known || clock_state.target == 0) {
+        return;
+    }
+    uint64_t target = (uint64_t) clock_state.target * 1000 + clock_state.target_millis;
+    long error = (long) ((int64_t) now_millis() - (int64_t) target);
+    clock_state.target = 0;
+    clock_state.target_millis = 0;
+    // ignore missed cycles
+    if (labs(error) > CLOCK_LEAD_MAX) {
+        return;
+    }
+    long lead = clock_state.lead + error / 2;
+    clock_state.lead = constrain(lead, 0L, (long) CLOCK_LEAD_MAX);
+    notification.info(F("*CLOCK: Aligned cycle error (ms) "), error);
+}
+
 String Clock::formatISO8601() {
     return formatDateTimeISO8601(now());
 }
 
+uint32_t Clock::unixtime(void) {
+    if (!isRunning() || (isIndeterminate() && !synced)) {
+        return 0;
+    }
+    return now().unixtime();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 String formatDateTimeISO8601(DateTime dt) {
@@ -7,10 +7,24 @@
 // Operating Support:
 // Class to manage access to a Real-time Clock module.
 // Supports DS3231 hardware clock and software RTC based on millis().
+//
+// The software RTC is kept across deep sleep in RTC memory: the time is advanced by the intended
+// sleep duration, corrected by the drift of the sleep timer, which is learned from NTP syncs.
+// Syncing is only due if the estimated error exceeds CLOCK_ERROR_MAX or after CLOCK_SYNC_HOURS.
+//
+// Sleeping may be aligned to the wall-clock (see align), the time from waking up to the start of
+// the measuring cycle is learned from the error of previous cycles (see mark).
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <RTClib.h>
 
+// Maximum estimated error of the software RTC in seconds before syncing is due.
+#define CLOCK_ERROR_MAX 10
+// Maximum time between syncs in hours.
+#define CLOCK_SYNC_HOURS 12
+// Uncertainty of the sleep timer after correcting its drift (relative to sleep duration).
+#define CLOCK_DRIFT_UNCERTAINTY 0.002
+
 class Clock {
 public:
     enum clock_type {
@@ -30,19 +44,46 @@ public:
     // Checks if the clock is in an indeterminate state. You could call sync then.
     bool isIndeterminate(void);
 
+    // Checks if the clock is running and should be synced.
+    bool isSyncDue(void);
     // Syncs the clock with a NTP server. Needs an active WiFi connection.
     void sync(void);
+    // Syncs the clock with the given time (seconds since 1970-01-01) taken at the given millis(),
+    // for example the time given by a server with a response.
+    void sync(uint32_t unixtime, unsigned long at);
+
+    // Keeps the time in RTC memory to be advanced by the given sleep duration. To be called
+    // before deep sleep.
+    void elapse(unsigned long sleep_millis);
+
+    // Returns the sleep duration, so the next measuring cycle starts at the next multiple of
+    // the given interval (since midnight) plus the given phase, at least the given minimum sleep
+    // duration from now (milliseconds). Returns 0 if the time is not known.
+    unsigned long align(unsigned long interval, unsigned long phase, unsigned long sleep_min);
+    // Marks the start of a measuring cycle. Learns the time needed to start a measuring cycle
+    // from the error to the aligned time.
+    void mark(void);
 
     // Returns the current time as ISO8601 formatted string.
     String formatISO8601(void);
 
+    // Returns the current time as seconds since 1970-01-01 or 0 if the time is not known.
+    uint32_t unixtime(void);
+
 private:
     clock_type type;
 
-    RTC_Millis rtc0; // soft RTC
+    bool synced; // true after successful sync
+
+    // soft RTC: time in milliseconds since 1970-01-01 at millis() == epoch_at
+    bool known;
+    uint64_t epoch;
+    unsigned long epoch_at;
+
     RTC_DS3231 rtc;  // real RTC
 
     DateTime now(void);
+    uint64_t now_millis(void);
 
     void adjust(const DateTime& dt);
 };
@@ -0,0 +1,215 @@
+#include <Arduino.h>
+
+#include "DS18B20Probes.h"
+
+#include "Files.h"
+#include "Memory.h"
+#include "Notification.h"
+#include "System.h"
+
+extern Notification notification;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define DS18B20_CACHE_FILE "ds18b20"
+
+// Maximum number of probes taken from a search of the bus.
+#define DS18B20_SEARCH_MAX 8
+
+// The cache holds the probes of all slots.
+typedef struct {
+    uint8_t addresses[DS18B20_PROBES_MAX][8]; // ROM addresses, family code 0 if slot is free
+    uint8_t resolutions[DS18B20_PROBES_MAX]; // resolutions written to the probes
+    uint8_t stale; // a probe did not respond, search the bus
+    uint32_t checksum; // of all preceding fields
+} ds18b20_cache_t;
+
+#define DS18B20_CACHE_CHECKSUM_SIZE (sizeof(ds18b20_cache_t) - sizeof(uint32_t))
+
+static ds18b20_cache_t cache;
+
+static bool slot_used(uint8_t slot) {
+    return cache.addresses[slot][0] != 0;
+}
+
+static int slot_of(const uint8_t *address) {
+    for (uint8_t slot = 0; slot < DS18B20_PROBES_MAX; slot++) {
+        if (memcmp(cache.addresses[slot], address, 8) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+DS18B20Probes::DS18B20Probes(DallasTemperature *sensors) {
+    this->sensors = sensors;
+    this->files = NULL;
+    this->count = 0;
+    for (uint8_t slot = 0; slot < DS18B20_PROBES_MAX; slot++) {
+        configure(slot, 12, 0.01, 100.0);
+    }
+}
+
+void DS18B20Probes::configure(uint8_t slot, uint8_t resolution, float calibration_lo,
+    float calibration_hi) {
+    if (slot >= DS18B20_PROBES_MAX) {
+        return;
+    }
+    resolutions[slot] = constrain(resolution, 9, 12);
+    calibrations_lo[slot] = calibration_lo;
+    calibrations_hi[slot] = calibration_hi;
+}
+
+bool DS18B20Probes::begin(uint8_t count, Files *files) {
+    this->count = std::min(count, (uint8_t) DS18B20_PROBES_MAX);
+    this->files = files;
+
+    // conversion is polled by the acquisition, do not block when requesting temperatures
+    sensors->setWaitForConversion(false);
+
+    bool changed = false;
+    bool searched = false;
+    if (!load() || cache.stale) {
+        search();
+        changed = searched = true;
+    } else {
+        #if defined(ESP8266) || defined(ESP32)
+        // a probe may have been attached while powered down
+        bool free = false;
+        for (uint8_t slot = 0; slot < this->count; slot++) {
+            free = free || !slot_used(slot);
+        }
+        if (free && !System::lastResetReasonIsDeepSleepAwake()) {
+            search();
+            changed = searched = true;
+        }
+        #endif
+    }
+
+    // the library detects probes powered by the data line only when searching the bus, and
+    // pulls the bus up strongly while converting only then, so search if any probe needs it
+    if (!searched && sensors->readPowerSupply()) {
+        sensors->begin();
+    }
+
+    // the resolution is kept in the EEPROM of a probe, only write it if it was changed
+    for (uint8_t slot = 0; slot < this->count; slot++) {
+        if (slot_used(slot) && cache.resolutions[slot] != resolutions[slot]) {
+            if (sensors->setResolution(cache.addresses[slot], resolutions[slot], true)) {
+                cache.resolutions[slot] = resolutions[slot];
+                changed = true;
+            }
+        }
+    }
+
+    if (changed) {
+        save();
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DS18B20Probes::start(void) {
+    // all probes convert at once (skip ROM)
+    sensors->requestTemperatures();
+}
+
+bool DS18B20Probes::ready(void) {
+    return sensors->isConversionComplete();
+}
+
+unsigned long DS18B20Probes::maxMillis(void) {
+    uint8_t slowest = 9;
+    for (uint8_t slot = 0; slot < count; slot++) {
+        if (slot_used(slot)) {
+            slowest = std::max(slowest, cache.resolutions[slot]);
+        }
+    }
+    // maximum conversion time of the datasheet plus some margin
+    return sensors->millisToWaitForConversion(slowest) + 20;
+}
+
+float DS18B20Probes::read(uint8_t slot) {
+    if (slot >= count || !slot_used(slot)) {
+        return NAN;
+    }
+    float t = sensors->getTempC(cache.addresses[slot]);
+    if (isnan(t) || t == DEVICE_DISCONNECTED_C) {
+        // search the bus on the next wake
+        if (!cache.stale) {
+            cache.stale = 1;
+            save();
+        }
+        return NAN;
+    }
+    // corrected temperature based on preceding calibration
+    float range = calibrations_hi[slot] - calibrations_lo[slot];
+    return (((t - calibrations_lo[slot]) * 99.99) / range) + 0.01;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DS18B20Probes::load(void) {
+    if (!files->exists(DS18B20_CACHE_FILE)
+        || files->read(DS18B20_CACHE_FILE, 0, &cache, sizeof(cache)) != sizeof(cache)
+        || cache.checksum != Memory::checksum(&cache, DS18B20_CACHE_CHECKSUM_SIZE)) {
+        memset(&cache, 0, sizeof(cache));
+        return false;
+    }
+    return true;
+}
+
+void DS18B20Probes::save(void) {
+    cache.checksum = Memory::checksum(&cache, DS18B20_CACHE_CHECKSUM_SIZE);
+    files->remove(DS18B20_CACHE_FILE);
+    files->append(DS18B20_CACHE_FILE, &cache, sizeof(cache));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DS18B20Probes::search(void) {
+    notification.info(F("Searching DS18B20 probes"));
+
+    sensors->begin();
+    uint8_t found[DS18B20_SEARCH_MAX][8];
+    uint8_t n = 0;
+    uint8_t devices = sensors->getDeviceCount();
+    for (uint8_t index = 0; index < devices && n < DS18B20_SEARCH_MAX; index++) {
+        if (sensors->getAddress(found[n], index) && sensors->validAddress(found[n])) {
+            n++;
+        }
+    }
+
+    // free slots of probes not found
+    for (uint8_t slot = 0; slot < DS18B20_PROBES_MAX; slot++) {
+        bool present = false;
+        for (uint8_t i = 0; i < n; i++) {
+            present = present || memcmp(cache.addresses[slot], found[i], 8) == 0;
+        }
+        if (!present) {
+            memset(cache.addresses[slot], 0, 8);
+            cache.resolutions[slot] = 0;
+        }
+    }
+
+    // fill free slots with new probes in order of the search
+    for (uint8_t i = 0; i < n; i++) {
+        if (slot_of(found[i]) >= 0) {
+            continue;
+        }
+        for (uint8_t slot = 0; slot < count; slot++) {
+            if (!slot_used(slot)) {
+                memcpy(cache.addresses[slot], found[i], 8);
+                cache.resolutions[slot] = sensors->getResolution(found[i]);
+                break;
+            }
+        }
+    }
+
+    cache.stale = 0;
+
+    notification.info(F("DS18B20 probes found: "), (unsigned int) n);
+}
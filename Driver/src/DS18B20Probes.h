@@ -0,0 +1,74 @@
+#ifndef __DS18B20_PROBES_H__
+#define __DS18B20_PROBES_H__
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to operate several DS18B20 probes on one 1-Wire bus. Every probe has a slot with its own
+// resolution and calibration. The ROM addresses of the probes are found by a search of the bus
+// once and cached in Flash memory together with the resolutions written to the probes. So waking
+// from deep sleep neither searches the bus nor writes the EEPROM of the probes. A conversion is
+// started on all probes at once, it takes as long as the conversion of the slowest probe.
+//
+// Slots keep their probes: A search only fills free slots and frees slots of probes not found.
+// The bus is searched again after power on if a slot is free, and on the next wake if a probe did
+// not respond. With probes powered by the data line (parasite power) the bus is searched on every
+// wake, as the library only detects them by a search.
+//
+// For example:
+//   probes.configure(0, 12, 1.4, 98.8);
+//   probes.begin(1, &files);
+//   probes.start();
+//   while (!probes.ready()) ...
+//   float t = probes.read(0);
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Files.h"
+
+// Maximum number of probes.
+#define DS18B20_PROBES_MAX 3
+
+class DS18B20Probes {
+public:
+    DS18B20Probes(DallasTemperature *sensors);
+
+    // Configures the probe in the given slot with the given resolution (9 to 12 bits) and the
+    // given calibration, which are the raw readings of the probe at 0.01 °C and 100 °C.
+    // Must be called before begin.
+    void configure(uint8_t slot, uint8_t resolution, float calibration_lo, float calibration_hi);
+
+    // Begin operating the given number of probes with the given files manager.
+    // Must be called before any other method.
+    bool begin(uint8_t count, Files *files);
+
+    // Starts a conversion on all probes.
+    void start(void);
+    // Tests if the conversion has completed.
+    bool ready(void);
+    // Returns the maximum conversion time of the slowest probe in milliseconds.
+    unsigned long maxMillis(void);
+
+    // Reads the calibrated temperature of the probe in the given slot. Returns NAN if there is no
+    // probe in this slot or if the probe did not respond.
+    float read(uint8_t slot);
+
+private:
+    DallasTemperature *sensors;
+    Files *files;
+
+    uint8_t count;
+
+    uint8_t resolutions[DS18B20_PROBES_MAX];
+    float calibrations_lo[DS18B20_PROBES_MAX];
+    float calibrations_hi[DS18B20_PROBES_MAX];
+
+    bool load(void);
+    void save(void);
+
+    void search(void);
+};
+
+#endif
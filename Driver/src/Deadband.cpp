@@ -0,0 +1,93 @@
+#include <Arduino.h>
+
+#include "Deadband.h"
+
+#include "Readings.h"
+#include "Memory.h"
+
+extern Memory memory;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    int16_t values[Readings::READING_TYPE_MAX + 1]; // packed values last sent
+    uint16_t silent; // seconds since last sent
+} deadband_t;
+
+static_assert(sizeof(deadband_t) <= MEMORY_DEADBAND_SIZE, "Deadband block too small");
+
+static deadband_t deadband;
+static bool deadband_valid = false;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Deadband::Deadband(uint16_t heartbeat) {
+    this->heartbeat = heartbeat > 0 ? heartbeat : 1;
+    this->last_millis = 0;
+    for (int i = 0; i <= Readings::READING_TYPE_MAX; i++) {
+        thresholds[i] = 0.0;
+    }
+}
+
+void Deadband::threshold(Readings::reading_type type, float threshold) {
+    thresholds[type] = threshold;
+}
+
+bool Deadband::begin(void) {
+    last_millis = millis();
+    deadband_valid = memory.load(Memory::deadband, &deadband, sizeof(deadband));
+    return true;
+}
+
+bool Deadband::isDue(void) {
+    return !deadband_valid || deadband.silent >= heartbeat;
+}
+
+bool Deadband::isDue(Readings &readings) {
+    if (isDue()) {
+        return true;
+    }
+    // compare with packed values, so rounding is the same as for values last sent
+    int16_t values[Readings::READING_TYPE_MAX + 1];
+    readings.pack(values);
+    Readings current;
+    Readings last;
+    current.unpack(values);
+    last.unpack(deadband.values);
+    for (int i = 0; i <= Readings::READING_TYPE_MAX; i++) {
+        Readings::reading_type type = static_cast<Readings::reading_type>(i);
+        float value = current.retrieve(type);
+        float last_value = last.retrieve(type);
+        if (isnan(value) || isnan(last_value)) {
+            if (isnan(value) != isnan(last_value)) {
+                return true;
+            }
+            continue;
+        }
+        if (fabs(value - last_value) > thresholds[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Deadband::update(Readings &readings, bool sent) {
+    if (sent) {
+        readings.pack(deadband.values);
+        deadband.silent = 0;
+        deadband_valid = true;
+        last_millis = millis();
+        memory.save(Memory::deadband, &deadband, sizeof(deadband));
+    }
+}
+
+void Deadband::elapse(unsigned long sleep_millis) {
+    if (!deadband_valid) {
+        return;
+    }
+    unsigned long silent = deadband.silent + (millis() - last_millis + sleep_millis + 500) / 1000;
+    deadband.silent = std::min(silent, (unsigned long) UINT16_MAX);
+    // when delaying instead of deep sleep, millis will have advanced by the sleep duration
+    last_millis = millis() + sleep_millis;
+    memory.save(Memory::deadband, &deadband, sizeof(deadband));
+}
@@ -0,0 +1,54 @@
+#ifndef __DEADBAND_H__
+#define __DEADBAND_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to decide whether sensor readings are worth sending to a server (send-on-delta). Readings
+// are due if any value differs from the last sent value by more than the deadband of its reading
+// type, or with the first measuring cycle after nothing was sent for a given time (heartbeat). The
+// last sent values and the time since are kept in RTC memory.
+//
+// The heartbeat is counted in time, not in measuring cycles, so it holds while the measuring
+// interval is stretched.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Readings.h"
+
+class Deadband {
+public:
+    // Constructs a deadband which forces sending after the given time in seconds.
+    Deadband(uint16_t heartbeat);
+
+    // Sets the deadband for the given reading type. The deadband is 0 for all types by default,
+    // so any change of a value is due.
+    void threshold(Readings::reading_type type, float threshold);
+
+    // Begin managing the deadband. Loads the last sent values kept in RTC memory.
+    // Must be called before any other method except threshold.
+    bool begin(void);
+
+    // Checks if the given readings are due for sending. Readings are always due if nothing was
+    // sent before, or if a value appeared or disappeared.
+    bool isDue(Readings &readings);
+    // Checks if readings are due for sending regardless of their values (heartbeat).
+    bool isDue(void);
+
+    // Updates the deadband after a measuring cycle. Keeps the given readings as last sent values
+    // if sent is true.
+    void update(Readings &readings, bool sent);
+
+    // Advances the time since last sent by the time awake and the given sleep duration. To be
+    // called before sleeping, so isDue tells if the next measuring cycle is due.
+    void elapse(unsigned long sleep_millis);
+
+private:
+    uint16_t heartbeat;
+
+    unsigned long last_millis;
+
+    float thresholds[Readings::READING_TYPE_MAX + 1];
+};
+
+#endif
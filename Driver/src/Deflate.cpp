@@ -0,0 +1,215 @@
+#include <Arduino.h>
+
+#include "Deflate.h"
+
+#include "Memory.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define DEFLATE_MATCH_MIN 3
+#define DEFLATE_MATCH_MAX 258
+
+// Marks an unused entry of the hash table.
+#define DEFLATE_NONE 0xffff
+
+static_assert(DEFLATE_WINDOW > DEFLATE_MATCH_MAX, "Deflate window too small");
+static_assert(2 * DEFLATE_WINDOW < DEFLATE_NONE, "Deflate window too large");
+
+// Base lengths of length codes 257..285, number of extra bits is derived from the index.
+static const uint16_t length_base[29] PROGMEM = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+// Base distances of distance codes 0..29, number of extra bits is derived from the index.
+static const uint16_t distance_base[30] PROGMEM = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static uint8_t length_extra(uint8_t index) {
+    return (index < 8 || index == 28) ? 0 : index / 4 - 1;
+}
+
+static uint8_t distance_extra(uint8_t index) {
+    return index < 2 ? 0 : index / 2 - 1;
+}
+
+// Returns the hash of the three bytes at the given position.
+static uint16_t deflate_hash(const uint8_t *bytes) {
+    uint32_t value = ((uint32_t) bytes[0] << 16) | ((uint32_t) bytes[1] << 8) | bytes[2];
+    return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Deflate::begin(Print &output) {
+    this->output = &output;
+    memset(head, 0xff, sizeof(head));
+    fill = 0;
+    position = 0;
+    bits = 0;
+    bit_count = 0;
+    crc = 0;
+    size_in = 0;
+    size_out = 0;
+
+    // gzip header: magic, method deflate, no flags, no time, no extra flags, unknown os
+    static const uint8_t header[10] PROGMEM = {
+        0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff
+    };
+    for (size_t i = 0; i < sizeof(header); i++) {
+        put_byte(pgm_read_byte(&header[i]));
+    }
+    // one block with fixed Huffman codes for all data
+    put_bits(0, 1);
+    put_bits(1, 2);
+}
+
+void Deflate::write(const uint8_t *data, size_t size) {
+    size_in += size;
+    crc = Memory::checksum(data, size, crc);
+    while (size > 0) {
+        if (fill == sizeof(window)) {
+            slide();
+        }
+        size_t count = sizeof(window) - fill;
+        if (count > size) {
+            count = size;
+        }
+        memcpy(window + fill, data, count);
+        fill += count;
+        data += count;
+        size -= count;
+        compress(false);
+    }
+}
+
+void Deflate::end(void) {
+    compress(true);
+    put_literal(256);
+    // final empty block
+    put_bits(1, 1);
+    put_bits(1, 2);
+    put_literal(256);
+    align();
+
+    // gzip trailer: checksum and size of data
+    for (uint8_t i = 0; i < 32; i += 8) {
+        put_byte(crc >> i);
+    }
+    for (uint8_t i = 0; i < 32; i += 8) {
+        put_byte(size_in >> i);
+    }
+}
+
+// Compresses data in the window. Keeps enough data for the longest match unless flushing.
+void Deflate::compress(bool flush) {
+    uint16_t limit = flush ? fill : (fill > DEFLATE_MATCH_MAX ? fill - DEFLATE_MATCH_MAX : 0);
+    while (position < limit) {
+        uint16_t available = fill - position;
+        uint16_t length = 0;
+        uint16_t distance = 0;
+        if (available >= DEFLATE_MATCH_MIN) {
+            uint16_t hash = deflate_hash(window + position);
+            uint16_t candidate = head[hash];
+            head[hash] = position;
+            if (candidate != DEFLATE_NONE) {
+                uint16_t length_max = available < DEFLATE_MATCH_MAX ? available : DEFLATE_MATCH_MAX;
+                while (length < length_max && window[candidate + length] == window[position + length]) {
+                    length++;
+                }
+                distance = position - candidate;
+            }
+        }
+        if (length >= DEFLATE_MATCH_MIN) {
+            put_match(length, distance);
+            for (uint16_t i = 1; i < length; i++) {
+                if (fill - (position + i) >= DEFLATE_MATCH_MIN) {
+                    head[deflate_hash(window + position + i)] = position + i;
+                }
+            }
+            position += length;
+        }
+        else {
+            put_literal(window[position]);
+            position++;
+        }
+    }
+}
+
+// Discards the older half of the window to make room for new data.
+void Deflate::slide(void) {
+    memmove(window, window + DEFLATE_WINDOW, DEFLATE_WINDOW);
+    fill -= DEFLATE_WINDOW;
+    position -= DEFLATE_WINDOW;
+    for (size_t i = 0; i < sizeof(head) / sizeof(head[0]); i++) {
+        head[i] = (head[i] == DEFLATE_NONE || head[i] < DEFLATE_WINDOW) ?
+            DEFLATE_NONE : head[i] - DEFLATE_WINDOW;
+    }
+}
+
+void Deflate::put_bits(uint32_t value, uint8_t count) {
+    bits |= value << bit_count;
+    bit_count += count;
+    while (bit_count >= 8) {
+        put_byte(bits);
+        bits >>= 8;
+        bit_count -= 8;
+    }
+}
+
+// Puts the given Huffman code, which is stored most significant bit first.
+void Deflate::put_code(uint16_t code, uint8_t length) {
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    put_bits(reversed, length);
+}
+
+// Puts the fixed Huffman code of the given literal or length code.
+void Deflate::put_literal(uint16_t literal) {
+    if (literal < 144) {
+        put_code(0x30 + literal, 8);
+    }
+    else if (literal < 256) {
+        put_code(0x190 + literal - 144, 9);
+    }
+    else if (literal < 280) {
+        put_code(literal - 256, 7);
+    }
+    else {
+        put_code(0xc0 + literal - 280, 8);
+    }
+}
+
+void Deflate::put_match(uint16_t length, uint16_t distance) {
+    uint8_t index = 28;
+    while (pgm_read_word(&length_base[index]) > length) {
+        index--;
+    }
+    put_literal(257 + index);
+    put_bits(length - pgm_read_word(&length_base[index]), length_extra(index));
+
+    index = 29;
+    while (pgm_read_word(&distance_base[index]) > distance) {
+        index--;
+    }
+    put_code(index, 5);
+    put_bits(distance - pgm_read_word(&distance_base[index]), distance_extra(index));
+}
+
+void Deflate::put_byte(uint8_t value) {
+    output->write(value);
+    size_out++;
+}
+
+void Deflate::align(void) {
+    if (bit_count > 0) {
+        put_byte(bits);
+    }
+    bits = 0;
+    bit_count = 0;
+}
@@ -0,0 +1,66 @@
+#ifndef __DEFLATE_H__
+#define __DEFLATE_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Operating Support:
+// Class to compress a stream of data into the gzip format (RFC 1952) with a small window. Data
+// is compressed on the fly using LZ77 and fixed Huffman codes (RFC 1951) and written to the
+// given output. No memory is allocated, the state is about 2 * DEFLATE_WINDOW bytes.
+//
+// For example:
+//   deflate.begin(output);
+//   deflate.write(data, size);
+//   deflate.end();
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of the window for back references (must be larger than 258 bytes).
+#define DEFLATE_WINDOW 512
+// Number of bits of hashes for finding back references (the table has 2^bits entries).
+#define DEFLATE_HASH_BITS 8
+
+class Deflate {
+public:
+    // Begins a new stream to the given output, which must outlive the stream. Writes the header.
+    void begin(Print &output);
+    // Compresses the given data.
+    void write(const uint8_t *data, size_t size);
+    void write(const char *data, size_t size) {
+        write(reinterpret_cast<const uint8_t *>(data), size);
+    }
+    // Compresses the remaining data and ends the stream. Writes the trailer.
+    void end(void);
+
+    // Returns the number of bytes given to compress.
+    uint32_t sizeIn(void) const { return size_in; }
+    // Returns the number of bytes written to the output.
+    uint32_t sizeOut(void) const { return size_out; }
+
+private:
+    Print *output;
+
+    uint8_t window[2 * DEFLATE_WINDOW];
+    uint16_t head[1 << DEFLATE_HASH_BITS]; // position of the latest occurrence of each hash
+    uint16_t fill; // number of bytes in window
+    uint16_t position; // position of the next byte to compress
+
+    uint32_t bits; // bits to write, least significant bit first
+    uint8_t bit_count;
+
+    uint32_t crc;
+    uint32_t size_in;
+    uint32_t size_out;
+
+    void compress(bool flush);
+    void slide(void);
+
+    void put_bits(uint32_t value, uint8_t count);
+    void put_code(uint16_t code, uint8_t length);
+    void put_literal(uint16_t literal);
+    void put_match(uint16_t length, uint16_t distance);
+    void put_byte(uint8_t value);
+    void align(void);
+};
+
+#endif
@@ -53,8 +53,10 @@
 // Operating Support
 
 #include "Signaling.h"
+#include "Logger.h"
 #include "Notification.h"
 
+#include "Memory.h"
 #include "Files.h"
 #include "Values.h"
 
@@ -84,11 +86,22 @@
 
 // Weather Device
 
+#include "Acquisition.h"
 #include "Readings.h"
+#include "Batch.h"
+#include "Aggregate.h"
+#include "Journal.h"
+#include "Deadband.h"
+#include "Scheduler.h"
+#include "Wake.h"
+#include "Profiler.h"
+#include "Energy.h"
 #include "Transport.h"
 
 #include "I2C.h"
 #include "I2CExtender.h"
+#include "WarmBME280.h"
+#include "DS18B20Probes.h"
 
 // Configuration
 
@@ -126,15 +139,31 @@ extern const int SKETCH_VERSION;
 // Global toggle for production or development mode.
 extern const bool PRODUCTION = PRODUCTION_MODE;
 
+#if PRODUCTION_MODE && NOTIFICATION_LEVEL > NOTIFICATION_LEVEL_FATAL
+#warning "Output code is kept in production, NOTIFICATION_LEVEL is above NOTIFICATION_LEVEL_FATAL"
+#endif
+
 // Define measuring interval and minimum delay between measurements.
 const long MEASURING_INTERVAL = PRODUCTION ? 5 * 60 * 1000 : 1 * 60 * 1000; // milliseconds
 const long MEASURING_INTERVAL_DELAY_MIN = PRODUCTION ? 60 * 1000 : 10 * 1000; // milliseconds
 
+// Toggle for compression of requests to the server.
+#if defined (TRANSPORT_GZIP_ON)
+const bool TRANSPORT_COMPRESSED = true;
+#else
+const bool TRANSPORT_COMPRESSED = false;
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 Signaling signaling = Signaling(SIGNALING_LED);
+Logger logger = Logger();
 Notification notification = Notification();
 
+Memory memory = Memory();
+Wake wake = Wake();
+Profiler profiler = Profiler();
+Energy energy = Energy();
 Files files = Files();
 Values values = Values();
 
@@ -144,12 +173,25 @@ Network driver_network = Network(DEVICE_ID, NETWORK_SSID, NETWORK_PASS);
 Network driver_network = Network(DEVICE_ID);
 #endif
 
+#if defined (BATCH_ON) && defined (AGGREGATE_ON)
+#error "Batching and aggregation of readings share RTC memory, enable only one of them"
+#endif
+
+#if defined (BATCH_ON) || defined (JOURNAL_ON) || defined (AGGREGATE_ON) || defined (ALIGN_ON) || defined (NETWORK_ON)
+// batched, journaled and aggregated readings need timestamps, aligned cycles need the wall-clock and the cached
+// network connection ages by it, the clock is kept across deep sleep and synced when pushing readings if due
+Clock driver_clock = Clock(Clock::soft);
+#else
 Clock driver_clock = Clock(Clock::off);
+#endif
 
 #ifdef OTA_ON
 OTA ota = OTA();
 #endif
 
+// Number of network sessions since boot (one per wake cycle at most).
+unsigned int network_sessions = 0;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // I2C
 
@@ -162,6 +204,9 @@ OTA ota = OTA();
 #define I2C_EXTENDER_ENABLE -1
 #endif
 
+// Maximum time for devices to respond after activating the I2C extender (in milliseconds).
+#define I2C_EXTENDER_SETTLE_MAX 1000
+
 I2CExtender i2c_extender(I2C_EXTENDER_ENABLE);
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -188,9 +233,11 @@ Switch testSwitch(TEST_SWITCH_PIN, Switch::PullUp::Enable, 0);
 // * ML8511
 
 // analogue input
-Adafruit_ADS1115 ads(0x48);
+#define ADS1115_I2C 0x48
+Adafruit_ADS1115 ads(ADS1115_I2C);
 
 // analogue reference 3.3V
+#define ADS1115_REFERENCE 3 // ads channel
 uint16_t ads_reference;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -199,50 +246,62 @@ uint16_t ads_reference;
 // Temperature
 #ifdef DS18B20_ON
 #define DS18B20_PIN D6 // 1-wire pin
-const String DS18B20_ID = "DS18B20";
+const char DS18B20_ID[] PROGMEM = "DS18B20";
 OneWire oneWire(DS18B20_PIN);
 DallasTemperature ds18b20(&oneWire);
-#define DS18B20_CALIBRATION_LO 1.4  // reference 0.01°C
-#define DS18B20_CALIBRATION_HI 98.8 // reference 100°C
-#define DS18B20_CALIBRATION_RANGE (DS18B20_CALIBRATION_HI - DS18B20_CALIBRATION_LO)
+DS18B20Probes ds18b20_probes(&ds18b20);
+// reading types of the probes by slot
+const Readings::reading_type DS18B20_TYPES[DS18B20_PROBES_MAX] = {
+    Readings::temperature_external, Readings::temperature_external2, Readings::temperature_external3
+};
 #endif
 
 // Temperature + Pressure
 #define BMP280_I2C 0x76
-const String BMP280_ID = "BMP280";
+const char BMP280_ID[] PROGMEM = "BMP280";
 Adafruit_BMP280 bmp280;
 
 // Temperature + Pressure + Humidity
 #define BME280_I2C 0x76
-const String BME280_ID = "BME280";
-Adafruit_BME280 bme280;
+const char BME280_ID[] PROGMEM = "BME280";
+WarmBME280 bme280;
+
+// Registers shared by BMP280 and BME280
+#define BMx280_REGISTER_CHIPID 0xD0
+#define BMx280_REGISTER_STATUS 0xF3
+#define BMx280_REGISTER_CONTROL 0xF4
+#define BMx280_STATUS_MEASURING 0x08
+#define BMx280_CHIPID_BMP280 0x58
+#define BMx280_CHIPID_BME280 0x60
 
 // Temperature + Humidity
 #ifdef SHT30_ON
-const String SHT30_ID = "SHT30";
+#define SHT30_I2C 0x44
+const char SHT30_ID[] PROGMEM = "SHT30";
 SHTSensor sht(SHTSensor::SHT3X);
 #endif
 
 // Temperature + Humidity
 #ifdef DHT22_ON
 #define DHT22_PIN D3 // 1-wire pin
-const String DHT22_ID = "DHT22";
+const char DHT22_ID[] PROGMEM = "DHT22";
 DHT dht(DHT22_PIN, DHT22);
 #endif
 
 // Illuminance
 #define TSL2561_I2C TSL2561_ADDR_FLOAT
-const String TSL2561_ID = "TSL2561";
+const char TSL2561_ID[] PROGMEM = "TSL2561";
 Adafruit_TSL2561_Unified tsl2561 = Adafruit_TSL2561_Unified(TSL2561_I2C, 12345);
 
 // UV intensity
-const String VEML6070_ID = "VEML6070";
+const char VEML6070_ID[] PROGMEM = "VEML6070";
 Adafruit_VEML6070 veml6070 = Adafruit_VEML6070();
 
 // UV intensity
 #define ML8511_PIN D5 // enable pin
 #define ML8511_ADS 1 // ads channel
-const String ML8511_ID = "ML8511";
+const char ML8511_ID[] PROGMEM = "ML8511";
+uint16_t ml8511_value;
 
 // checks
 
@@ -250,15 +309,40 @@ const String ML8511_ID = "ML8511";
 #error You can not use BMP280 and BME280 simultaneously!
 #endif
 
-#if defined (ML8511_ON) && ! defined (ADS1115)
+#if defined (ML8511_ON) && ! defined (ADS1115_ON)
 #error You need to have ADS1115 to use ML8511!
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // READINGS
 
+Acquisition acquisition;
+
 Readings readings;
 
+#if defined (BATCH_ON)
+static_assert(BATCH_CYCLES <= BATCH_CAPACITY, "BATCH_CYCLES exceeds the records kept in RTC memory");
+Batch batch = Batch(BATCH_CYCLES);
+#endif
+
+#if defined (AGGREGATE_ON)
+Aggregate aggregate = Aggregate(AGGREGATE_WINDOW);
+#endif
+
+#if defined (JOURNAL_ON)
+Journal journal = Journal();
+#endif
+
+#if defined (DEADBAND_ON) && ! defined (BATCH_ON) && ! defined (AGGREGATE_ON)
+Deadband deadband = Deadband(DEADBAND_HEARTBEAT);
+#endif
+
+#if defined (SCHEDULE_ON)
+Scheduler scheduler = Scheduler(
+    MEASURING_INTERVAL, MEASURING_INTERVAL / 4, MEASURING_INTERVAL * SCHEDULE_STRETCH
+);
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // VOLTAGE
 
@@ -276,7 +360,7 @@ void readVoltage(Readings *readings) {
         notification.warn(F("Failed to read voltage!"));
         return;
     }
-    readings->store(v, Readings::voltage, "INTERNAL");
+    readings->store(v, Readings::voltage, PSTR("INTERNAL"));
     #endif
 }
 
@@ -286,22 +370,42 @@ void readVoltage(Readings *readings) {
 #ifdef DS18B20_ON
 
 bool setupDS18B20(void) {
-    ds18b20.begin();
-    return true;
+    const uint8_t resolutions[] = DS18B20_RESOLUTIONS;
+    const float calibrations[][2] = DS18B20_CALIBRATIONS;
+    static_assert(DS18B20_PROBES <= DS18B20_PROBES_MAX, "Too many DS18B20 probes");
+    static_assert(sizeof(resolutions) / sizeof(resolutions[0]) == DS18B20_PROBES,
+        "DS18B20_RESOLUTIONS must have DS18B20_PROBES entries");
+    static_assert(sizeof(calibrations) / sizeof(calibrations[0]) == DS18B20_PROBES,
+        "DS18B20_CALIBRATIONS must have DS18B20_PROBES entries");
+    for (uint8_t slot = 0; slot < DS18B20_PROBES; slot++) {
+        ds18b20_probes.configure(slot, resolutions[slot],
+            calibrations[slot][0], calibrations[slot][1]);
+    }
+    // addresses of the probes are cached in flash, the bus is only searched if needed
+    return ds18b20_probes.begin(DS18B20_PROBES, &files);
+}
+
+void startDS18B20(void) {
+    ds18b20_probes.start();
+}
+
+bool readyDS18B20(void) {
+    return ds18b20_probes.ready();
+}
+
+unsigned long maxMillisDS18B20(void) {
+    return ds18b20_probes.maxMillis();
 }
 
 void readDS18B20(Readings *readings) {
-    ds18b20.requestTemperatures();
-    delay(100);
-    // currently this driver only supports 1 sensor at index 0
-    float t = ds18b20.getTempCByIndex(0);
-    if (isnan(t)) {
-        notification.warn(F("Failed to read from DS18B20 sensor!"));
-        return;
+    for (uint8_t slot = 0; slot < DS18B20_PROBES; slot++) {
+        float t = ds18b20_probes.read(slot);
+        if (isnan(t)) {
+            NOTIFICATION_WARN(F("Failed to read from DS18B20 probe "), String(slot + 1));
+            continue;
+        }
+        readings->store(t, DS18B20_TYPES[slot], DS18B20_ID);
     }
-    // corrected temperature based on preceding calibration
-    t = (((t - DS18B20_CALIBRATION_LO) * 99.99) / DS18B20_CALIBRATION_RANGE) + 0.01;
-    readings->store(t, Readings::temperature_external, DS18B20_ID);
 }
 
 #endif
@@ -317,18 +421,37 @@ void readDS18B20(Readings *readings) {
 // osrs_p: x1
 // osrs_t: x1
 // IIR filter: off
+// Measurement time (max): 6.4 ms
+
+#define BMP280_CONTROL_FORCED \
+    ((Adafruit_BMP280::SAMPLING_X1 << 5) | \
+     (Adafruit_BMP280::SAMPLING_X1 << 2) | \
+     Adafruit_BMP280::MODE_FORCED)
 
 bool setupBMP280(void) {
     if (bmp280.begin(BMP280_I2C)) {
+        bmp280.setSampling(
+            Adafruit_BMP280::MODE_FORCED,
+            Adafruit_BMP280::SAMPLING_X1, // temperature
+            Adafruit_BMP280::SAMPLING_X1, // pressure
+            Adafruit_BMP280::FILTER_OFF,
+            Adafruit_BMP280::STANDBY_MS_1
+        );
         return true;
     }
     TERMINATE_FATAL_BLINK(F("Failed to find a valid BMP280 sensor!"), 10);
 }
 
+void startBMP280(void) {
+    // trigger forced measurement, but do not wait for it
+    i2c_write8(BMP280_I2C, BMx280_REGISTER_CONTROL, BMP280_CONTROL_FORCED);
+}
+
+bool readyBMP280(void) {
+    return !(i2c_read8(BMP280_I2C, BMx280_REGISTER_STATUS) & BMx280_STATUS_MEASURING);
+}
+
 void readBMP280(Readings *readings) {
-    bmp280.readTemperature();
-    bmp280.readPressure();
-    delay(100);
     float t = bmp280.readTemperature();
     float p = bmp280.readPressure();
     if (isnan(t) || isnan(p)) {
@@ -357,8 +480,18 @@ void readBMP280(Readings *readings) {
 // Current consumption 0.16 µA
 // RMS Noise 3.3 Pa / 30 cm, 0.07 %RH
 // Data output rate 1/60 Hz
+// Measurement time (max): 9.3 ms
+
+#define BME280_CONTROL_FORCED \
+    ((Adafruit_BME280::SAMPLING_X1 << 5) | \
+     (Adafruit_BME280::SAMPLING_X1 << 2) | \
+     Adafruit_BME280::MODE_FORCED)
 
 bool setupBME280(void) {
+    // restore chip id, trimming coefficients and configuration after deep sleep
+    if (bme280.restore(BME280_I2C)) {
+        return true;
+    }
     if (bme280.begin(BME280_I2C)) {
         bme280.setSampling(
             Adafruit_BME280::MODE_FORCED,
@@ -368,14 +501,23 @@ bool setupBME280(void) {
             Adafruit_BME280::FILTER_OFF,
             Adafruit_BME280::STANDBY_MS_10
         );
+        bme280.save();
         return true;
     }
     TERMINATE_FATAL_BLINK(F("Failed to find a valid BME280 sensor!"), 11);
 }
 
+void startBME280(void) {
+    // trigger forced measurement like takeForcedMeasurement, but do not wait for it
+    // (humidity oversampling is kept in its own control register by setSampling)
+    i2c_write8(BME280_I2C, BMx280_REGISTER_CONTROL, BME280_CONTROL_FORCED);
+}
+
+bool readyBME280(void) {
+    return !(i2c_read8(BME280_I2C, BMx280_REGISTER_STATUS) & BMx280_STATUS_MEASURING);
+}
+
 void readBME280(Readings *readings) {
-  bme280.takeForcedMeasurement();
-  delay(100);
   float t = bme280.readTemperature();
   float p = bme280.readPressure();
   float h = bme280.readHumidity();
@@ -393,22 +535,66 @@ void readBME280(Readings *readings) {
 // datasheet: https://www.sensirion.com/fileadmin/user_upload/customers/sensirion/Dokumente/2_Humidity_Sensors/Datasheets/Sensirion_Humidity_Sensors_SHT3x_Datasheet_digital.pdf
 #ifdef SHT30_ON
 
+// Single shot measurement, high repeatability: 15.5 ms (max)
+// The measurement is triggered and read without the library to be able to poll for readiness:
+// The sensor does not acknowledge a read header while measuring.
+
+uint8_t sht30_sample[6]; // temperature msb, lsb, crc, humidity msb, lsb, crc
+bool sht30_sampled;
+
 bool setupSHT30(void) {
     sht.init();
     return true;
 }
 
+void startSHT30(void) {
+    sht30_sampled = false;
+    // single shot, high repeatability, clock stretching disabled
+    Wire.beginTransmission(SHT30_I2C);
+    Wire.write((uint8_t) 0x24);
+    Wire.write((uint8_t) 0x00);
+    Wire.endTransmission();
+}
+
+bool readySHT30(void) {
+    if (Wire.requestFrom((uint8_t) SHT30_I2C, (uint8_t) sizeof(sht30_sample)) == sizeof(sht30_sample)) {
+        for (size_t i = 0; i < sizeof(sht30_sample); i++) {
+            sht30_sample[i] = Wire.read();
+        }
+        sht30_sampled = true;
+    }
+    return sht30_sampled;
+}
+
+uint8_t crcSHT30(const uint8_t *data) {
+    // CRC-8, polynomial 0x31, initialization 0xFF
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < 2; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
 void readSHT30(Readings *readings) {
-    if (sht.readSample()) {
-        float t = sht.getTemperature();
-        float h = sht.getHumidity();
-        if (isnan(t) || isnan(h)) {
-            notification.warn(F("Failed to read from SHT30 sensor!"));
+    if (sht30_sampled) {
+        if (crcSHT30(&sht30_sample[0]) != sht30_sample[2] ||
+            crcSHT30(&sht30_sample[3]) != sht30_sample[5]) {
+            notification.warn(F("Failed to read from SHT30 sensor (checksum)!"));
             return;
         }
+        uint16_t st = (sht30_sample[0] << 8) | sht30_sample[1];
+        uint16_t sh = (sht30_sample[3] << 8) | sht30_sample[4];
+        float t = -45.0 + 175.0 * st / 65535.0;
+        float h = 100.0 * sh / 65535.0;
         readings->store(t, Readings::temperature, SHT30_ID);
         readings->store(h, Readings::humidity, SHT30_ID);
     }
+    else {
+        notification.warn(F("Failed to read from SHT30 sensor!"));
+    }
 }
 
 #endif
@@ -424,9 +610,7 @@ bool setupDHT22(void) {
 }
 
 void readDHT22(Readings *readings) {
-    dht.readTemperature();
-    dht.readHumidity();
-    delay(100);
+    // Note: The sensor has no means to start a conversion, the reading is done by the library.
     float t = dht.readTemperature();
     float h = dht.readHumidity();
     if (isnan(t) || isnan(h)) {
@@ -464,13 +648,15 @@ void readTSL2561(Readings *readings) {
 // VEML6070
 // datasheet: https://cdn-learn.adafruit.com/assets/assets/000/032/482/original/veml6070.pdf
 
+// Integration time 1T (RSET 270 kOhm): 125 ms
+#define VEML6070_INTEGRATION_MILLIS 125
+
 bool setupVEML6070() {
     veml6070.begin(VEML6070_1_T);
     return true;
 }
 
 void readVEML6070(Readings *readings) {
-    delay(100);
     float u = veml6070.readUV();
     if (isnan(u)) {
         notification.warn(F("Failed to read from VEML6070 sensor!"));
@@ -492,10 +678,9 @@ float mapfloat(float x, float in_min, float in_max, float out_min, float out_max
 }
 
 void readML8511(Readings *readings) {
-    delay(100);
     if (ads_reference > 0) {
-        // read sensor value from analogue input
-        uint16_t value = ads.readADC_SingleEnded(ML8511_ADS);
+        // sensor value from analogue input (converted by the acquisition)
+        uint16_t value = ml8511_value;
         // calculate sensor voltage with reference value for 3.3V
         float voltage = 3.3 / ads_reference * value;
         // map sensor input to uv intensity
@@ -512,9 +697,82 @@ void readML8511(Readings *readings) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
+// ADS1115
+// datasheet: https://www.ti.com/lit/ds/symlink/ads1115.pdf
+// Single-shot conversions are started like readADC_SingleEnded does, but instead of waiting a
+// fixed time the conversion is polled from the OS bit of the config register. The conversion of
+// the reference channel is chained with the conversions of the sensor channels.
+// Conversion time (128 SPS): 7.8 ms
+
+#define ADS1115_CONVERSION_MILLIS 9
+
+const uint8_t ads_channels[] = {
+    ADS1115_REFERENCE,
+    #ifdef ML8511_ON
+    ML8511_ADS,
+    #endif
+};
+uint16_t *const ads_values[] = {
+    &ads_reference,
+    #ifdef ML8511_ON
+    &ml8511_value,
+    #endif
+};
+const uint8_t ads_count = sizeof(ads_channels) / sizeof(ads_channels[0]);
+uint8_t ads_index;
+
+void startADSConversion(uint8_t channel) {
+    uint16_t config =
+        ADS1015_REG_CONFIG_CQUE_NONE |
+        ADS1015_REG_CONFIG_CLAT_NONLAT |
+        ADS1015_REG_CONFIG_CPOL_ACTVLOW |
+        ADS1015_REG_CONFIG_CMODE_TRAD |
+        ADS1015_REG_CONFIG_DR_1600SPS |
+        ADS1015_REG_CONFIG_MODE_SINGLE;
+    config |= ads.getGain();
+    switch (channel) {
+    case 0:
+        config |= ADS1015_REG_CONFIG_MUX_SINGLE_0;
+        break;
+    case 1:
+        config |= ADS1015_REG_CONFIG_MUX_SINGLE_1;
+        break;
+    case 2:
+        config |= ADS1015_REG_CONFIG_MUX_SINGLE_2;
+        break;
+    case 3:
+        config |= ADS1015_REG_CONFIG_MUX_SINGLE_3;
+        break;
+    }
+    config |= ADS1015_REG_CONFIG_OS_SINGLE;
+    i2c_write16(ADS1115_I2C, ADS1015_REG_POINTER_CONFIG, config);
+}
+
+void startADS(void) {
+    ads_index = 0;
+    for (uint8_t i = 0; i < ads_count; i++) {
+        *ads_values[i] = 0;
+    }
+    startADSConversion(ads_channels[ads_index]);
+}
+
+bool readyADS(void) {
+    if (ads_index >= ads_count) {
+        return true;
+    }
+    uint16_t config = i2c_read16(ADS1115_I2C, ADS1015_REG_POINTER_CONFIG);
+    if ((config & ADS1015_REG_CONFIG_OS_MASK) == 0) {
+        return false; // conversion in progress
+    }
+    *ads_values[ads_index] = i2c_read16(ADS1115_I2C, ADS1015_REG_POINTER_CONVERT);
+    if (++ads_index < ads_count) {
+        startADSConversion(ads_channels[ads_index]);
+        return false;
+    }
+    return true;
+}
 
 void readADS() {
-    ads_reference = ads.readADC_SingleEnded(3);
     notification.info(F("ADC reference value (3V3): "), ads_reference);
 }
 
@@ -562,6 +820,48 @@ void setupSensorsViaI2C() {
     #endif
 }
 
+void setupExtender() {
+    // Setup I2C extender with all devices connected to the extended bus.
+
+    i2c_extender.begin();
+
+    #ifdef BME280_ON
+    i2c_extender.device(BME280_I2C, I2C_EXTENDER_SETTLE_MAX, BMx280_REGISTER_CHIPID, BMx280_CHIPID_BME280);
+    #endif
+
+    #ifdef BMP280_ON
+    i2c_extender.device(BMP280_I2C, I2C_EXTENDER_SETTLE_MAX, BMx280_REGISTER_CHIPID, BMx280_CHIPID_BMP280);
+    #endif
+
+    #ifdef SHT30_ON
+    i2c_extender.device(SHT30_I2C, I2C_EXTENDER_SETTLE_MAX);
+    #endif
+
+    #ifdef TSL2561_ON
+    i2c_extender.device(TSL2561_I2C, I2C_EXTENDER_SETTLE_MAX);
+    #endif
+
+    #ifdef VEML6070_ON
+    i2c_extender.device(VEML6070_ADDR_L, I2C_EXTENDER_SETTLE_MAX);
+    #endif
+
+    #ifdef ADS1115_ON
+    i2c_extender.device(ADS1115_I2C, I2C_EXTENDER_SETTLE_MAX);
+    #endif
+}
+
+bool activateExtender() {
+    // Activate I2C extender and profile the time until its devices are ready.
+
+    if (!i2c_extender.activate()) {
+        return false;
+    }
+    notification.info_millis(F("*I2C: First device responding after ... "), i2c_extender.powerUpMillis());
+    notification.info_millis(F("*I2C: All devices ready after ... "), i2c_extender.readyMillis());
+    profiler.add(Profiler::extender, i2c_extender.readyMillis() * 1000UL);
+    return true;
+}
+
 void setupSensorsViaADS() {
     // Setup all sensors connected via analog-digital-converter.
 
@@ -574,6 +874,35 @@ void setupSensorsViaADS() {
     #endif
 }
 
+void setupAcquisition() {
+    // Setup two-phase acquisition for all sensors with a conversion time.
+    // Note: Sensors without means to start a conversion (DHT22, TSL2561) are read directly.
+
+    #ifdef DS18B20_ON
+    acquisition.add(startDS18B20, readyDS18B20, maxMillisDS18B20());
+    #endif
+
+    #if defined (SHT30_ON)
+    acquisition.add(startSHT30, readySHT30, 20);
+    #endif
+
+    #if defined (BMP280_ON) && ! defined (BME280_ON)
+    acquisition.add(startBMP280, readyBMP280, 10);
+    #endif
+
+    #if defined (BME280_ON) && ! defined (BMP280_ON)
+    acquisition.add(startBME280, readyBME280, 15);
+    #endif
+
+    #ifdef VEML6070_ON
+    acquisition.add(NULL, NULL, VEML6070_INTEGRATION_MILLIS);
+    #endif
+
+    #ifdef ADS1115_ON
+    acquisition.add(startADS, readyADS, ads_count * ADS1115_CONVERSION_MILLIS + 5);
+    #endif
+}
+
 
 void setup() {
     SERIAL_BEGIN();
@@ -588,47 +917,109 @@ void setup() {
 
     testSwitch.begin();
 
+    // A Memory object is used to manage data kept in RTC memory during deep sleep.
+    if (!memory.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin memory"), 7);
+    }
+    // A Wake object is used to plan deep sleep. Note: This wake may only continue a long sleep.
+    if (!wake.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin wake"), 12);
+    }
+    #if defined (PROFILE_ON)
+    // A Profiler object is used to measure phases of wakes, which are sent as diagnostics.
+    if (!profiler.begin(SKETCH_VERSION)) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin profiler"), 13);
+    }
+    #endif
+    #if defined (ENERGY_ON)
+    // An Energy object is used to estimate the charge drawn per cycle, which is sent as well.
+    energy.current(Energy::active, ENERGY_CURRENT_ACTIVE);
+    energy.current(Energy::sleep, ENERGY_CURRENT_SLEEP);
+    energy.current(Energy::radio, ENERGY_CURRENT_RADIO);
+    energy.current(Energy::transmit, ENERGY_CURRENT_TRANSMIT);
+    energy.current(Energy::sensors, ENERGY_CURRENT_SENSORS);
+    energy.current(Energy::led, ENERGY_CURRENT_LED);
+    if (!energy.begin(SKETCH_VERSION)) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin energy"), 14);
+    }
+    #endif
     // A Files object is used to manage a file-system in Flash memory.
+    profiler.start(Profiler::files);
     if (!files.begin()) {
         TERMINATE_FATAL_BLINK(F("Failed: begin files"), 1);
     }
+    profiler.stop(Profiler::files);
     // A Values object is used to manage a value-store in Flash memory.
     if (!values.begin(&files)) {
         TERMINATE_FATAL_BLINK(F("Failed: begin values"), 2);
     }
 
     // A Network object is used to manage local network access.
-    if (!driver_network.begin(&values)) {
+    if (!driver_network.begin(&values, &driver_clock)) {
         TERMINATE_FATAL_BLINK(F("Failed: begin network"), 3);
     }
 
-    #if defined(NETWORK_ON)
-    if (driver_network.connect()) {
+    // Keep the radio off while acquiring sensor readings, it is brought up once per wake cycle
+    // when pushing readings (see loop).
+    System::wifiOff();
 
-        #ifdef OTA_ON
-        if (ota.begin()) {
-            ota.performUpdate();
-        }
-        else {
-            TERMINATE_FATAL_BLINK(F("Failed: begin update"), 5);
-        }
-        #endif
+    #ifdef OTA_ON
+    if (!ota.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin update"), 5);
+    }
+    #endif
 
-        if (driver_clock.begin()) {
-            if (driver_clock.isRunning() && driver_clock.isIndeterminate()) {
-                driver_clock.sync();
-            }
-        }
-        else {
-            TERMINATE_FATAL_BLINK(F("Failed: begin clock"), 6);
-        }
+    if (!driver_clock.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin clock"), 6);
+    }
 
-        driver_network.disconnect();
+    #if defined (BATCH_ON)
+    if (!batch.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin batch"), 8);
     }
-    else {
-        TERMINATE_FATAL_BLINK_RESTART(F("Failed: connect to network"), 4);
+    #endif
+
+    #if defined (AGGREGATE_ON)
+    if (!aggregate.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin aggregate"), 15);
+    }
+    #endif
+
+    #if defined (JOURNAL_ON)
+    if (!journal.begin(&files)) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin journal"), 9);
     }
-    #endif // NETWORK_ON
+    #endif
+
+    #if defined (DEADBAND_ON) && ! defined (BATCH_ON) && ! defined (AGGREGATE_ON)
+    deadband.threshold(Readings::temperature, DEADBAND_TEMPERATURE);
+    deadband.threshold(Readings::temperature_alternate, DEADBAND_TEMPERATURE);
+    deadband.threshold(Readings::temperature_external, DEADBAND_TEMPERATURE);
+    deadband.threshold(Readings::temperature_external2, DEADBAND_TEMPERATURE);
+    deadband.threshold(Readings::temperature_external3, DEADBAND_TEMPERATURE);
+    deadband.threshold(Readings::humidity, DEADBAND_HUMIDITY);
+    deadband.threshold(Readings::humidity_alternate, DEADBAND_HUMIDITY);
+    deadband.threshold(Readings::pressure, DEADBAND_PRESSURE);
+    deadband.threshold(Readings::voltage, DEADBAND_VOLTAGE);
+    deadband.threshold(Readings::illuminance, DEADBAND_ILLUMINANCE);
+    deadband.threshold(Readings::uvintensity, DEADBAND_UVINTENSITY);
+    if (!deadband.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin deadband"), 16);
+    }
+    #endif
+
+    #if defined (SCHEDULE_ON)
+    scheduler.rate(Readings::temperature, SCHEDULE_RATE_TEMPERATURE);
+    scheduler.rate(Readings::temperature_external, SCHEDULE_RATE_TEMPERATURE);
+    scheduler.rate(Readings::temperature_external2, SCHEDULE_RATE_TEMPERATURE);
+    scheduler.rate(Readings::temperature_external3, SCHEDULE_RATE_TEMPERATURE);
+    scheduler.rate(Readings::humidity, SCHEDULE_RATE_HUMIDITY);
+    scheduler.rate(Readings::pressure, SCHEDULE_RATE_PRESSURE);
+    scheduler.voltage(SCHEDULE_VOLTAGE_FULL, SCHEDULE_VOLTAGE_LOW, SCHEDULE_VOLTAGE_STRETCH);
+    if (!scheduler.begin()) {
+        TERMINATE_FATAL_BLINK(F("Failed: begin scheduler"), 17);
+    }
+    #endif
 
     // setup internal measurements
     setupVoltage();
@@ -637,18 +1028,21 @@ void setup() {
     setupSensorsViaOneWire();
 
     // activate i2c extender if enabled
-    i2c_extender.begin();
-    i2c_extender.activate();
+    setupExtender();
+    activateExtender();
 
     // setup I2C sensors
     setupSensorsViaI2C();
 
     // setup analog sensors
     setupSensorsViaADS();
+
+    // setup acquisition of all sensors
+    setupAcquisition();
 }
 
 
-void deepSleepAndResetAfter(unsigned long sleep_millis);
+bool isFirstCycleAfterPowerOn();
 
 void loop() {
     #ifdef TEST_SWITCH_ON
@@ -657,21 +1051,40 @@ void loop() {
     bool test = !PRODUCTION;
     #endif
 
-    notification.info(F("Weather Device running ... "),
+    NOTIFICATION_INFO(F("Weather Device running ... "),
         DEVICE_ID + "/" + String(SKETCH_VERSION)
     );
 
     notification.info(F("Get readings from sensors ..."));
     elapsed_millis get_readings_elapsed; // measure time needed for reading
 
+    #if defined (ALIGN_ON)
+    driver_clock.mark();
+    #endif
+
     // activate i2c extender if enabled
-    if (i2c_extender.activate()) {
+    if (activateExtender()) {
         setupSensorsViaI2C();
         setupSensorsViaADS();
     }
 
+    // start conversions of all sensors, then wait once for the slowest sensor
+    elapsed_millis conversions_elapsed;
+    energy.start(Energy::sensors);
+    acquisition.start();
+    notification.info_millis(F("Done starting conversions ... "), conversions_elapsed);
+    conversions_elapsed = 0;
+    profiler.start(Profiler::conversion);
+    if (!acquisition.wait()) {
+        notification.warn(F("Timeout waiting for sensors!"));
+    }
+    profiler.stop(Profiler::conversion);
+    notification.info_millis(F("Done waiting for conversions ... "), conversions_elapsed);
+
     #ifdef ADS1115_ON
+    profiler.start(Profiler::ads1115);
     readADS(); // get reference for analogue digital converter
+    profiler.stop(Profiler::ads1115);
     #endif
 
     // get readings from sensors
@@ -681,35 +1094,51 @@ void loop() {
     readVoltage(&readings);
 
     #ifdef DS18B20_ON
+    profiler.start(Profiler::ds18b20);
     readDS18B20(&readings);
+    profiler.stop(Profiler::ds18b20);
     #endif
 
     #if defined (SHT30_ON)
+    profiler.start(Profiler::sht30);
     readSHT30(&readings);
+    profiler.stop(Profiler::sht30);
     #endif
 
     #if defined (BMP280_ON) && ! defined (BME280_ON)
+    profiler.start(Profiler::bmx280);
     readBMP280(&readings);
+    profiler.stop(Profiler::bmx280);
     #endif
 
     #if defined (BME280_ON) && ! defined (BMP280_ON)
+    profiler.start(Profiler::bmx280);
     readBME280(&readings);
+    profiler.stop(Profiler::bmx280);
     #endif
 
     #ifdef DHT22_ON
+    profiler.start(Profiler::dht22);
     readDHT22(&readings);
+    profiler.stop(Profiler::dht22);
     #endif
 
     #ifdef TSL2561_ON
+    profiler.start(Profiler::tsl2561);
     readTSL2561(&readings);
+    profiler.stop(Profiler::tsl2561);
     #endif
 
     #ifdef VEML6070_ON
+    profiler.start(Profiler::veml6070);
     readVEML6070(&readings);
+    profiler.stop(Profiler::veml6070);
     #endif
 
-    #if defined (ML8511_ON) && defined (ADS1115)
+    #if defined (ML8511_ON) && defined (ADS1115_ON)
+    profiler.start(Profiler::ads1115);
     readML8511(&readings);
+    profiler.stop(Profiler::ads1115);
     #endif
 
     if (!PRODUCTION) {
@@ -718,83 +1147,275 @@ void loop() {
 
     // deactivate i2c extender if enabled
     i2c_extender.deactivate();
+    energy.stop(Energy::sensors);
 
     unsigned long get_readings_millis = get_readings_elapsed; // get time needed for reading
     notification.info_millis(F("Done getting readings from sensors ... "), get_readings_millis);
 
 
     // push readings to server
-    #if defined (NETWORK_ON) && defined (TRANSPORT_ON)
-
-    notification.info(F("Push readings to server ..."),
-        test ? F("TEST") : TRANSPORT_DATABASE
-    );
-    elapsed_millis push_readings_elapsed; // measure time needed for sending
+    // Note: The network is brought up at most once per wake cycle and shared by update, clock
+    // and transport. The radio is off otherwise.
+    #if defined (NETWORK_ON)
+
+    #if defined (BATCH_ON)
+    // keep readings and push them when the batch is due (and on first cycle after power on)
+    batch.add(readings);
+    bool push = batch.isDue() || isFirstCycleAfterPowerOn();
+    #elif defined (AGGREGATE_ON)
+    // push statistics only if the window is over (and on first cycle after power on)
+    bool push = aggregate.isDue(driver_clock.unixtime()) || isFirstCycleAfterPowerOn();
+    #elif defined (DEADBAND_ON)
+    // push readings only if changed beyond deadband (and on first cycle after power on)
+    bool push = deadband.isDue(readings) || isFirstCycleAfterPowerOn();
+    #else
+    bool push = true;
+    #endif
+    bool pushed = false;
+
+    // the radio may be disabled on this wake, then push readings on the next wake
+    bool deferred = push && !wake.isRadioEnabled();
+    if (deferred) {
+        notification.info(F("Defer pushing readings to next cycle ... "));
+        #if defined (JOURNAL_ON) && ! defined (BATCH_ON) && ! defined (AGGREGATE_ON)
+        journal.append(readings, driver_clock.unixtime());
+        #endif
+        push = false;
+    }
 
-    if (driver_network.connect()) {
-        driver_clock.sync();
+    unsigned long push_readings_millis = 0;
 
-        Transport transport(
-            TRANSPORT_SERVER,
-            TRANSPORT_PORT,
-            test ? "test" : TRANSPORT_DATABASE,
-            DEVICE_ID,
-            PROBE_LOCATION
+    if (push) {
+        NOTIFICATION_INFO(F("Push readings to server ..."),
+            test ? F("TEST") : TRANSPORT_DATABASE
         );
-        if (transport.begin(&driver_network)) {
-            if (transport.send(readings)) {
-                notification.info(F("Sent readings!"));
+        elapsed_millis push_readings_elapsed; // measure time needed for sending
+
+        if (driver_network.connect()) {
+            #ifdef OTA_ON
+            if (network_sessions == 0) {
+                ota.performUpdate();
+            }
+            #endif
+
+            // timestamps are needed for batched and journaled readings, so sync the clock before
+            // sending if its time is not known, otherwise prefer the server time (see below)
+            if (driver_clock.isSyncDue() && (driver_clock.unixtime() == 0)) {
+                driver_clock.sync();
+            }
+
+            #ifdef TRANSPORT_ON
+            Transport transport(
+                TRANSPORT_SERVER.c_str(),
+                TRANSPORT_PORT,
+                test ? "test" : TRANSPORT_DATABASE.c_str(),
+                DEVICE_ID.c_str(),
+                PROBE_LOCATION.c_str()
+            );
+            if (transport.begin(&driver_network, TRANSPORT_COMPRESSED)) {
+                #if defined (PROFILE_ON)
+                transport.diagnose(&profiler);
+                #endif
+                #if defined (ENERGY_ON)
+                transport.account(&energy);
+                #endif
+                #if defined (BATCH_ON)
+                bool sent = false;
+                uint32_t unixtime = driver_clock.unixtime();
+                if (unixtime > 0) {
+                    sent = transport.send(batch, unixtime);
+                    if (sent) {
+                        batch.clear();
+                    }
+                }
+                else {
+                    notification.warn(F("Failed to get time for batched readings!"));
+                }
+                #elif defined (AGGREGATE_ON)
+                // only a window which is over is sent, readings of this cycle start the next one
+                bool sent = true;
+                if (aggregate.isDue(driver_clock.unixtime())) {
+                    sent = transport.send(aggregate, driver_clock.unixtime());
+                    if (sent) {
+                        aggregate.clear();
+                    }
+                }
+                #else
+                bool sent = transport.send(readings);
+                #endif
+                pushed = sent;
+                if (sent) {
+                    notification.info(F("Sent readings!"));
+                }
+                else {
+                    notification.warn(F("Failed to send readings!"));
+                }
+                #if defined (JOURNAL_ON) && ! defined (BATCH_ON) && ! defined (AGGREGATE_ON)
+                if (sent) {
+                    // replay readings, which could not be sent before
+                    if (journal.pending() > 0) {
+                        if (transport.send(journal)) {
+                            notification.info(F("Replayed journal readings!"));
+                        }
+                        else {
+                            notification.warn(F("Failed to replay journal readings!"));
+                        }
+                    }
+                }
+                else {
+                    journal.append(readings, driver_clock.unixtime());
+                }
+                #endif
             }
             else {
-                notification.warn(F("Failed to send readings!"));
+                notification.warn(F("Failed to begin transport!"));
+            }
+
+            if (driver_clock.isSyncDue()) {
+                unsigned long server_time_at;
+                uint32_t server_time = transport.serverTime(server_time_at);
+                if (server_time > 0) {
+                    driver_clock.sync(server_time, server_time_at);
+                    NOTIFICATION_INFO(F("Time (server): "), driver_clock.formatISO8601());
+                }
+            }
+            #endif
+
+            // fall back to NTP if the server gave no time
+            if (driver_clock.isSyncDue()) {
+                driver_clock.sync();
             }
+
+            driver_network.disconnect();
         }
         else {
-            notification.warn(F("Failed to begin transport!"));
+            // turn the radio off, a failed attempt leaves it on
+            driver_network.disconnect();
+
+            // fail hard on the first session after power on or reset, only
+            if (isFirstCycleAfterPowerOn()) {
+                TERMINATE_FATAL_BLINK_RESTART(F("Failed: connect to network"), 4);
+            }
+            notification.warn(F("Failed to connect to network!"));
+            #if defined (JOURNAL_ON) && ! defined (BATCH_ON) && ! defined (AGGREGATE_ON)
+            journal.append(readings, driver_clock.unixtime());
+            #endif
         }
+        network_sessions++;
 
-        driver_network.disconnect();
+        push_readings_millis = push_readings_elapsed; // get time needed for sending
+        notification.info_millis(F("Done pushing readings to server ... "), push_readings_millis);
     }
+    #if defined (BATCH_ON)
     else {
-        notification.warn(F("Failed to connect to network!"));
+        notification.info(F("Keep readings for later ... "), batch.count());
     }
+    #elif defined (AGGREGATE_ON)
+    else if (!deferred) {
+        notification.info(F("Aggregate readings ... "), aggregate.count());
+    }
+    aggregate.add(readings, driver_clock.unixtime());
+    #elif defined (DEADBAND_ON)
+    else if (!deferred) {
+        notification.info(F("Skip pushing readings within deadband ... "));
+    }
+    deadband.update(readings, pushed);
+    #endif
 
-    unsigned long push_readings_millis = push_readings_elapsed; // get time needed for sending
-    notification.info_millis(F("Done pushing readings to server ... "), push_readings_millis);
-
-    #else // defined (NETWORK_ON) && defined (TRANSPORT_ON)
+    #else // defined (NETWORK_ON)
 
-    notification.info(F("Skip pushing readings to server ... "),
+    NOTIFICATION_INFO(F("Skip pushing readings to server ... "),
         test ? F("TEST") : TRANSPORT_DATABASE
     );
 
-    #endif // defined (NETWORK_ON) && defined (TRANSPORT_ON)
+    #endif // defined (NETWORK_ON)
 
     // loop
 
-    long interval = MEASURING_INTERVAL - get_readings_millis - 500;
-    #if defined (NETWORK_ON) && defined (TRANSPORT_ON)
+    profiler.start(Profiler::sleep);
+
+    #if defined (SCHEDULE_ON)
+    long measuring_interval = scheduler.next(readings);
+    notification.info_millis(F("*Measuring interval "), measuring_interval);
+    #else
+    long measuring_interval = MEASURING_INTERVAL;
+    #endif
+    long interval = measuring_interval - get_readings_millis - 500;
+    #if defined (NETWORK_ON)
     interval = interval - push_readings_millis;
     #endif
     long interval_delay = std::max(interval, MEASURING_INTERVAL_DELAY_MIN);
+    #if defined (ALIGN_ON)
+    // spread devices over the first seconds of each interval
+    unsigned long align_phase = 1000UL *
+        (Memory::checksum(DEVICE_ID.c_str(), DEVICE_ID.length()) % ALIGN_SPREAD);
+    // the grid is that of the base interval, so it stays the same while the scheduler changes the
+    // interval: stretched cycles start at the point of the grid nearest to the interval, shortened
+    // cycles at the nearest point of an even division of the grid
+    long align_interval = MEASURING_INTERVAL /
+        std::max(1L, (MEASURING_INTERVAL + measuring_interval / 2) / measuring_interval);
+    unsigned long align_delay = driver_clock.align(align_interval, align_phase,
+        std::max(interval_delay - align_interval / 2, MEASURING_INTERVAL_DELAY_MIN)
+    );
+    if (align_delay > 0) {
+        interval_delay = align_delay;
+    }
+    #endif
     #ifdef DEEPSLEEP_ON
     notification.info_millis(F("*Sleeping for "), interval_delay);
-    delay(500);
-    deepSleepAndResetAfter(interval_delay);
+    driver_clock.elapse(interval_delay);
+    #if defined (BATCH_ON)
+    batch.elapse(interval_delay);
+    #endif
+    #if defined (DEADBAND_ON) && ! defined (BATCH_ON) && ! defined (AGGREGATE_ON)
+    deadband.elapse(interval_delay);
+    #endif
+    #if defined (SCHEDULE_ON)
+    scheduler.elapse(interval_delay);
+    #endif
+    // the next cycle needs the radio only if pushing readings
+    #if defined (NETWORK_ON) && defined (BATCH_ON)
+    bool radio = batch.isDue(1) || deferred;
+    #elif defined (NETWORK_ON) && defined (AGGREGATE_ON)
+    // the window may be over on the next cycle
+    bool radio = aggregate.isDue(driver_clock.unixtime() + (interval_delay + 999) / 1000) ||
+        deferred;
+    #elif defined (NETWORK_ON) && defined (DEADBAND_ON)
+    // readings changing beyond the deadband are deferred to the next cycle
+    bool radio = deadband.isDue() || deferred;
+    #elif defined (NETWORK_ON)
+    bool radio = true;
+    #else
+    bool radio = false;
+    #endif
+    notification.flush();
+    profiler.end(driver_clock.unixtime());
+    energy.end(driver_clock.unixtime(), interval_delay);
+    wake.sleep(interval_delay, radio);
     #else
     notification.info_millis(F("*Delaying for "), interval_delay);
-    delay(500);
+    #if defined (BATCH_ON)
+    batch.elapse(interval_delay);
+    #endif
+    #if defined (DEADBAND_ON) && ! defined (BATCH_ON) && ! defined (AGGREGATE_ON)
+    deadband.elapse(interval_delay);
+    #endif
+    #if defined (SCHEDULE_ON)
+    scheduler.elapse(interval_delay);
+    #endif
+    profiler.end(driver_clock.unixtime());
+    energy.end(driver_clock.unixtime(), 0);
     delay(interval_delay);
     #endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-/// Deep sleep for the specified amount of milliseconds and start again with reset.
-void deepSleepAndResetAfter(unsigned long sleep_millis) {
+/// Checks if running the first cycle after power on or reset (as opposed to a deep sleep wake).
+bool isFirstCycleAfterPowerOn() {
     #if defined(ESP8266) || defined(ESP32)
-    ESP.deepSleep(sleep_millis * 1000);
+    return (network_sessions == 0) && !System::lastResetReasonIsDeepSleepAwake();
     #else
-    delay(sleep_millis);
+    return network_sessions == 0;
     #endif
 }
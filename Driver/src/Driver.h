@@ -7,6 +7,8 @@
 
 // DEVICE CONFIGURATION
 
+#include "Driver_Mode.h"
+
 #if defined(WEATHER_STATION)
 #include "Driver_WeatherStation.h"
 #elif defined(WEATHER_STICK)
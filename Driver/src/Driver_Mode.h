@@ -0,0 +1,13 @@
+#ifndef __DRIVER_MODE_H__
+#define __DRIVER_MODE_H__
+
+///////////////////
+// Mode
+
+// Toggle for production or development mode, also given as build flag -DPRODUCTION_MODE=true.
+// Kept apart from the device configuration, as all modules depend on it (see Notification.h).
+#if !defined(PRODUCTION_MODE)
+#define PRODUCTION_MODE false
+#endif
+
+#endif
@@ -5,7 +5,7 @@
 
 const String PROBE_LOCATION { "terrace" };
 
-#define PRODUCTION_MODE false
+// Production or development mode: see Driver_Mode.h
 
 #define TEST_SWITCH_ON
 
@@ -26,6 +26,79 @@ const String PROBE_LOCATION { "terrace" };
 // Enable transport to InfluxDB server: Undef to disable sending measurements.
 #define TRANSPORT_ON
 
+// Enable compression of requests to InfluxDB server: Undef to send requests uncompressed.
+// Requests with more than one line (batches and journal replays) are sent gzip encoded.
+#define TRANSPORT_GZIP_ON
+
+// Enable batching of readings: Undef to push readings on every measuring cycle.
+// Readings are kept in RTC memory and pushed every BATCH_CYCLES measuring cycles. The radio is
+// disabled on cycles in between (deep sleep mode only). RTC memory keeps BATCH_CAPACITY (6)
+// records, so BATCH_CYCLES must not exceed it.
+#undef BATCH_ON
+#define BATCH_CYCLES 4
+
+// Enable aggregation of readings: Undef to push readings of every measuring cycle.
+// Statistics of every reading (mean, minimum, maximum, standard deviation and number of values)
+// are kept in RTC memory over windows of AGGREGATE_WINDOW seconds, aligned to the wall-clock, and
+// pushed as measurement weather_stats, one point per window (not used with batching of readings).
+// Journal and send-on-delta are not used with aggregation.
+#undef AGGREGATE_ON
+#define AGGREGATE_WINDOW 900
+
+// Enable journal of readings: Undef to drop readings, which could not be pushed.
+// Readings are kept in Flash memory and pushed later (not used with batching of readings).
+#define JOURNAL_ON
+
+// Enable send-on-delta: Undef to push readings on every measuring cycle.
+// Readings are only pushed if any value changed by more than its deadband since the last push,
+// but at least every DEADBAND_HEARTBEAT seconds (not used with batching of readings).
+#define DEADBAND_ON
+#define DEADBAND_HEARTBEAT 3600 // s
+#define DEADBAND_TEMPERATURE 0.2 // °C
+#define DEADBAND_HUMIDITY 1.0 // %
+#define DEADBAND_PRESSURE 20.0 // Pa
+#define DEADBAND_VOLTAGE 50.0 // mV
+#define DEADBAND_ILLUMINANCE 10.0 // lux
+#define DEADBAND_UVINTENSITY 0.1 // mW/cm^2
+
+// Enable adaptive measuring interval: Undef to measure in a fixed interval.
+// The interval is shortened while readings change faster than the given rates, stretched up to
+// SCHEDULE_STRETCH times while readings are stable, and stretched up to SCHEDULE_VOLTAGE_STRETCH
+// times more while the voltage drops from SCHEDULE_VOLTAGE_FULL to SCHEDULE_VOLTAGE_LOW.
+#define SCHEDULE_ON
+#define SCHEDULE_STRETCH 3
+#define SCHEDULE_RATE_TEMPERATURE 2.0 // °C per hour
+#define SCHEDULE_RATE_HUMIDITY 10.0 // % per hour
+#define SCHEDULE_RATE_PRESSURE 100.0 // Pa per hour
+#define SCHEDULE_VOLTAGE_FULL 3200 // mV
+#define SCHEDULE_VOLTAGE_LOW 2900 // mV
+#define SCHEDULE_VOLTAGE_STRETCH 4
+
+// Enable measuring aligned to the wall-clock: Undef to measure relative to the last cycle.
+// Measuring cycles start at multiples of the measuring interval since midnight, delayed by a
+// phase derived from the device id of up to ALIGN_SPREAD seconds (keeps the clock). With an
+// adaptive measuring interval, cycles start at the nearest multiple of the measuring interval or
+// of an even division of it.
+#define ALIGN_ON
+#define ALIGN_SPREAD 30
+
+// Enable profiling of wakes: Undef to disable profiling.
+// Spans of the phases of the last wakes are sent as measurement weather_diag with the next
+// readings (tagged with the firmware version).
+#define PROFILE_ON
+
+// Enable energy accounting: Undef to disable accounting.
+// The charge drawn per measuring cycle is estimated from the time spent awake and asleep and the
+// time the radio, the sensors and the LED are on, using the following currents of the board.
+// The running total is sent as measurement weather_energy with the next readings.
+#define ENERGY_ON
+#define ENERGY_CURRENT_ACTIVE 15.0 // mA
+#define ENERGY_CURRENT_SLEEP 0.02 // mA
+#define ENERGY_CURRENT_RADIO 55.0 // mA, in addition to active
+#define ENERGY_CURRENT_TRANSMIT 100.0 // mA, in addition to radio
+#define ENERGY_CURRENT_SENSORS 1.0 // mA
+#define ENERGY_CURRENT_LED 5.0 // mA
+
 // Enable I2C debug mode: Undef to disable debug mode.
 #undef I2C_DEBUG_ON
 
@@ -43,5 +116,12 @@ const String PROBE_LOCATION { "terrace" };
 #undef VEML6070_ON
 #undef ML8511_ON
 
+// DS18B20 probes on the 1-Wire bus, up to 3, sent as temperature1, temperature2 and temperature3.
+// Per probe: resolution in bits (9 to 12, a conversion takes 94 to 750 ms) and calibration, which
+// are the raw readings of the probe at the references 0.01 °C and 100 °C.
+#define DS18B20_PROBES 1
+#define DS18B20_RESOLUTIONS { 12 }
+#define DS18B20_CALIBRATIONS { { 1.4, 98.8 } }
+
 // Enable over-the-air updates (network must be enabled, too).
 #undef OTA_ON
@@ -9,7 +9,6 @@ const String PROBE_LOCATION { "bedroom" };
 const String PROBE_LOCATION { "unknown" };
 #endif
 
-#define PRODUCTION_MODE false
 #undef TEST_SWITCH_ON
 
 #if defined(ARDUINO_M5Stick_C)
@@ -21,6 +20,39 @@ const String PROBE_LOCATION { "unknown" };
 #define DEEPSLEEP_ON
 #define NETWORK_ON
 #define TRANSPORT_ON
+#define TRANSPORT_GZIP_ON
+#undef BATCH_ON
+#define BATCH_CYCLES 4 // at most BATCH_CAPACITY (6)
+#undef AGGREGATE_ON
+#define AGGREGATE_WINDOW 900
+#define JOURNAL_ON
+#define DEADBAND_ON
+#define DEADBAND_HEARTBEAT 3600
+#define DEADBAND_TEMPERATURE 0.2
+#define DEADBAND_HUMIDITY 1.0
+#define DEADBAND_PRESSURE 20.0
+#define DEADBAND_VOLTAGE 50.0
+#define DEADBAND_ILLUMINANCE 10.0
+#define DEADBAND_UVINTENSITY 0.1
+#define SCHEDULE_ON
+#define SCHEDULE_STRETCH 3
+#define SCHEDULE_RATE_TEMPERATURE 2.0
+#define SCHEDULE_RATE_HUMIDITY 10.0
+#define SCHEDULE_RATE_PRESSURE 100.0
+#define SCHEDULE_VOLTAGE_FULL 3200
+#define SCHEDULE_VOLTAGE_LOW 2900
+#define SCHEDULE_VOLTAGE_STRETCH 4
+#define ALIGN_ON
+#define ALIGN_SPREAD 30
+#define PROFILE_ON
+#define ENERGY_ON
+#define ENERGY_CURRENT_ACTIVE 40.0
+#define ENERGY_CURRENT_SLEEP 0.15
+#define ENERGY_CURRENT_RADIO 80.0
+#define ENERGY_CURRENT_TRANSMIT 100.0
+#define ENERGY_CURRENT_SENSORS 1.0
+#define ENERGY_CURRENT_LED 5.0
+
 #undef I2C_DEBUG_ON
 #undef I2C_EXTENDER_ON
 
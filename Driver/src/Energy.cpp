@@ -0,0 +1,127 @@
+#include <Arduino.h>
+
+#include "Energy.h"
+
+#include "Memory.h"
+
+extern Memory memory;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    uint64_t charge; // µA·ms since power on
+    uint64_t cycle_charge; // µA·ms of the last cycle
+    uint32_t cycles;
+    uint32_t unixtime; // time at the end of the last wake
+    uint16_t version;
+    uint16_t voltage; // mV at the end of the last wake
+} energy_t;
+
+static_assert(sizeof(energy_t) <= MEMORY_ENERGY_SIZE, "Energy block too small");
+
+static energy_t energy_total;
+
+// Converts the given charge in µA·ms to mAh.
+static float energy_mah(uint64_t charge) {
+    return charge / 3600000000.0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Energy::Energy(void) {
+    started = false;
+    version = 0;
+    // typical currents of an ESP8266 module
+    currents[active] = 15000;
+    currents[sleep] = 20;
+    currents[radio] = 55000;
+    currents[transmit] = 100000;
+    currents[sensors] = 1000;
+    currents[led] = 5000;
+    wake_start = 0;
+    memset(starts, 0, sizeof(starts));
+    memset(spans, 0, sizeof(spans));
+    running = 0;
+}
+
+bool Energy::begin(uint16_t version) {
+    this->version = version;
+    if (!memory.load(Memory::energy, &energy_total, sizeof(energy_total))) {
+        memset(&energy_total, 0, sizeof(energy_total));
+    }
+    started = true;
+    // the wake started with the boot
+    wake_start = 0;
+    return true;
+}
+
+void Energy::current(load load, float milliamperes) {
+    currents[load] = milliamperes * 1000;
+}
+
+void Energy::start(load load) {
+    if (!started) {
+        return;
+    }
+    starts[load] = micros();
+    running |= 1UL << load;
+}
+
+void Energy::stop(load load) {
+    if (!started || !(running & (1UL << load))) {
+        return;
+    }
+    spans[load] += micros() - starts[load];
+    running &= ~(1UL << load);
+}
+
+void Energy::end(uint32_t unixtime, unsigned long sleep_millis) {
+    if (!started) {
+        return;
+    }
+    for (uint8_t i = 0; i <= LOAD_MAX; i++) {
+        stop((load) i);
+    }
+    unsigned long now = micros();
+    spans[active] = now - wake_start;
+
+    // µA·µs of the wake and the following sleep
+    uint64_t charge = (uint64_t) currents[sleep] * sleep_millis * 1000;
+    for (uint8_t i = 0; i <= LOAD_MAX; i++) {
+        charge += (uint64_t) currents[i] * spans[i];
+    }
+    charge /= 1000;
+
+    energy_total.charge += charge;
+    energy_total.cycle_charge = charge;
+    energy_total.cycles++;
+    energy_total.unixtime = unixtime;
+    energy_total.version = version;
+    #if defined(ESP8266)
+    energy_total.voltage = ESP.getVcc();
+    #else
+    energy_total.voltage = 0;
+    #endif
+    memory.save(Memory::energy, &energy_total, sizeof(energy_total));
+
+    // the next wake starts now if not sleeping deeply
+    memset(spans, 0, sizeof(spans));
+    wake_start = now;
+}
+
+bool Energy::get(uint32_t &unixtime, uint16_t &version, uint32_t &cycles,
+    float &charge, float &cycle_charge, uint16_t &voltage)
+{
+    if (energy_total.cycles == 0) {
+        return false;
+    }
+    unixtime = energy_total.unixtime;
+    version = energy_total.version;
+    cycles = energy_total.cycles;
+    charge = energy_mah(energy_total.charge);
+    cycle_charge = energy_mah(energy_total.cycle_charge);
+    voltage = energy_total.voltage;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,65 @@
+#ifndef __ENERGY_H__
+#define __ENERGY_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Operating Support:
+// Class to estimate the charge drawn from the battery. The time spent awake, the time spent
+// sleeping and the time each load is switched on are weighted with a current profile of the
+// board. At the end of each wake the charge of the measuring cycle (the wake and the following
+// sleep) is added to a running total kept in RTC memory, so the total is kept until power loss.
+// Short wakes continuing a long sleep are not accounted.
+// This is a no-op until begin is called.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Energy {
+public:
+    // Enumeration of loads of the current profile.
+    enum load {
+      active = 0, // while awake
+      sleep, // while sleeping deeply
+      radio, // WiFi on, in addition to active
+      transmit, // sending requests, in addition to radio
+      sensors, // converting sensors
+      led, // signaling LED on
+      LOAD_MAX = led
+    };
+
+    Energy(void);
+
+    // Begin accounting wakes of the given firmware version. Loads the running total from RTC
+    // memory (starting from zero after power on).
+    bool begin(uint16_t version);
+
+    // Sets the current drawn by the given load in mA.
+    void current(load load, float milliamperes);
+
+    // Switches the given load on.
+    void start(load load);
+    // Switches the given load off and adds its time. Does nothing if not switched on.
+    void stop(load load);
+
+    // Ends the current wake at the given time (seconds since 1970-01-01, 0 if unknown) before
+    // sleeping deeply for the given milliseconds (0 if not sleeping deeply). Switches all loads
+    // off, adds the charge of the cycle to the running total and samples the supply voltage.
+    void end(uint32_t unixtime, unsigned long sleep_millis);
+
+    // Gives the running total and the last cycle, if any cycle was accounted. Charges are in mAh,
+    // the voltage is in mV at the end of the last wake (0 if unknown).
+    bool get(uint32_t &unixtime, uint16_t &version, uint32_t &cycles,
+        float &charge, float &cycle_charge, uint16_t &voltage);
+
+private:
+    bool started;
+    uint16_t version;
+
+    uint32_t currents[LOAD_MAX + 1]; // µA
+
+    unsigned long wake_start; // micros() at the start of the current wake
+    unsigned long starts[LOAD_MAX + 1]; // micros() at the switching on of loads
+    uint32_t spans[LOAD_MAX + 1]; // µs
+    uint32_t running; // bit mask of loads switched on
+};
+
+#endif
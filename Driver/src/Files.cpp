@@ -73,3 +73,54 @@ bool Files::exists(String filename) {
     return false;
     #endif
 }
+
+bool Files::append(String filename, const void *data, size_t size) {
+    #if defined(ESP8266)
+    File outfile = SPIFFS.open(String(filename + ".dat"), "a");
+    if (outfile) {
+        size_t written = outfile.write(static_cast<const uint8_t *>(data), size);
+        outfile.close();
+        return written == size;
+    }
+    else {
+        notification.warn(F("Failed to write to file:"), filename);
+    }
+    #endif
+    return false;
+}
+
+size_t Files::read(String filename, size_t position, void *data, size_t size) {
+    #if defined(ESP8266)
+    File infile = SPIFFS.open(String(filename + ".dat"), "r");
+    if (infile) {
+        size_t read = 0;
+        if (infile.seek(position, SeekSet)) {
+            read = infile.read(static_cast<uint8_t *>(data), size);
+        }
+        infile.close();
+        return read;
+    }
+    else {
+        notification.warn(F("Failed to read from file:"), filename);
+    }
+    #endif
+    return 0;
+}
+
+size_t Files::size(String filename) {
+    #if defined(ESP8266)
+    File infile = SPIFFS.open(String(filename + ".dat"), "r");
+    if (infile) {
+        size_t size = infile.size();
+        infile.close();
+        return size;
+    }
+    #endif
+    return 0;
+}
+
+void Files::remove(String filename) {
+    #if defined(ESP8266)
+    SPIFFS.remove(String(filename + ".dat"));
+    #endif
+}
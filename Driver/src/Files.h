@@ -25,6 +25,19 @@ public:
     // Tests if a file with the given name exists.
     bool exists(String filename);
 
+    // Appends the given data to the file with the given name.
+    bool append(String filename, const void *data, size_t size);
+
+    // Reads data at the given position from the file with the given name. Returns number of bytes
+    // actually read.
+    size_t read(String filename, size_t position, void *data, size_t size);
+
+    // Returns the size of the file with the given name.
+    size_t size(String filename);
+
+    // Removes the file with the given name.
+    void remove(String filename);
+
 private:
 };
 
@@ -40,3 +40,39 @@ void i2c_scan() {
     }
     notification.info(F("*I2C: Number of devices found "), nDevices);
 }
+
+void i2c_write8(uint8_t address, uint8_t reg, uint8_t value) {
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    Wire.write(value);
+    Wire.endTransmission();
+}
+
+uint8_t i2c_read8(uint8_t address, uint8_t reg) {
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    Wire.endTransmission();
+    if (Wire.requestFrom(address, (uint8_t) 1) != 1) {
+        return 0;
+    }
+    return Wire.read();
+}
+
+void i2c_write16(uint8_t address, uint8_t reg, uint16_t value) {
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    Wire.write((uint8_t) (value >> 8));
+    Wire.write((uint8_t) (value & 0xFF));
+    Wire.endTransmission();
+}
+
+uint16_t i2c_read16(uint8_t address, uint8_t reg) {
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    Wire.endTransmission();
+    if (Wire.requestFrom(address, (uint8_t) 2) != 2) {
+        return 0;
+    }
+    uint16_t value = Wire.read() << 8;
+    return value | Wire.read();
+}
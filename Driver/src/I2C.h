@@ -1,7 +1,15 @@
 #ifndef __I2C_H__
 #define __I2C_H__
 
+#include <Arduino.h>
+
 void i2c_setup();
 void i2c_scan();
 
+// Register access for sensors which are operated without (or beside) their libraries.
+void i2c_write8(uint8_t address, uint8_t reg, uint8_t value);
+uint8_t i2c_read8(uint8_t address, uint8_t reg);
+void i2c_write16(uint8_t address, uint8_t reg, uint16_t value);
+uint16_t i2c_read16(uint8_t address, uint8_t reg);
+
 #endif
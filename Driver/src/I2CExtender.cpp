@@ -4,12 +4,18 @@
 
 #include "I2CExtender.h"
 
-#include "SERIAL.h"
+#include "I2C.h"
+#include "Notification.h"
+
+extern Notification notification;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 I2CExtender::I2CExtender(int enablepin) {
     this->enablepin = enablepin;
+    this->device_count = 0;
+    this->power_up_millis = 0;
+    this->ready_millis = 0;
 }
 
 bool I2CExtender::begin() {
@@ -20,6 +26,18 @@ bool I2CExtender::begin() {
     return true;
 }
 
+bool I2CExtender::device(uint8_t address, unsigned long settle_max, int chipid_register, uint8_t chipid) {
+    if (device_count >= I2C_EXTENDER_DEVICES_MAX) {
+        return false;
+    }
+    devices[device_count].address = address;
+    devices[device_count].chipid_register = chipid_register;
+    devices[device_count].chipid = chipid;
+    devices[device_count].settle_max = settle_max;
+    device_count++;
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 // returns true, if i2c extender has been activated
@@ -28,7 +46,48 @@ bool I2CExtender::activate(void) {
         int state = digitalRead(enablepin);
         if (state != HIGH) {
             digitalWrite(enablepin, HIGH);
-            delay(1000);
+            unsigned long start = millis();
+            if (device_count == 0) {
+                delay(I2C_EXTENDER_SETTLE_MILLIS);
+                power_up_millis = ready_millis = millis() - start;
+                return true;
+            }
+            i2c_setup();
+
+            // poll devices until all are ready or timed out
+            uint8_t pending = (1 << device_count) - 1;
+            bool responding = false;
+            power_up_millis = ready_millis = 0;
+            while (pending) {
+                unsigned long elapsed = millis() - start;
+                for (uint8_t index = 0; index < device_count; index++) {
+                    uint8_t mask = 1 << index;
+                    if (!(pending & mask)) {
+                        continue;
+                    }
+                    if (isResponding(index)) {
+                        if (!responding) {
+                            responding = true;
+                            power_up_millis = elapsed;
+                        }
+                        if (hasChipId(index)) {
+                            pending &= ~mask;
+                            ready_millis = elapsed;
+                            continue;
+                        }
+                    }
+                    if (elapsed >= devices[index].settle_max) {
+                        pending &= ~mask;
+                        ready_millis = elapsed;
+                        NOTIFICATION_WARN(F("*I2C: Timeout waiting for device "), String(devices[index].address, HEX));
+                    }
+                }
+                if (pending) {
+                    delay(I2C_EXTENDER_POLL_MILLIS);
+                }
+            }
+            notification.info_millis(F("*I2C: Extender powered up after "), power_up_millis);
+            notification.info_millis(F("*I2C: Extender ready after "), ready_millis);
             return true;
         }
     }
@@ -41,3 +100,19 @@ void I2CExtender::deactivate(void) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// returns true, if the device acknowledges its address
+bool I2CExtender::isResponding(uint8_t index) {
+    Wire.beginTransmission(devices[index].address);
+    return Wire.endTransmission() == 0;
+}
+
+// returns true, if the device reports its chip id or has none
+bool I2CExtender::hasChipId(uint8_t index) {
+    if (devices[index].chipid_register < 0) {
+        return true;
+    }
+    return i2c_read8(devices[index].address, devices[index].chipid_register) == devices[index].chipid;
+}
+
+///////
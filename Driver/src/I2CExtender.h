@@ -1,25 +1,61 @@
 #ifndef __I2C_EXTENDER_H__
 #define __I2C_EXTENDER_H__
 
+#include <Arduino.h>
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Weather Station:
 // Class to operate the I2C extender module of the Weather Station. See schematics.
+// After activating the extender the attached devices are polled until they respond, so the bus
+// is usable as soon as possible. Without devices it waits for I2C_EXTENDER_SETTLE_MILLIS.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Maximum number of devices polled after activating.
+#define I2C_EXTENDER_DEVICES_MAX 6
+// Time to settle if there are no devices to poll in milliseconds.
+#define I2C_EXTENDER_SETTLE_MILLIS 1000
+// Interval for polling devices in milliseconds.
+#define I2C_EXTENDER_POLL_MILLIS 1
+
 class I2CExtender {
 public:
     I2CExtender(int enablepin);
 
     bool begin();
 
-    // Activates the I2C extender module by driving the enable pin.
+    // Adds a device to poll after activating. The device is ready if it acknowledges its address
+    // and, if chipid_register is not negative, returns the given chip id from this register.
+    // Polling gives up on the device after settle_max milliseconds.
+    bool device(uint8_t address, unsigned long settle_max, int chipid_register = -1, uint8_t chipid = 0);
+
+    // Activates the I2C extender module by driving the enable pin. Returns after all devices are
+    // ready or have timed out.
     bool activate(void);
 
     // Deactivates the I2C extender module by deactivating the enable pin.
     void deactivate(void);
 
+    // Returns the time in milliseconds from the last activation until the first device responded.
+    unsigned long powerUpMillis(void) { return power_up_millis; }
+    // Returns the time in milliseconds from the last activation until all devices were ready.
+    unsigned long readyMillis(void) { return ready_millis; }
+
 private:
     int enablepin;
+
+    struct {
+        uint8_t address;
+        int16_t chipid_register;
+        uint8_t chipid;
+        unsigned long settle_max;
+    } devices[I2C_EXTENDER_DEVICES_MAX];
+    uint8_t device_count;
+
+    unsigned long power_up_millis;
+    unsigned long ready_millis;
+
+    bool isResponding(uint8_t index);
+    bool hasChipId(uint8_t index);
 };
 
 #endif
@@ -0,0 +1,232 @@
+#include <Arduino.h>
+
+#include "Journal.h"
+
+#include "Files.h"
+#include "Readings.h"
+#include "Memory.h"
+#include "Notification.h"
+
+extern Memory memory;
+extern Notification notification;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// A record holds the packed readings of one measuring cycle.
+typedef struct {
+    uint32_t time; // seconds since 1970-01-01
+    int16_t values[Readings::READING_TYPE_MAX + 1];
+    uint16_t reserved;
+    uint32_t checksum; // of all preceding fields
+} journal_record_t;
+
+#define JOURNAL_RECORD_CHECKSUM_SIZE (sizeof(journal_record_t) - sizeof(uint32_t))
+
+// The state of the journal is kept in RTC memory and recovered from the segments after power on.
+typedef struct {
+    uint8_t first; // slot of oldest segment
+    uint8_t count; // number of segments in use
+    uint16_t offset; // number of replayed records in oldest segment
+} journal_state_t;
+
+static_assert(sizeof(journal_state_t) <= MEMORY_JOURNAL_SIZE, "Journal block too small");
+
+static journal_state_t state;
+
+// The replay cursor reads records in blocks.
+typedef struct {
+    uint8_t segment; // segment relative to oldest segment
+    uint16_t offset; // record in segment
+    uint16_t count; // number of records read
+    uint8_t buffered; // number of records in buffer
+    uint8_t index; // next record in buffer
+} journal_cursor_t;
+
+static journal_cursor_t cursor;
+
+static journal_record_t buffer[JOURNAL_READ_RECORDS];
+
+static uint8_t slot_after(uint8_t slot, uint8_t count) {
+    return (slot + count) % JOURNAL_SEGMENTS;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Journal::Journal(void) {
+    this->files = NULL;
+}
+
+bool Journal::begin(Files *files) {
+    this->files = files;
+    if (!memory.load(Memory::journal, &state, sizeof(state))) {
+        recover();
+    }
+    if (state.count > 0) {
+        notification.info(F("*JOURNAL: segments: "), state.count);
+    }
+    return true;
+}
+
+bool Journal::append(Readings &readings, uint32_t unixtime) {
+    if (unixtime == 0) {
+        notification.warn(F("*JOURNAL: No time for readings!"));
+        return false;
+    }
+
+    journal_record_t record;
+    record.time = unixtime;
+    readings.pack(record.values);
+    record.reserved = 0;
+    record.checksum = Memory::checksum(&record, JOURNAL_RECORD_CHECKSUM_SIZE);
+
+    bool create = state.count == 0;
+    if (!create) {
+        size_t size = files->size(segment(slot_after(state.first, state.count - 1)));
+        // start a new segment if full or broken
+        create = (size % sizeof(journal_record_t) != 0)
+            || (size / sizeof(journal_record_t) >= JOURNAL_SEGMENT_RECORDS);
+    }
+    if (create) {
+        if (state.count == JOURNAL_SEGMENTS) {
+            notification.warn(F("*JOURNAL: Dropped oldest segment!"));
+            files->remove(segment(state.first));
+            state.first = slot_after(state.first, 1);
+            state.count--;
+            state.offset = 0;
+        }
+        state.count++;
+        files->remove(segment(slot_after(state.first, state.count - 1))); // stale segment
+        save();
+    }
+
+    return files->append(
+        segment(slot_after(state.first, state.count - 1)), &record, sizeof(record)
+    );
+}
+
+uint16_t Journal::pending(void) {
+    uint32_t pending = 0;
+    for (uint8_t segment = 0; segment < state.count; segment++) {
+        pending += records(slot_after(state.first, segment));
+    }
+    pending = pending > state.offset ? pending - state.offset : 0;
+    return pending < JOURNAL_REPLAY_RECORDS ? pending : JOURNAL_REPLAY_RECORDS;
+}
+
+void Journal::rewind(void) {
+    cursor.segment = 0;
+    cursor.offset = state.offset;
+    cursor.count = 0;
+    cursor.buffered = 0;
+    cursor.index = 0;
+}
+
+bool Journal::next(Readings &readings, uint32_t &unixtime) {
+    while (cursor.count < JOURNAL_REPLAY_RECORDS) {
+        if ((cursor.index >= cursor.buffered) && !read()) {
+            return false;
+        }
+        journal_record_t &record = buffer[cursor.index++];
+        cursor.count++;
+        if (record.checksum != Memory::checksum(&record, JOURNAL_RECORD_CHECKSUM_SIZE)) {
+            notification.warn(F("*JOURNAL: Skipped broken record!"));
+            continue;
+        }
+        readings.unpack(record.values);
+        unixtime = record.time;
+        return true;
+    }
+    return false;
+}
+
+void Journal::consume(void) {
+    uint16_t count = cursor.count;
+    while ((count > 0) && (state.count > 0)) {
+        uint16_t records = this->records(state.first);
+        uint16_t remaining = records > state.offset ? records - state.offset : 0;
+        uint16_t consumed = count < remaining ? count : remaining;
+        state.offset += consumed;
+        count -= consumed;
+        trim();
+    }
+    rewind();
+    save();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+String Journal::segment(uint8_t slot) {
+    return "journal" + String(slot);
+}
+
+uint16_t Journal::records(uint8_t slot) {
+    return files->size(segment(slot)) / sizeof(journal_record_t);
+}
+
+// Reads the next block of records at the cursor into the buffer.
+bool Journal::read(void) {
+    while (cursor.segment < state.count) {
+        size_t size = files->read(
+            segment(slot_after(state.first, cursor.segment)),
+            cursor.offset * sizeof(journal_record_t),
+            buffer, sizeof(buffer)
+        );
+        cursor.buffered = size / sizeof(journal_record_t);
+        cursor.index = 0;
+        if (cursor.buffered > 0) {
+            cursor.offset += cursor.buffered;
+            return true;
+        }
+        cursor.segment++;
+        cursor.offset = 0;
+    }
+    return false;
+}
+
+// Finds the segments in use after power on. The oldest segment is the one with the oldest first
+// record. Records of the oldest segment will be replayed again (which is harmless for InfluxDB).
+void Journal::recover(void) {
+    state.first = 0;
+    state.count = 0;
+    state.offset = 0;
+
+    uint32_t first_time = UINT32_MAX;
+    for (uint8_t slot = 0; slot < JOURNAL_SEGMENTS; slot++) {
+        if (!files->exists(segment(slot))) {
+            continue;
+        }
+        journal_record_t record;
+        if (files->read(segment(slot), 0, &record, sizeof(record)) != sizeof(record)) {
+            continue;
+        }
+        if (record.checksum != Memory::checksum(&record, JOURNAL_RECORD_CHECKSUM_SIZE)) {
+            continue;
+        }
+        if (record.time < first_time) {
+            first_time = record.time;
+            state.first = slot;
+        }
+    }
+    if (first_time < UINT32_MAX) {
+        while ((state.count < JOURNAL_SEGMENTS)
+            && files->exists(segment(slot_after(state.first, state.count)))) {
+            state.count++;
+        }
+    }
+    trim();
+    save();
+}
+
+// Removes segments which were replayed completely.
+void Journal::trim(void) {
+    while ((state.count > 0) && (state.offset >= records(state.first))) {
+        files->remove(segment(state.first));
+        state.first = slot_after(state.first, 1);
+        state.count--;
+        state.offset = 0;
+    }
+}
+
+void Journal::save(void) {
+    memory.save(Memory::journal, &state, sizeof(state));
+}
@@ -0,0 +1,65 @@
+#ifndef __JOURNAL_H__
+#define __JOURNAL_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to keep sensor readings, which could not be sent to a server, in a journal in Flash
+// memory, so they can be replayed later. Readings are appended as compact, checksummed records
+// with timestamps. A record broken by a reset while writing is detected and skipped.
+//
+// The journal is split into segments (files), which are used in rotation. A segment is removed as
+// a whole after all its records were replayed, records are never rewritten. If all segments are
+// in use, the oldest segment is dropped.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Files.h"
+#include "Readings.h"
+
+// Number of segments and number of records per segment.
+#define JOURNAL_SEGMENTS 8
+#define JOURNAL_SEGMENT_RECORDS 64
+
+// Maximum number of records to replay at once.
+#define JOURNAL_REPLAY_RECORDS 256
+
+// Number of records to read from Flash memory at once while replaying.
+#define JOURNAL_READ_RECORDS 8
+
+class Journal {
+public:
+    Journal(void);
+
+    // Begin managing the journal with the given files manager.
+    // Must be called before any other method.
+    bool begin(Files *files);
+
+    // Appends the given readings with the given time (seconds since 1970-01-01) as new record.
+    bool append(Readings &readings, uint32_t unixtime);
+
+    // Returns the number of records to replay (oldest first), at most JOURNAL_REPLAY_RECORDS.
+    uint16_t pending(void);
+
+    // Starts replaying records with the oldest record.
+    void rewind(void);
+    // Restores the readings and time of the next record to replay. Broken records are skipped.
+    // Returns false if there are no more records to replay.
+    bool next(Readings &readings, uint32_t &unixtime);
+    // Marks all records read since rewind as replayed.
+    void consume(void);
+
+private:
+    Files *files;
+
+    String segment(uint8_t slot);
+    uint16_t records(uint8_t slot);
+
+    bool read(void);
+
+    void recover(void);
+    void trim(void);
+    void save(void);
+};
+
+#endif
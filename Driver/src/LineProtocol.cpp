@@ -0,0 +1,140 @@
+#include <Arduino.h>
+
+#include "LineProtocol.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Characters to escape in measurements and in tag keys, tag values and field keys.
+static const char *MEASUREMENT_SPECIALS = ", ";
+static const char *KEY_SPECIALS = ",= ";
+
+// Largest absolute float value to encode (to fit into 64 bits with decimals).
+#define LINEPROTOCOL_VALUE_MAX 1.0e12
+
+static const uint32_t powers_of_ten[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000
+};
+
+#define LINEPROTOCOL_DECIMALS_MAX 6
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+LineProtocol::LineProtocol(char *buffer, size_t capacity) {
+    this->buffer = buffer;
+    this->capacity = capacity;
+    clear();
+}
+
+void LineProtocol::clear(void) {
+    size = 0;
+    line_start = 0;
+    fields = 0;
+    count = 0;
+    line_overflowed = false;
+    overflowed = false;
+    if (capacity > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void LineProtocol::measurement(const char *name) {
+    line_start = size;
+    fields = 0;
+    line_overflowed = false;
+    append_escaped(name, MEASUREMENT_SPECIALS);
+}
+
+void LineProtocol::tag(const char *key, const char *value) {
+    append(',');
+    append_escaped(key, KEY_SPECIALS);
+    append('=');
+    append_escaped(value, KEY_SPECIALS);
+}
+
+void LineProtocol::field(const char *key, float value, uint8_t decimals) {
+    if (isnan(value) || isinf(value)) {
+        return;
+    }
+    append(fields == 0 ? ' ' : ',');
+    append_escaped(key, KEY_SPECIALS);
+    append('=');
+
+    if (value < 0) {
+        append('-');
+        value = -value;
+    }
+    if (value > LINEPROTOCOL_VALUE_MAX) {
+        value = LINEPROTOCOL_VALUE_MAX;
+    }
+    if (decimals > LINEPROTOCOL_DECIMALS_MAX) {
+        decimals = LINEPROTOCOL_DECIMALS_MAX;
+    }
+    uint32_t scale = powers_of_ten[decimals];
+    uint64_t scaled = (uint64_t) ((double) value * scale + 0.5);
+    append_unsigned(scaled / scale);
+    if (decimals > 0) {
+        append('.');
+        append_unsigned(scaled % scale, decimals);
+    }
+    fields++;
+}
+
+void LineProtocol::timestamp(uint32_t unixtime) {
+    append(' ');
+    append_unsigned(unixtime);
+}
+
+bool LineProtocol::end(void) {
+    append('\n');
+    if (fields == 0 || line_overflowed) {
+        // discard line
+        size = line_start;
+        if (capacity > 0) {
+            buffer[size] = '\0';
+        }
+        if (line_overflowed) {
+            overflowed = true;
+        }
+        return false;
+    }
+    count++;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LineProtocol::append(char c) {
+    if (size + 1 < capacity) {
+        buffer[size++] = c;
+        buffer[size] = '\0';
+    }
+    else {
+        line_overflowed = true;
+    }
+}
+
+void LineProtocol::append_escaped(const char *string, const char *specials) {
+    while (*string) {
+        if (strchr(specials, *string)) {
+            append('\\');
+        }
+        append(*string++);
+    }
+}
+
+// Appends the given value in decimal with at least the given number of digits.
+void LineProtocol::append_unsigned(uint64_t value, uint8_t digits) {
+    char digits_buffer[21];
+    uint8_t length = 0;
+    do {
+        digits_buffer[length++] = '0' + (value % 10);
+        value /= 10;
+    }
+    while (value > 0 && length < sizeof(digits_buffer));
+    while (length < digits && length < sizeof(digits_buffer)) {
+        digits_buffer[length++] = '0';
+    }
+    while (length > 0) {
+        append(digits_buffer[--length]);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef __LINEPROTOCOL_H__
+#define __LINEPROTOCOL_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to encode data points in InfluxDB’s line protocol into a buffer given by the caller. No
+// memory is allocated. Measurement, tag keys and values and field keys are escaped as needed.
+// See https://docs.influxdata.com/influxdb/v1.8/write_protocols/line_protocol_reference/
+//
+// For example:
+//   LineProtocol line(buffer, sizeof(buffer));
+//   line.measurement("weather");
+//   line.tag("location", "terrace");
+//   line.field("temperature0", 15.9);
+//   line.end();
+// gives "weather,location=terrace temperature0=15.9000\n"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class LineProtocol {
+public:
+    // Constructs an encoder into the given buffer of the given capacity (including the
+    // terminating null character).
+    LineProtocol(char *buffer, size_t capacity);
+
+    // Starts a new line for the given measurement.
+    void measurement(const char *name);
+    // Adds a tag to the current line. Tags must be added before any field.
+    void tag(const char *key, const char *value);
+    // Adds a float field with the given number of decimals to the current line. Does nothing
+    // if the value is not a finite number.
+    void field(const char *key, float value, uint8_t decimals = 4);
+    // Adds a timestamp to the current line. Must be added after all fields.
+    void timestamp(uint32_t unixtime);
+    // Ends the current line. Discards the line and returns false if it has no fields.
+    bool end(void);
+
+    // Returns the encoded lines.
+    const char *c_str(void) const { return buffer; }
+    // Returns the length of the encoded lines.
+    size_t length(void) const { return size; }
+    // Returns the number of encoded lines.
+    unsigned int lines(void) const { return count; }
+    // Checks if the buffer was too small. Lines, which did not fit, are discarded.
+    bool overflow(void) const { return overflowed; }
+
+    // Discards all encoded lines.
+    void clear(void);
+
+private:
+    char *buffer;
+    size_t capacity;
+    size_t size;
+
+    size_t line_start; // position of the current line
+    uint8_t fields; // number of fields in the current line
+    unsigned int count;
+    bool line_overflowed;
+    bool overflowed;
+
+    void append(char c);
+    void append_escaped(const char *string, const char *specials);
+    void append_unsigned(uint64_t value, uint8_t digits = 0);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include <Arduino.h>
+
+#include "Logger.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Logger::Logger(void) {
+    started = false;
+    head = 0;
+    tail = 0;
+    draining = false;
+    dropped_count = 0;
+}
+
+size_t Logger::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(ESP8266) || defined(ESP32)
+
+#include <Ticker.h>
+
+static Ticker logger_ticker;
+
+static void logger_tick(Logger *logger) {
+    logger->drain();
+}
+
+// Returns true if the lock was acquired.
+static bool logger_lock(volatile bool *lock) {
+    #if defined(ESP32)
+    return !__atomic_exchange_n(lock, true, __ATOMIC_ACQUIRE);
+    #else
+    // ticker callbacks do not preempt the loop on ESP8266
+    if (*lock) {
+        return false;
+    }
+    *lock = true;
+    return true;
+    #endif
+}
+
+bool Logger::begin(unsigned long baud) {
+    Serial.begin(baud);
+    started = true;
+    logger_ticker.attach_ms(LOGGER_DRAIN_MILLIS, logger_tick, this);
+    drain();
+    return true;
+}
+
+size_t Logger::write(const uint8_t *data, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        uint16_t next = (head + 1) % LOGGER_BUFFER_SIZE;
+        if (next == tail) {
+            // make room by sending what the UART takes, drop the rest
+            drain();
+            if (next == tail) {
+                dropped_count += size - written;
+                break;
+            }
+        }
+        buffer[head] = data[written++];
+        head = next;
+    }
+    drain();
+    return written;
+}
+
+void Logger::flush(void) {
+    while (started && tail != head) {
+        drain();
+        yield();
+    }
+    Serial.flush();
+}
+
+void Logger::drain(void) {
+    if (!started || !logger_lock(&draining)) {
+        return;
+    }
+    uint16_t end = head;
+    int available = Serial.availableForWrite();
+    while (available > 0 && tail != end) {
+        // send the contiguous part up to the end of data or the end of buffer
+        size_t count = (end > tail ? end : LOGGER_BUFFER_SIZE) - tail;
+        if (count > (size_t) available) {
+            count = available;
+        }
+        Serial.write(buffer + tail, count);
+        tail = (tail + count) % LOGGER_BUFFER_SIZE;
+        available -= count;
+    }
+    draining = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#else
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Logger::begin(unsigned long baud) {
+    Serial.begin(baud);
+    started = true;
+    return true;
+}
+
+size_t Logger::write(const uint8_t *data, size_t size) {
+    return Serial.write(data, size);
+}
+
+void Logger::flush(void) {
+    Serial.flush();
+}
+
+void Logger::drain(void) {
+}
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////////////
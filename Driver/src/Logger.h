@@ -0,0 +1,50 @@
+#ifndef __LOGGER_H__
+#define __LOGGER_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Operating Support:
+// Class to write output to the serial connection without blocking. Output is kept in a ring
+// buffer in RAM, which a ticker drains into the transmit FIFO of the UART while the program goes
+// on. Output not fitting into the buffer is dropped (and counted). Falls back to writing to the
+// serial connection directly if not run on ESP8266 or ESP32.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of the ring buffer in bytes.
+#define LOGGER_BUFFER_SIZE 1024
+// Interval for draining the ring buffer in milliseconds (the UART FIFO takes 128 bytes).
+#define LOGGER_DRAIN_MILLIS 5
+
+class Logger : public Print {
+public:
+    Logger(void);
+
+    // Begin output to the serial connection with the given baud rate.
+    bool begin(unsigned long baud);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    // Waits until all buffered output has been sent.
+    void flush(void) override;
+
+    // Sends buffered output as far as the UART takes it without waiting.
+    void drain(void);
+
+    // Returns the number of bytes dropped because the ring buffer was full.
+    unsigned long dropped(void) { return dropped_count; }
+
+private:
+    bool started;
+
+    uint8_t buffer[LOGGER_BUFFER_SIZE];
+    volatile uint16_t head; // position of the next byte to buffer
+    volatile uint16_t tail; // position of the next byte to send
+    volatile bool draining;
+
+    unsigned long dropped_count;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include <Arduino.h>
+
+#include "Memory.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Capacity of each block in bytes, in order of Memory::block. Each block is preceded by a word
+// holding its checksum.
+static constexpr uint16_t block_sizes[Memory::BLOCK_MAX + 1] = {
+    MEMORY_NETWORK_SIZE,
+    MEMORY_BATCH_SIZE,
+    MEMORY_JOURNAL_SIZE,
+    MEMORY_DEADBAND_SIZE,
+    MEMORY_SCHEDULER_SIZE,
+    MEMORY_CLOCK_SIZE,
+    MEMORY_WAKE_SIZE,
+    MEMORY_BME280_SIZE,
+    MEMORY_PROFILER_SIZE,
+    MEMORY_ENERGY_SIZE
+};
+
+// Returns the number of words needed for a block of the given size, including its checksum.
+static constexpr uint32_t block_words(size_t size) {
+    return 1 + (size + 3) / 4;
+}
+
+// Returns the offset in words of the given block.
+static constexpr uint32_t block_offset(int block) {
+    return block == 0 ? 0 : block_offset(block - 1) + block_words(block_sizes[block - 1]);
+}
+
+// Returns the largest capacity of the given and all following blocks.
+static constexpr uint16_t block_size_max(int block = 0) {
+    return block > Memory::BLOCK_MAX ? 0 :
+        block_sizes[block] > block_size_max(block + 1) ?
+            block_sizes[block] : block_size_max(block + 1);
+}
+
+static_assert(block_offset(Memory::BLOCK_MAX + 1) <= MEMORY_WORDS,
+    "RTC memory layout exceeds RTC memory"
+);
+
+// Returns the checksum for the given block, which includes block number and size of data.
+static uint32_t block_checksum(Memory::block block, const void *data, size_t size) {
+    return Memory::checksum(data, size) ^ (((uint32_t) block << 16) | size);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(ESP8266)
+
+static bool memory_read(uint32_t offset, uint32_t *data, size_t size) {
+    return ESP.rtcUserMemoryRead(offset, data, size);
+}
+
+static bool memory_write(uint32_t offset, uint32_t *data, size_t size) {
+    return ESP.rtcUserMemoryWrite(offset, data, size);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#else
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(ESP32)
+RTC_DATA_ATTR static uint32_t memory_words[MEMORY_WORDS];
+#else
+static uint32_t memory_words[MEMORY_WORDS];
+#endif
+
+static bool memory_read(uint32_t offset, uint32_t *data, size_t size) {
+    memcpy(data, &memory_words[offset], size);
+    return true;
+}
+
+static bool memory_write(uint32_t offset, uint32_t *data, size_t size) {
+    memcpy(&memory_words[offset], data, size);
+    return true;
+}
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Memory::Memory(void) {
+}
+
+bool Memory::begin(void) {
+    return true;
+}
+
+bool Memory::load(block block, void *data, size_t size) {
+    if (size > block_sizes[block]) {
+        return false;
+    }
+    uint32_t buffer[block_words(block_size_max())];
+    if (!memory_read(block_offset(block), buffer, block_words(size) * 4)) {
+        return false;
+    }
+    if (buffer[0] != block_checksum(block, &buffer[1], size)) {
+        return false;
+    }
+    memcpy(data, &buffer[1], size);
+    return true;
+}
+
+bool Memory::save(block block, const void *data, size_t size) {
+    if (size > block_sizes[block]) {
+        return false;
+    }
+    uint32_t buffer[block_words(block_size_max())] = { 0 };
+    memcpy(&buffer[1], data, size);
+    buffer[0] = block_checksum(block, &buffer[1], size);
+    return memory_write(block_offset(block), buffer, block_words(size) * 4);
+}
+
+void Memory::clear(block block) {
+    uint32_t word = 0;
+    memory_write(block_offset(block), &word, sizeof(word));
+}
+
+uint32_t Memory::checksum(const void *data, size_t size, uint32_t crc) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+    while (size--) {
+        crc ^= *bytes++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
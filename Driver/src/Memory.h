@@ -0,0 +1,66 @@
+#ifndef __MEMORY_H__
+#define __MEMORY_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Operating Support:
+// Class to manage blocks of data in RTC memory, which survives deep sleep (but not power loss).
+// Every block is guarded by a checksum, so a block is only loaded if it was saved before with
+// the same layout. Falls back to plain RAM if not run on ESP8266 or ESP32.
+//
+// On ESP8266 this uses the 512 bytes of RTC user memory. Note: an OTA update may overwrite the
+// beginning of that memory, which is detected by the checksums.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of RTC memory in words (4 bytes).
+#define MEMORY_WORDS 128
+
+// Capacity of blocks in bytes (multiple of 4).
+#define MEMORY_NETWORK_SIZE 24
+#define MEMORY_BATCH_SIZE 176
+#define MEMORY_JOURNAL_SIZE 4
+#define MEMORY_DEADBAND_SIZE 24
+#define MEMORY_SCHEDULER_SIZE 28
+#define MEMORY_CLOCK_SIZE 32
+#define MEMORY_WAKE_SIZE 8
+#define MEMORY_BME280_SIZE 44
+#define MEMORY_PROFILER_SIZE 92
+#define MEMORY_ENERGY_SIZE 32
+
+class Memory {
+public:
+    // Enumeration of blocks in RTC memory.
+    enum block {
+      network = 0,
+      batch = 1,
+      journal = 2,
+      deadband = 3,
+      scheduler = 4,
+      clock = 5,
+      wake = 6,
+      bme280 = 7,
+      profiler = 8,
+      energy = 9,
+      BLOCK_MAX = energy,
+      // aggregation of readings is not used with batching, so both share one block
+      aggregate = batch
+    };
+
+    Memory(void);
+
+    // Begin managing the RTC memory. Must be called before any other method.
+    bool begin(void);
+
+    // Loads the given block into the given buffer. Returns false if the block is invalid.
+    bool load(block block, void *data, size_t size);
+    // Saves the given buffer into the given block. Returns false if the block is too small.
+    bool save(block block, const void *data, size_t size);
+    // Invalidates the given block.
+    void clear(block block);
+
+    // Computes a CRC-32 checksum of the given data.
+    static uint32_t checksum(const void *data, size_t size, uint32_t crc = 0);
+};
+
+#endif
@@ -13,27 +13,45 @@
 #include "System.h"
 
 #include "Values.h"
+#include "Clock.h"
+#include "Memory.h"
 #include "Signaling.h"
 #include "Notification.h"
+#include "Profiler.h"
+#include "Energy.h"
+
+#include "millis.h"
 
 extern const bool PRODUCTION;
+extern Memory memory;
 extern Signaling signaling;
 extern Notification notification;
+extern Profiler profiler;
+extern Energy energy;
+
+// Time to wait for joining with the parameters of the last successful connection.
+#define NETWORK_CACHED_TIMEOUT_MILLIS 2000
+// Time to use the IP configuration of the last successful connection, well below the lease time
+// given by common DHCP servers (seconds).
+#define NETWORK_CACHED_LEASE_SECONDS (6 * 3600)
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 Network::Network(String deviceid)
-    : deviceid(deviceid), ssid(""), sspw(""), values(NULL) {
+    : deviceid(deviceid), ssid(""), sspw(""), values(NULL), clock(NULL),
+      unleased(false), unleased_millis(0) {
 }
 
 Network::Network(String deviceid, String ssid, String sspw)
-     : deviceid(deviceid), ssid(ssid), sspw(sspw), values(NULL) {
+     : deviceid(deviceid), ssid(ssid), sspw(sspw), values(NULL), clock(NULL),
+       unleased(false), unleased_millis(0) {
 }
 
-bool Network::begin(Values *values) {
+bool Network::begin(Values *values, Clock *clock) {
     this->values = values;
+    this->clock = clock;
 
-    notification.info(F("*WIFI: MAC: "), WiFi.macAddress());
+    NOTIFICATION_INFO(F("*WIFI: MAC: "), WiFi.macAddress());
 
     #if defined(ESP8266)
     notification.info(F("*WIFI: HOSTNAME: "), deviceid);
@@ -48,6 +66,95 @@ bool Network::begin(Values *values) {
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(ESP8266) || defined(ESP32)
+
+// Parameters of the last successful connection.
+struct network_cached_t {
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t dns;
+    uint32_t leased; // seconds since 1970-01-01 of the DHCP request, 0 if not known
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t prefix; // length of the subnet mask
+};
+
+static_assert(sizeof(network_cached_t) <= MEMORY_NETWORK_SIZE, "Network block too small");
+
+bool Network::connectCached(void) {
+    network_cached_t cached;
+    if (!memory.load(Memory::network, &cached, sizeof(cached))) {
+        return false;
+    }
+
+    // the lease of the IP address may have run out, request a new one with a regular connect
+    uint32_t now = clock != NULL ? clock->unixtime() : 0;
+    if (cached.leased == 0 || now == 0
+        || now < cached.leased || now - cached.leased >= NETWORK_CACHED_LEASE_SECONDS) {
+        notification.info(F("*WIFI: cached lease expired"));
+        memory.clear(Memory::network);
+        return false;
+    }
+
+    // use configured credentials or credentials saved by the configuration portal
+    #if defined(ESP8266)
+    String ssid = this->ssid.length() > 0 ? this->ssid : WiFi.SSID();
+    String sspw = this->ssid.length() > 0 ? this->sspw : WiFi.psk();
+    #endif
+    if (ssid.length() == 0) { return false; }
+
+    WiFi.persistent(false); // do not write credentials to flash on every connect
+    uint32_t mask = cached.prefix == 0 ? 0 : 0xFFFFFFFF << (32 - cached.prefix);
+    IPAddress subnet(mask >> 24, (mask >> 16) & 0xFF, (mask >> 8) & 0xFF, mask & 0xFF);
+    WiFi.config(IPAddress(cached.ip), IPAddress(cached.gateway), subnet, IPAddress(cached.dns));
+    WiFi.begin(ssid.c_str(), sspw.c_str(), cached.channel, cached.bssid, true);
+    WiFi.persistent(true);
+
+    elapsed_millis elapsed;
+    while ((WiFi.status() != WL_CONNECTED) && (elapsed < NETWORK_CACHED_TIMEOUT_MILLIS)) {
+        delay(10);
+    }
+    if (WiFi.status() == WL_CONNECTED) {
+        return true;
+    }
+
+    notification.info(F("*WIFI: cached connect failed: "), WiFi.status());
+    memory.clear(Memory::network);
+    // back to DHCP for a regular connect
+    WiFi.disconnect();
+    WiFi.config(IPAddress((uint32_t) 0), IPAddress((uint32_t) 0), IPAddress((uint32_t) 0));
+    return false;
+}
+
+void Network::saveCached(void) {
+    network_cached_t cached;
+    cached.ip = WiFi.localIP();
+    cached.gateway = WiFi.gatewayIP();
+    cached.dns = WiFi.dnsIP();
+    cached.leased = clock != NULL ? clock->unixtime() : 0;
+    // the time of the lease is given later, if the clock is not synced yet
+    unleased = cached.leased == 0;
+    unleased_millis = millis();
+    memcpy(cached.bssid, WiFi.BSSID(), sizeof(cached.bssid));
+    cached.channel = WiFi.channel();
+    cached.prefix = __builtin_popcount((uint32_t) WiFi.subnetMask());
+    memory.save(Memory::network, &cached, sizeof(cached));
+}
+
+void Network::leaseCached(void) {
+    if (!unleased || clock == NULL || clock->unixtime() == 0) {
+        return;
+    }
+    network_cached_t cached;
+    if (memory.load(Memory::network, &cached, sizeof(cached))) {
+        cached.leased = clock->unixtime() - (millis() - unleased_millis) / 1000;
+        memory.save(Memory::network, &cached, sizeof(cached));
+    }
+    unleased = false;
+}
+
+#endif
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #if defined(ESP8266)
 
@@ -82,23 +189,39 @@ void finishNetworkForWiFi(WiFiManager *wm, Network *network) {
 }
 
 bool Network::connect() {
-    System::wifiOn();
-
-    if (connect(ssid, sspw)) {
+    if (isConnected()) {
         return true;
     }
 
-    if (connect(deviceid)) {
-        return true;
+    // association ends with the connected event, then DHCP (if any) takes until connected
+    profiler.start(Profiler::associate);
+    WiFiEventHandler associated = WiFi.onStationModeConnected(
+        [](const WiFiEventStationModeConnected &) {
+            profiler.stop(Profiler::associate);
+            profiler.start(Profiler::dhcp);
+        }
+    );
+
+    energy.start(Energy::radio);
+    System::wifiOn();
+
+    bool connected = connectCached();
+    if (!connected && (connect(ssid, sspw) || connect(deviceid))) {
+        saveCached();
+        connected = true;
     }
 
-    return false;
+    profiler.stop(Profiler::associate);
+    profiler.stop(Profiler::dhcp);
+    return connected;
 }
 
 bool Network::connect(String ssid, String password) {
     if ((ssid.length() == 0) || (sspw.length() == 0)) { return false; }
 
+    WiFi.persistent(false); // do not write credentials to flash on every connect
     WiFi.begin(ssid.c_str(), password.c_str());
+    WiFi.persistent(true);
     int status = WiFi.waitForConnectResult();
     if (status != WL_CONNECTED) {
         notification.info(F("*WIFI: status: "), status);
@@ -119,8 +242,8 @@ bool Network::connect(String deviceid) {
     }
     else {
         // Development: print debug output
-        notification.info(F("*WIFI: SSID: "), WiFi.SSID());
-        notification.info(F("*WIFI: PASS: "), WiFi.psk());
+        NOTIFICATION_INFO(F("*WIFI: SSID: "), WiFi.SSID());
+        NOTIFICATION_INFO(F("*WIFI: PASS: "), WiFi.psk());
         wiFiManager.setDebugOutput(true);
     }
     wiFiManager.setConnectTimeout(1*60);
@@ -148,31 +271,50 @@ bool Network::connect(String deviceid) {
     return result;
 }
 
+bool Network::isConnected(void) {
+    return WiFi.status() == WL_CONNECTED;
+}
+
 void Network::disconnect(void) {
-    WiFi.disconnect();
+    leaseCached();
+    System::wifiOff();
+    energy.stop(Energy::radio);
 }
 
-std::unique_ptr<Client> Network::createClient(void) {
-    return std::unique_ptr<Client>(new WiFiClient());
+Client &Network::client(void) {
+    return wifiClient;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #elif defined(ESP32)
 
 bool Network::connect() {
+    if (isConnected()) {
+        return true;
+    }
+
+    // association and DHCP are not distinguished
+    profiler.start(Profiler::associate);
+
+    energy.start(Energy::radio);
     System::wifiOn();
 
-    if (connect(ssid, sspw)) {
-        return true;
+    bool connected = connectCached();
+    if (!connected && connect(ssid, sspw)) {
+        saveCached();
+        connected = true;
     }
 
-    return false;
+    profiler.stop(Profiler::associate);
+    return connected;
 }
 
 bool Network::connect(String ssid, String password) {
     if ((ssid.length() == 0) || (sspw.length() == 0)) { return false; }
 
+    WiFi.persistent(false); // do not write credentials to flash on every connect
     WiFi.begin(ssid.c_str(), password.c_str());
+    WiFi.persistent(true);
     int status;
     do {
         status = WiFi.waitForConnectResult();
@@ -184,12 +326,18 @@ bool Network::connect(String ssid, String password) {
     return status == WL_CONNECTED;
 }
 
+bool Network::isConnected(void) {
+    return WiFi.status() == WL_CONNECTED;
+}
+
 void Network::disconnect(void) {
-    WiFi.disconnect();
+    leaseCached();
+    System::wifiOff();
+    energy.stop(Energy::radio);
 }
 
-std::unique_ptr<Client> Network::createClient(void) {
-    return std::unique_ptr<Client>(new WiFiClient());
+Client &Network::client(void) {
+    return wifiClient;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -200,6 +348,10 @@ bool Network::connect(void) {
     return false;
 }
 
+bool Network::isConnected(void) {
+    return false;
+}
+
 bool connect(String ssid, String sspw) {
     return false;
 }
@@ -11,6 +11,11 @@
 // On connect tries to connect to a previously saved Access Point or opens an own Access Point and
 // serves a web configuration portal (ESP8266 only).
 // See https://github.com/tzapu/WiFiManager
+//
+// The parameters of the last successful connection (BSSID, channel and IP configuration) are kept
+// in RTC memory. Reconnecting after deep sleep uses them to join directly without scanning and
+// DHCP, which falls back to a regular connect if failing. The IP configuration is only used for
+// some hours after the DHCP request, while its lease is known to be valid (needs the clock).
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #if defined(ESP8266)
@@ -21,6 +26,7 @@
 #endif
 
 #include "Values.h"
+#include "Clock.h"
 
 class Network {
 public:
@@ -29,17 +35,21 @@ public:
 
     // Begin managing the WiFi network. Must be called before any other method.
     // [NIY] The given Values manger is used to store additional configuration values.
-    bool begin(Values *values);
+    // The given clock is used to age the IP configuration kept for reconnecting.
+    bool begin(Values *values, Clock *clock);
 
-    // Connects to the WiFi network.
+    // Connects to the WiFi network. Does nothing if already connected.
     bool connect(void);
 
-    // Disconnects from the WiFi network.
+    // Checks if connected to the WiFi network.
+    bool isConnected(void);
+
+    // Disconnects from the WiFi network and powers the radio down.
     void disconnect(void);
 
     #if defined(ESP8266) || defined(ESP32)
-    // Returns a new WiFi client. Only available on ESP8266 or ESP32.
-    std::unique_ptr<Client> createClient(void);
+    // Returns the WiFi client of this network. Only available on ESP8266 or ESP32.
+    Client &client(void);
     #endif
 
 private:
@@ -48,9 +58,24 @@ private:
     String sspw;
 
     Values *values;
+    Clock *clock;
+
+    bool unleased; // the kept connection has no time of its lease yet
+    unsigned long unleased_millis; // millis() when the connection was kept
+
+    #if defined(ESP8266) || defined(ESP32)
+    WiFiClient wifiClient;
+    #endif
 
     bool connect(String ssid, String sspw);
     bool connect(String deviceid);
+
+    // Connects using the parameters of the last successful connection.
+    bool connectCached(void);
+    // Keeps the parameters of the current connection for connectCached.
+    void saveCached(void);
+    // Gives the kept connection the time of its lease, once the clock is synced.
+    void leaseCached(void);
 };
 
 #endif
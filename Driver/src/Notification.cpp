@@ -22,6 +22,8 @@ bool Notification::begin(bool production, Signaling *signaling) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_INFO
+
 void Notification::info(const __FlashStringHelper *message) {
     if (!production) { SERIAL_PRINTLN(message); }
 }
@@ -50,25 +52,36 @@ void Notification::info_millis(const __FlashStringHelper *message, unsigned long
     if (!production) { SERIAL_PRINT_MILLIS(message, millis); }
 }
 
+#endif
+
+#if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_WARN
+
 void Notification::warn(const __FlashStringHelper *message) {
     if (!production) {
         SERIAL_PRINT(F("WARN: ")); SERIAL_PRINTLN(message);
     }
-    if (signaling != NULL) {
-        signaling->signal_failure_once(500);
-    }
+    failure();
 }
 void Notification::warn(const __FlashStringHelper *message, const String &printable) {
     if (!production) {
         SERIAL_PRINT(F("WARN: ")); SERIAL_PRINT(message); SERIAL_PRINTLN(printable);
     }
+    failure();
+}
+
+#endif
+
+void Notification::failure(void) {
     if (signaling != NULL) {
         signaling->signal_failure_once(500);
     }
 }
 
 void Notification::fatal(const __FlashStringHelper *message, uint8_t blink, bool forever) {
+    #if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_FATAL
     SERIAL_PRINT(F("FATAL: ")); SERIAL_PRINTLN(message);
+    #endif
+    flush();
     if (signaling != NULL) {
         if (forever) {
             // blink forever and does never return nor reset
@@ -94,4 +107,8 @@ void Notification::fatal(const __FlashStringHelper *message, uint8_t blink, bool
     }
 }
 
+void Notification::flush(void) {
+    SERIAL_FLUSH();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -6,10 +6,41 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Operating Support:
 // Class to produce output to the serial connection.
+// Output above NOTIFICATION_LEVEL is removed at compile time, so no code for formatting and
+// printing is left in the firmware. In production mode only fatal messages are kept by default,
+// build with -DNOTIFICATION_LEVEL=NOTIFICATION_LEVEL_INFO to keep all messages, for example.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "Driver_Mode.h"
 #include "Signaling.h"
 
+#define NOTIFICATION_LEVEL_NONE 0
+#define NOTIFICATION_LEVEL_FATAL 1
+#define NOTIFICATION_LEVEL_WARN 2
+#define NOTIFICATION_LEVEL_INFO 3
+
+#if !defined(NOTIFICATION_LEVEL)
+#if PRODUCTION_MODE
+#define NOTIFICATION_LEVEL NOTIFICATION_LEVEL_FATAL
+#else
+#define NOTIFICATION_LEVEL NOTIFICATION_LEVEL_INFO
+#endif
+#endif
+
+// Output of a message with a printable, which is not evaluated if the output is removed at compile
+// time. To be used if the printable has to be formatted, like String(value, HEX). Expects the
+// handler to be named notification.
+#if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_INFO
+#define NOTIFICATION_INFO(message, printable) notification.info(message, printable)
+#else
+#define NOTIFICATION_INFO(message, printable) ((void) 0)
+#endif
+#if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_WARN
+#define NOTIFICATION_WARN(message, printable) notification.warn(message, printable)
+#else
+#define NOTIFICATION_WARN(message, printable) notification.warn(message)
+#endif
+
 class Notification {
 public:
     // Constructs a handler for the default serial connection.
@@ -18,6 +49,7 @@ public:
     // Begin handling output. Must be called before any other method.
     bool begin(bool production, Signaling *signaling);
 
+    #if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_INFO
     void info(const __FlashStringHelper *message);
     void info(const __FlashStringHelper *message, const String &printable);
     void info(const __FlashStringHelper *message, const char *printable);
@@ -28,21 +60,34 @@ public:
     void info(const __FlashStringHelper *message, const Printable &printable);
 
     void info_millis(const __FlashStringHelper *message, unsigned long millis);
+    #else
+    template <typename... T> void info(const __FlashStringHelper *, const T &...) { }
+    void info_millis(const __FlashStringHelper *, unsigned long) { }
+    #endif
 
     // Any of the following methods produces output to the serial connection and triggers a signal.
 
+    #if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_WARN
     void warn(const __FlashStringHelper *message);
     void warn(const __FlashStringHelper *message, const String &printable);
+    #else
+    template <typename... T> void warn(const __FlashStringHelper *, const T &...) { failure(); }
+    #endif
 
     // Any of the following methods produces output to the serial connection, triggers a signal
     // and stops execution.
 
     void fatal(const __FlashStringHelper *message, uint8_t blink = 0, bool forever = true);
 
+    // Waits until all output has been sent, for example before deep sleep.
+    void flush(void);
+
 private:
     bool production;
 
     Signaling *signaling;
+
+    void failure(void);
 };
 
 #endif
@@ -34,7 +34,7 @@ void OTA::performUpdate(void) {
     }
 
     notification.info(F("Checking update:"), OTA_URL);
-    notification.info(F("lastResetReason:"), String(System::lastResetReason()));
+    NOTIFICATION_INFO(F("lastResetReason:"), String(System::lastResetReason()));
 
     // perform update
     switch(ESPhttpUpdate.update(OTA_URL, String(SKETCH_VERSION))) {
@@ -42,7 +42,7 @@ void OTA::performUpdate(void) {
             notification.info(F("No update available!"));
             break;
         case HTTP_UPDATE_FAILED:
-            notification.warn(F("Update failed: "), ESPhttpUpdate.getLastErrorString());
+            NOTIFICATION_WARN(F("Update failed: "), ESPhttpUpdate.getLastErrorString());
             break;
         case HTTP_UPDATE_OK:
             // may not be called -> reboot the ESP
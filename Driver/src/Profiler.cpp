@@ -0,0 +1,171 @@
+#include <Arduino.h>
+
+#include "Profiler.h"
+
+#include "Memory.h"
+
+extern Memory memory;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    uint32_t unixtime; // time at the end of the wake
+    uint16_t version;
+    uint16_t spans[Profiler::PHASE_MAX + 1]; // packed microseconds
+} profiler_wake_t;
+
+typedef struct {
+    uint8_t count;
+    uint8_t reserved[3];
+    profiler_wake_t wakes[PROFILER_WAKES];
+} profiler_t;
+
+static_assert(sizeof(profiler_t) <= MEMORY_PROFILER_SIZE, "Profiler block too small");
+
+static profiler_t profiler_history;
+
+static const char *profiler_names[Profiler::PHASE_MAX + 1] = {
+    "boot", "files", "extender", "associate", "dhcp", "ntp", "conversion",
+    "ds18b20", "bmx280", "sht30", "dht22", "tsl2561", "veml6070", "ads1115",
+    "connect", "request", "response", "sleep", "awake"
+};
+
+// Packs the given microseconds into 12 bits of mantissa and 4 bits of exponent (up to 134 s).
+static uint16_t profiler_pack(uint32_t micros) {
+    uint8_t exponent = 0;
+    while (micros > 0x0fff) {
+        if (exponent == 15) {
+            return 0xffff;
+        }
+        micros >>= 1;
+        exponent++;
+    }
+    return (exponent << 12) | micros;
+}
+
+static uint32_t profiler_unpack(uint16_t packed) {
+    return (uint32_t) (packed & 0x0fff) << (packed >> 12);
+}
+
+// Returns true, if the given wake used the radio.
+static bool profiler_radio(const profiler_wake_t &wake) {
+    return wake.spans[Profiler::associate] != 0 || wake.spans[Profiler::connect] != 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Profiler::Profiler(void) {
+    started = false;
+    version = 0;
+    wake_start = 0;
+    memset(starts, 0, sizeof(starts));
+    memset(spans, 0, sizeof(spans));
+    running = 0;
+}
+
+bool Profiler::begin(uint16_t version) {
+    this->version = version;
+    if (!memory.load(Memory::profiler, &profiler_history, sizeof(profiler_history)) ||
+        profiler_history.count > PROFILER_WAKES) {
+        memset(&profiler_history, 0, sizeof(profiler_history));
+    }
+    started = true;
+    wake_start = 0;
+    spans[boot] = micros();
+    return true;
+}
+
+void Profiler::start(phase phase) {
+    if (!started) {
+        return;
+    }
+    starts[phase] = micros();
+    running |= 1UL << phase;
+}
+
+void Profiler::stop(phase phase) {
+    if (!started || !(running & (1UL << phase))) {
+        return;
+    }
+    spans[phase] += micros() - starts[phase];
+    running &= ~(1UL << phase);
+}
+
+void Profiler::add(phase phase, uint32_t micros) {
+    if (!started) {
+        return;
+    }
+    spans[phase] += micros;
+}
+
+void Profiler::end(uint32_t unixtime) {
+    if (!started) {
+        return;
+    }
+    for (uint8_t i = 0; i <= PHASE_MAX; i++) {
+        stop((phase) i);
+    }
+    unsigned long now = micros();
+    spans[awake] = now - wake_start;
+
+    profiler_wake_t current;
+    current.unixtime = unixtime;
+    current.version = version;
+    for (uint8_t i = 0; i <= PHASE_MAX; i++) {
+        current.spans[i] = profiler_pack(spans[i]);
+    }
+
+    if (profiler_history.count == PROFILER_WAKES) {
+        // drop the oldest wake, unless it is the latest using the radio and the current is not
+        uint8_t drop = 0;
+        if (PROFILER_WAKES > 1 && !profiler_radio(current) && profiler_radio(profiler_history.wakes[0])) {
+            drop = 1;
+            for (uint8_t i = 1; i < PROFILER_WAKES; i++) {
+                if (profiler_radio(profiler_history.wakes[i])) {
+                    drop = 0;
+                    break;
+                }
+            }
+        }
+        memmove(&profiler_history.wakes[drop], &profiler_history.wakes[drop + 1],
+            sizeof(profiler_wake_t) * (PROFILER_WAKES - 1 - drop)
+        );
+        profiler_history.count--;
+    }
+    profiler_history.wakes[profiler_history.count++] = current;
+    memory.save(Memory::profiler, &profiler_history, sizeof(profiler_history));
+
+    // the next wake starts now if not sleeping deeply
+    memset(spans, 0, sizeof(spans));
+    wake_start = now;
+}
+
+uint8_t Profiler::count(void) {
+    return profiler_history.count;
+}
+
+bool Profiler::get(uint8_t index, uint32_t &unixtime, uint16_t &version, uint32_t *spans) {
+    if (index >= profiler_history.count) {
+        return false;
+    }
+    profiler_wake_t *wake = &profiler_history.wakes[index];
+    unixtime = wake->unixtime;
+    version = wake->version;
+    for (uint8_t i = 0; i <= PHASE_MAX; i++) {
+        spans[i] = profiler_unpack(wake->spans[i]);
+    }
+    return true;
+}
+
+void Profiler::clear(void) {
+    profiler_history.count = 0;
+    if (started) {
+        memory.save(Memory::profiler, &profiler_history, sizeof(profiler_history));
+    }
+}
+
+const char *Profiler::name(phase phase) {
+    return profiler_names[phase];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
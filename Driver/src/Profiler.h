@@ -0,0 +1,85 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Operating Support:
+// Class to measure where the awake time of a wake goes. Spans of named phases are measured in
+// microseconds and summed up per wake. At the end of a wake the spans are kept in RTC memory for
+// the last PROFILER_WAKES wakes, until they are sent to the server and cleared. The latest wake
+// using the radio is kept over later wakes, which only read sensors, so the spans of the network
+// are sent as well. Spans are kept with 12 significant bits, so spans up to 4 ms are exact to the
+// microsecond.
+// This is a no-op until begin is called.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Number of wakes to keep spans for.
+#define PROFILER_WAKES 2
+
+class Profiler {
+public:
+    // Enumeration of phases of a wake.
+    enum phase {
+      boot = 0, // until the profiler begins
+      files,
+      extender, // I2C extender until all devices are ready
+      associate, // WiFi association (including DHCP, if not distinguishable)
+      dhcp,
+      ntp,
+      conversion, // waiting for conversions of sensors
+      ds18b20,
+      bmx280,
+      sht30,
+      dht22,
+      tsl2561,
+      veml6070,
+      ads1115, // analog sensors via ADS1115
+      connect, // HTTP connect
+      request,
+      response,
+      sleep, // preparing deep sleep
+      awake, // total, set at the end of a wake
+      PHASE_MAX = awake
+    };
+
+    Profiler(void);
+
+    // Begin profiling wakes of the given firmware version. Loads the spans of previous wakes from
+    // RTC memory and takes the time since boot.
+    bool begin(uint16_t version);
+
+    // Starts a span of the given phase.
+    void start(phase phase);
+    // Stops a span of the given phase and adds it to the phase. Does nothing if not started.
+    void stop(phase phase);
+    // Adds a span of the given microseconds measured elsewhere to the given phase.
+    void add(phase phase, uint32_t micros);
+
+    // Ends the current wake at the given time (seconds since 1970-01-01, 0 if unknown). Stops all
+    // spans and keeps them in RTC memory, dropping the oldest wake if needed, but not the latest
+    // wake using the radio for a wake not using it.
+    void end(uint32_t unixtime);
+
+    // Returns the number of kept wakes.
+    uint8_t count(void);
+    // Gets the kept wake with the given index (0 is the oldest). Spans are in microseconds and
+    // must have room for PHASE_MAX + 1 values.
+    bool get(uint8_t index, uint32_t &unixtime, uint16_t &version, uint32_t *spans);
+    // Discards all kept wakes.
+    void clear(void);
+
+    // Returns the name of the given phase.
+    static const char *name(phase phase);
+
+private:
+    bool started;
+    uint16_t version;
+
+    unsigned long wake_start; // micros() at the start of the current wake
+    unsigned long starts[PHASE_MAX + 1]; // micros() at the start of running spans
+    uint32_t spans[PHASE_MAX + 1];
+    uint32_t running; // bit mask of running spans
+};
+
+#endif
@@ -5,207 +5,168 @@
 
 #include "Readings.h"
 
+#include "Notification.h"
+
 #include "SERIAL.h"
 
+#if !defined(FPSTR)
+#define FPSTR(pstr) (reinterpret_cast<const __FlashStringHelper *>(pstr))
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-Readings::Readings(void) { }
+// Names and units for printing.
+static const char readings_label_temperature[] PROGMEM = "Temperature";
+static const char readings_label_temperature_alternate[] PROGMEM = "Temperature (alternate)";
+static const char readings_label_temperature_external[] PROGMEM = "Temperature (external)";
+static const char readings_label_temperature_external2[] PROGMEM = "Temperature (external 2)";
+static const char readings_label_temperature_external3[] PROGMEM = "Temperature (external 3)";
+static const char readings_label_pressure[] PROGMEM = "Pressure";
+static const char readings_label_humidity[] PROGMEM = "Humidity";
+static const char readings_label_humidity_alternate[] PROGMEM = "Humidity (alternate)";
+static const char readings_label_illuminance[] PROGMEM = "Illuminance";
+static const char readings_label_uvintensity[] PROGMEM = "UV Intensity";
+static const char readings_label_voltage[] PROGMEM = "Voltage";
+
+static const char readings_unit_celsius[] PROGMEM = " °C";
+static const char readings_unit_hectopascal[] PROGMEM = " hPa";
+static const char readings_unit_percent[] PROGMEM = " %";
+static const char readings_unit_lux[] PROGMEM = " lm/m^2";
+static const char readings_unit_irradiance[] PROGMEM = " W/m^2";
+static const char readings_unit_volt[] PROGMEM = " V";
+
+// One row for each reading type in order of the types. Values are kept in SI units (except
+// temperature in °C and voltage in mV) and printed in common units.
+static constexpr Readings::descriptor_t readings_descriptors[Readings::READING_TYPE_MAX + 1] = {
+    // field             label                                   unit
+    //     print scale, decimals, alternate                       pack scale, offset
+    { "temperature0", readings_label_temperature, readings_unit_celsius,
+        1.0, 1, Readings::temperature_alternate, 100.0, 0.0 },
+    { "temperature0_1", readings_label_temperature_alternate, readings_unit_celsius,
+        1.0, 1, -1, 100.0, 0.0 },
+    { "temperature1", readings_label_temperature_external, readings_unit_celsius,
+        1.0, 1, -1, 100.0, 0.0 },
+    { "pressure0", readings_label_pressure, readings_unit_hectopascal,
+        0.01, 2, -1, 0.5, 70000.0 },
+    { "humidity0", readings_label_humidity, readings_unit_percent,
+        1.0, 0, Readings::humidity_alternate, 100.0, 0.0 },
+    { "humidity0_1", readings_label_humidity_alternate, readings_unit_percent,
+        1.0, 0, -1, 100.0, 0.0 },
+    // illuminance and UV intensity are not sent
+    { NULL, readings_label_illuminance, readings_unit_lux,
+        1.0, 1, -1, 1.0, 32767.0 },
+    { NULL, readings_label_uvintensity, readings_unit_irradiance, // mW/cm^2 (ML8511)
+        10.0, 1, -1, 1000.0, 0.0 },
+    { "voltage0", readings_label_voltage, readings_unit_volt,
+        0.001, 1, -1, 1.0, 0.0 },
+    { "temperature2", readings_label_temperature_external2, readings_unit_celsius,
+        1.0, 1, -1, 100.0, 0.0 },
+    { "temperature3", readings_label_temperature_external3, readings_unit_celsius,
+        1.0, 1, -1, 100.0, 0.0 }
+};
+
+const Readings::descriptor_t &Readings::descriptor(reading_type type) {
+    return readings_descriptors[type];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Readings::Readings(void) {
+    clear();
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 void Readings::clear(void) {
-    readings.timestamp = 0;
-    readings.temperature = NAN;
-    readings.temperature_alternate = NAN;
-    readings.temperature_external = NAN;
-    readings.pressure = NAN;
-    readings.humidity = NAN;
-    readings.humidity_alternate = NAN;
-    readings.illuminance = NAN;
-    readings.uvintensity = NAN;
-    readings.voltage = NAN;
     for (int i = 0; i <= READING_TYPE_MAX; i++) {
-        sensor_ids[i] = String();
+        values[i] = NAN;
+        sensor_ids[i] = NULL;
     }
 }
 
 /// Stores the specified value for the specified type of reading. If a value is stored for that
-/// reading type already, does nothing. So, be sure to clear the readings before trying to store new
-/// readings.
-void Readings::store(float value, reading_type type, String sensor_id) {
-    bool stored = false;
-    switch (type) {
-    case voltage:
-        if (isnan(readings.voltage)) {
-            readings.voltage = value;
-            stored = true;
-        }
-        break;
-    case temperature:
-        if (isnan(readings.temperature)) {
-            readings.temperature = value;
-            stored = true;
-            break;
-        }
-        // fallthrough allows setting alternate value if original value is set already
-    case temperature_alternate:
-        if (isnan(readings.temperature_alternate)) {
-            type = temperature_alternate;
-            readings.temperature_alternate = value;
-            stored = true;
-        }
-        break;
-    case temperature_external:
-        if (isnan(readings.temperature_external)) {
-            readings.temperature_external = value;
-            stored = true;
-        }
-        break;
-    case pressure:
-        if (isnan(readings.pressure)) {
-            readings.pressure = value;
-            stored = true;
-        }
-        break;
-    case humidity:
-        if (isnan(readings.humidity)) {
-            readings.humidity = value;
-            stored = true;
-            break;
-        }
-        // fallthrough allows setting alternate value if original value is set already
-    case humidity_alternate:
-        if (isnan(readings.humidity_alternate)) {
-            type = humidity_alternate;
-            readings.humidity_alternate = value;
-            stored = true;
-        }
-        break;
-    case illuminance:
-        if (isnan(readings.illuminance)) {
-            readings.illuminance = value;
-            stored = true;
-        }
-        break;
-    case uvintensity:
-        if (isnan(readings.uvintensity)) {
-            readings.uvintensity = value;
-            stored = true;
-        }
-        break;
+/// reading type already, the value is stored for its alternate type if any, or dropped otherwise.
+/// So, be sure to clear the readings before trying to store new readings.
+void Readings::store(float value, reading_type type, PGM_P sensor_id) {
+    int8_t slot = type;
+    while (slot >= 0 && !isnan(values[slot])) {
+        slot = readings_descriptors[slot].alternate;
     }
-    if (stored) {
-        sensor_ids[type] = sensor_id;
+    if (slot >= 0) {
+        values[slot] = value;
+        sensor_ids[slot] = sensor_id;
     }
 }
-void Readings::store(float value, reading_type type) {
-    store(value, type, String());
-}
 
-float Readings::retrieve(reading_type type, String &sensor_id) {
-    sensor_id = sensor_ids[type];
-    return retrieve(type);
-}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define PACKED_NAN INT16_MIN
 
-float Readings::retrieve(reading_type type) {
-    switch (type) {
-    case voltage:
-        return readings.voltage;
-    case temperature:
-        return readings.temperature;
-    case temperature_alternate:
-        return readings.temperature_alternate;
-    case temperature_external:
-        return readings.temperature_external;
-    case pressure:
-        return readings.pressure;
-    case humidity:
-        return readings.humidity;
-    case humidity_alternate:
-        return readings.humidity_alternate;
-    case illuminance:
-        return readings.illuminance;
-    case uvintensity:
-        return readings.uvintensity;
+void Readings::pack(int16_t *values) {
+    for (int i = 0; i <= READING_TYPE_MAX; i++) {
+        float value = retrieve(static_cast<reading_type>(i));
+        if (isnan(value)) {
+            values[i] = PACKED_NAN;
+            continue;
+        }
+        const descriptor_t &descriptor = readings_descriptors[i];
+        float packed = roundf((value - descriptor.pack_offset) * descriptor.pack_scale);
+        values[i] = (int16_t) constrain(packed, (float) (INT16_MIN + 1), (float) INT16_MAX);
     }
-    return NAN;
 }
 
-void Readings::print(reading_type type) {
-    String sensor_id;
-    float value = retrieve(type, sensor_id);
-    if (!isnan(value)) {
-        switch (type) {
-        case voltage:
-            SERIAL_PRINTF(value/1000, 1);
-            SERIAL_PRINT(F(" V"));
-            break;
-        case temperature:
-        case temperature_alternate:
-        case temperature_external:
-            SERIAL_PRINTF(value, 1);
-            SERIAL_PRINT(F(" °C"));
-            break;
-        case pressure: // in pascal
-            SERIAL_PRINTF(value/100, 2);
-            SERIAL_PRINT(F(" hPa"));
-            break;
-        case humidity: // in percent
-        case humidity_alternate:
-            SERIAL_PRINTF(value, 0);
-            SERIAL_PRINT(F(" \045"));
-            break;
-        case illuminance: // in lux
-            SERIAL_PRINTF(value, 1);
-            SERIAL_PRINT(F(" lm/m^2"));
-            break;
-        case uvintensity: // in mW/cm^2
-            SERIAL_PRINTF(value * 10, 1);
-            SERIAL_PRINT(F(" W/m^2"));
-            break;
+void Readings::unpack(const int16_t *values) {
+    clear();
+    for (int i = 0; i <= READING_TYPE_MAX; i++) {
+        if (values[i] != PACKED_NAN) {
+            const descriptor_t &descriptor = readings_descriptors[i];
+            this->values[i] = values[i] / descriptor.pack_scale + descriptor.pack_offset;
         }
-        String s = " (" + sensor_id + ")";
-        SERIAL_PRINT(s);
-    }
-    else {
-        SERIAL_PRINT(F("N/A"));
     }
 }
 
-void Readings::print(void) {
-    SERIAL_PRINT(F("Voltage:                 "));
-    print(voltage);
-    SERIAL_PRINTLN();
-
-    SERIAL_PRINT(F("Temperature:             "));
-    print(temperature);
-    SERIAL_PRINTLN();
+///////////////////////////////////////////////////////////////////////////////////////////////////
 
-    SERIAL_PRINT(F("Temperature (alternate): "));
-    print(temperature_alternate);
-    SERIAL_PRINTLN();
+// output of readings is removed together with info notifications
+#if NOTIFICATION_LEVEL >= NOTIFICATION_LEVEL_INFO
 
-    SERIAL_PRINT(F("Temperature (external):  "));
-    print(temperature_external);
-    SERIAL_PRINTLN();
+// Column of printed values.
+#define READINGS_PRINT_COLUMN 26
 
-    SERIAL_PRINT(F("Pressure:                "));
-    print(pressure);
-    SERIAL_PRINTLN();
+void Readings::print(reading_type type) {
+    const descriptor_t &descriptor = readings_descriptors[type];
+    SERIAL_PRINT(FPSTR(descriptor.label));
+    SERIAL_PRINT(F(":"));
+    for (size_t i = strlen_P(descriptor.label) + 1; i < READINGS_PRINT_COLUMN; i++) {
+        SERIAL_PRINT(' ');
+    }
+    float value = values[type];
+    if (isnan(value)) {
+        SERIAL_PRINT(F("N/A"));
+        return;
+    }
+    SERIAL_PRINTF(value * descriptor.print_scale, descriptor.print_decimals);
+    SERIAL_PRINT(FPSTR(descriptor.unit));
+    if (sensor_ids[type] != NULL) {
+        SERIAL_PRINT(F(" ("));
+        SERIAL_PRINT(FPSTR(sensor_ids[type]));
+        SERIAL_PRINT(F(")"));
+    }
+}
 
-    SERIAL_PRINT(F("Humidity:                "));
-    print(humidity);
-    SERIAL_PRINTLN();
+void Readings::print(void) {
+    for (int i = 0; i <= READING_TYPE_MAX; i++) {
+        print(static_cast<reading_type>(i));
+        SERIAL_PRINTLN();
+    }
+}
 
-    SERIAL_PRINT(F("Humidity (alternate):    "));
-    print(humidity_alternate);
-    SERIAL_PRINTLN();
+#else
 
-    SERIAL_PRINT(F("Illuminance:             "));
-    print(illuminance);
-    SERIAL_PRINTLN();
+void Readings::print(reading_type type) {
+}
 
-    SERIAL_PRINT(F("UV Intensity:            "));
-    print(uvintensity);
-    SERIAL_PRINTLN();
+void Readings::print(void) {
 }
+
+#endif
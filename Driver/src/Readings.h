@@ -8,25 +8,12 @@
 // Class to collect all sensor readings of the Weather Station. A sensor reading consists of
 // a measured sensor value and a sensor type. Optionally a sensor identification string can be
 // attached. For example (15.9, temperature, "BME280")
+//
+// Values are kept in an array indexed by reading type, each type is described by one row of a
+// table (see descriptor). Sensor identification strings are kept in flash memory and only
+// referenced, so no memory is allocated.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-#if ! defined(__time_t_defined)
-typedef unsigned long time_t;
-#endif
-
-typedef struct {
-    time_t timestamp;
-    float voltage;
-    float temperature;
-    float temperature_alternate;
-    float temperature_external;
-    float pressure;
-    float humidity;
-    float humidity_alternate;
-    float illuminance;
-    float uvintensity;
-} readings_t;
-
 class Readings {
 public:
     enum reading_type {
@@ -39,33 +26,57 @@ public:
         illuminance = 6,
         uvintensity = 7,
         voltage = 8,
-        READING_TYPE_MAX = voltage
+        temperature_external2 = 9,
+        temperature_external3 = 10,
+        READING_TYPE_MAX = temperature_external3
     };
 
+    // Description of a reading type.
+    typedef struct {
+        const char *field;             // key of the line protocol field, NULL if not sent
+        PGM_P label;                   // name for printing (in flash memory)
+        PGM_P unit;                    // unit for printing (in flash memory)
+        float print_scale;             // factor from the value to the printed value
+        uint8_t print_decimals;
+        int8_t alternate;              // type taking values if this is stored already, or -1
+        float pack_scale;              // fixed-point encoding: value = packed / scale + offset
+        float pack_offset;
+    } descriptor_t;
+
+    // Returns the description of the given reading type.
+    static const descriptor_t &descriptor(reading_type type);
+
     Readings(void);
 
     // Clears all sensor readings.
     void clear(void);
 
-    // Stores a given sensor reading value for the given sensor reading type.
-    void store(float value, reading_type type);
     // Stores a given sensor reading value for the given sensor reading type and attaches the given
-    // sensor identification string.
-    void store(float value, reading_type type, String sensor_id);
+    // sensor identification string (in flash memory, must outlive the readings), if any.
+    void store(float value, reading_type type, PGM_P sensor_id = NULL);
 
     // Retrieves a stored sensor reading value for the given sensor reading type.
-    float retrieve(reading_type type);
+    float retrieve(reading_type type) const { return values[type]; }
     // Retrieves a stored sensor reading value for the given sensor reading type and gives the
-    // attached sensor identification string.
-    float retrieve(reading_type type, String &sensor_id);
+    // attached sensor identification string (in flash memory, NULL if none).
+    float retrieve(reading_type type, PGM_P &sensor_id) const {
+        sensor_id = sensor_ids[type];
+        return values[type];
+    }
+
+    // Packs all stored sensor reading values into the given array of READING_TYPE_MAX + 1
+    // fixed-point values. Used to keep readings in a compact form.
+    void pack(int16_t *values);
+    // Clears all sensor readings and stores the values of the given packed array.
+    void unpack(const int16_t *values);
 
     // Prints all stored sensor readings. Diagnostic method.
     void print(void);
 
 private:
-    readings_t readings;
+    float values[READING_TYPE_MAX + 1];
 
-    String sensor_ids[READING_TYPE_MAX + 1];
+    PGM_P sensor_ids[READING_TYPE_MAX + 1];
 
     void print(reading_type type);
 
@@ -1,21 +1,32 @@
 
 // Macros for printing to the serial console.
 
+// Output is buffered and sent without blocking (see Logger.h).
+
 #define SERIAL_OUT 1
 
+// Baud rate of the serial console.
+#if !defined(SERIAL_BAUD)
+#define SERIAL_BAUD 115200
+#endif
+
 #if SERIAL_OUT
-#define SERIAL_BEGIN() { delay(100); Serial.begin(9600); while (!Serial);  delay(100); }
+#include "Logger.h"
+extern Logger logger;
+#define SERIAL_BEGIN() { logger.begin(SERIAL_BAUD); }
+#define SERIAL_FLUSH() { logger.flush(); }
 #define SERIAL_DEBUG() { Serial.setDebugOutput(true); }
-#define SERIAL_PRINT(s) { Serial.print(s); }
-#define SERIAL_PRINTF(s, f) { Serial.print(s, f); }
-#define SERIAL_PRINTB(b) { b ? Serial.print(F("TRUE")) : Serial.print(F("FALSE")); }
-#define SERIAL_PRINTLN(s) { Serial.println(s); }
-#define SERIAL_PRINT_BANNER(m) { Serial.println(); Serial.println(m); }
-#define SERIAL_PRINT_NUMBER(m, v) { Serial.print(m); Serial.print(v); Serial.println(); }
-#define SERIAL_PRINT_MILLIS(m, v) { Serial.print(m); Serial.print(v); Serial.print(F(" ms")); Serial.println(); }
-#define SERIAL_PRINT_BYTE(b) { Serial.print(F("0x")); if (b < 16) Serial.print(F("0")); Serial.print(b, HEX); }
+#define SERIAL_PRINT(s) { logger.print(s); }
+#define SERIAL_PRINTF(s, f) { logger.print(s, f); }
+#define SERIAL_PRINTB(b) { b ? logger.print(F("TRUE")) : logger.print(F("FALSE")); }
+#define SERIAL_PRINTLN(s) { logger.println(s); }
+#define SERIAL_PRINT_BANNER(m) { logger.println(); logger.println(m); }
+#define SERIAL_PRINT_NUMBER(m, v) { logger.print(m); logger.print(v); logger.println(); }
+#define SERIAL_PRINT_MILLIS(m, v) { logger.print(m); logger.print(v); logger.print(F(" ms")); logger.println(); }
+#define SERIAL_PRINT_BYTE(b) { logger.print(F("0x")); if (b < 16) logger.print(F("0")); logger.print(b, HEX); }
 #else
 #define SERIAL_BEGIN()
+#define SERIAL_FLUSH()
 #define SERIAL_DEBUG()
 #define SERIAL_PRINT(s)
 #define SERIAL_PRINTF(s, f)
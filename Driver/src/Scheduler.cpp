@@ -0,0 +1,143 @@
+#include <Arduino.h>
+
+#include "Scheduler.h"
+
+#include "Readings.h"
+#include "Memory.h"
+
+extern Memory memory;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    int16_t values[Readings::READING_TYPE_MAX + 1]; // packed previous readings
+    uint16_t elapsed; // seconds since the previous readings
+    uint32_t interval; // previous interval in milliseconds, before stretching for the voltage
+} scheduler_t;
+
+static_assert(sizeof(scheduler_t) <= MEMORY_SCHEDULER_SIZE, "Scheduler block too small");
+
+static scheduler_t scheduler;
+static bool scheduler_valid = false;
+
+// Factor to stretch the interval by on every cycle with stable readings.
+#define SCHEDULER_STRETCH_STEP 1.5
+// Fraction of the fast rate of change, below which readings are stable.
+#define SCHEDULER_STABLE 0.5
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Scheduler::Scheduler(unsigned long interval, unsigned long interval_min,
+    unsigned long interval_max)
+{
+    this->interval = interval;
+    this->interval_min = std::min(interval_min, interval);
+    this->interval_max = std::max(interval_max, interval);
+    for (int i = 0; i <= Readings::READING_TYPE_MAX; i++) {
+        rates[i] = 0.0;
+    }
+    this->voltage_full = 0.0;
+    this->voltage_low = 0.0;
+    this->voltage_stretch = 1.0;
+    this->last_millis = 0;
+}
+
+void Scheduler::rate(Readings::reading_type type, float rate) {
+    rates[type] = rate;
+}
+
+void Scheduler::voltage(float full, float low, float stretch) {
+    voltage_full = full;
+    voltage_low = low;
+    voltage_stretch = std::max(stretch, 1.0f);
+}
+
+bool Scheduler::begin(void) {
+    last_millis = millis();
+    scheduler_valid = memory.load(Memory::scheduler, &scheduler, sizeof(scheduler));
+    return true;
+}
+
+unsigned long Scheduler::next(Readings &readings) {
+    // without previous readings there is no rate of change
+    Readings previous;
+    unsigned long elapsed = 0;
+    unsigned long interval_previous = interval;
+    if (scheduler_valid) {
+        previous.unpack(scheduler.values);
+        elapsed = scheduler.elapsed * 1000UL;
+        interval_previous = scheduler.interval;
+    }
+    // compare packed values, so rounding is the same as for previous readings
+    Readings current;
+    readings.pack(scheduler.values);
+    current.unpack(scheduler.values);
+    unsigned long result = compute(current, previous, elapsed, interval_previous);
+
+    scheduler.elapsed = 0;
+    scheduler.interval = result;
+    last_millis = millis();
+    scheduler_valid = memory.save(Memory::scheduler, &scheduler, sizeof(scheduler));
+    return stretch(current, result);
+}
+
+void Scheduler::elapse(unsigned long sleep_millis) {
+    if (!scheduler_valid) {
+        return;
+    }
+    unsigned long elapsed = scheduler.elapsed + (millis() - last_millis + sleep_millis + 500) / 1000;
+    scheduler.elapsed = std::min(elapsed, (unsigned long) UINT16_MAX);
+    // when delaying instead of deep sleep, millis will have advanced by the sleep duration
+    last_millis = millis() + sleep_millis;
+    memory.save(Memory::scheduler, &scheduler, sizeof(scheduler));
+}
+
+unsigned long Scheduler::compute(Readings &readings, Readings &previous, unsigned long elapsed,
+    unsigned long interval_previous)
+{
+    // activity is the largest rate of change relative to its fast rate
+    float activity = 0.0;
+    if (elapsed > 0) {
+        float hours = elapsed / 3600000.0;
+        for (int i = 0; i <= Readings::READING_TYPE_MAX; i++) {
+            if (rates[i] <= 0.0) {
+                continue;
+            }
+            Readings::reading_type type = static_cast<Readings::reading_type>(i);
+            float value = readings.retrieve(type);
+            float value_previous = previous.retrieve(type);
+            if (isnan(value) || isnan(value_previous)) {
+                continue;
+            }
+            activity = std::max(activity, (float) (fabs(value - value_previous) / hours / rates[i]));
+        }
+    }
+
+    float result;
+    if (activity >= 1.0) {
+        // fast change: shorten at once
+        result = interval / activity;
+    }
+    else if (elapsed > 0 && activity < SCHEDULER_STABLE) {
+        // stable: stretch step by step
+        result = std::max(interval_previous, interval) * SCHEDULER_STRETCH_STEP;
+        result = std::min(result, (float) interval_max);
+    }
+    else {
+        result = interval;
+    }
+    return constrain((unsigned long) result, interval_min, interval_max);
+}
+
+unsigned long Scheduler::stretch(Readings &readings, unsigned long planned) {
+    // low voltage: stretch up to the voltage stretch factor
+    float result = planned;
+    float voltage = readings.retrieve(Readings::voltage);
+    if (!isnan(voltage) && voltage_full > voltage_low && voltage < voltage_full) {
+        float level = std::min((voltage_full - voltage) / (voltage_full - voltage_low), 1.0f);
+        result = result * (1.0 + level * (voltage_stretch - 1.0));
+    }
+
+    unsigned long result_max = interval_max * voltage_stretch;
+    return constrain((unsigned long) result, interval_min, result_max);
+}
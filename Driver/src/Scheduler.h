@@ -0,0 +1,65 @@
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to compute the interval until the next measuring cycle at runtime. The interval is
+// shortened while readings change fast, stretched step by step while readings are stable and
+// stretched further while the supply voltage is low. The previous readings and interval and the
+// time since are kept in RTC memory. The rate of change is taken over the time, which actually
+// passed between the readings, as the sleep may differ from the interval (see elapse).
+//
+// The policy itself (see compute) depends on its arguments and the configuration only.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Readings.h"
+
+class Scheduler {
+public:
+    // Constructs a scheduler with the given base interval, which may be shortened down to the
+    // given minimum and stretched up to the given maximum for stable readings (milliseconds).
+    Scheduler(unsigned long interval, unsigned long interval_min, unsigned long interval_max);
+
+    // Sets the rate of change per hour for the given reading type, which is considered fast.
+    // Reading types without rate are not considered.
+    void rate(Readings::reading_type type, float rate);
+    // Sets the voltage range (mV), in which the interval is stretched up to the given factor.
+    // The interval is not stretched above full, and fully stretched below low.
+    void voltage(float full, float low, float stretch);
+
+    // Begin managing the schedule. Loads the previous readings kept in RTC memory.
+    // Must be called before next.
+    bool begin(void);
+
+    // Returns the interval until the next measuring cycle for the given readings and keeps them
+    // for the next cycle.
+    unsigned long next(Readings &readings);
+
+    // Advances the time since the previous readings by the time awake and the given sleep
+    // duration. To be called before sleeping.
+    void elapse(unsigned long sleep_millis);
+
+    // Returns the interval for the given readings, taken the given time (milliseconds) after the
+    // given previous readings, and the previous interval, both before stretching for the voltage.
+    unsigned long compute(Readings &readings, Readings &previous, unsigned long elapsed,
+        unsigned long interval_previous);
+    // Returns the given planned interval stretched for the supply voltage of the given readings.
+    unsigned long stretch(Readings &readings, unsigned long planned);
+
+private:
+    unsigned long interval;
+    unsigned long interval_min;
+    unsigned long interval_max;
+
+    float rates[Readings::READING_TYPE_MAX + 1];
+
+    float voltage_full;
+    float voltage_low;
+    float voltage_stretch;
+
+    unsigned long last_millis;
+};
+
+#endif
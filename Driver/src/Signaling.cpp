@@ -3,8 +3,24 @@
 
 #include "Signaling.h"
 
+#include "Energy.h"
+
+extern Energy energy;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Writes the given value to the given pin, which is active low, and accounts the time it is on.
+static void signaling_write(int pin, int value) {
+    digitalWrite(pin, value);
+    if (value == LOW) {
+        energy.start(Energy::led);
+    }
+    else {
+        energy.stop(Energy::led);
+    }
+}
+
+
 Signaling::Signaling(int ledpin) {
     this->ledpin = ledpin;
     this->production = false;
@@ -15,7 +31,7 @@ bool Signaling::begin(bool production) {
 
     if (ledpin >= 0) {
         pinMode(ledpin, OUTPUT);
-        digitalWrite(ledpin, HIGH);
+        signaling_write(ledpin, HIGH);
     }
     return true;
 }
@@ -24,21 +40,21 @@ bool Signaling::begin(bool production) {
 
 void Signaling::signal_off(void) {
     if (ledpin >= 0) {
-        digitalWrite(ledpin, HIGH);
+        signaling_write(ledpin, HIGH);
     }
 }
 void Signaling::signal_toggle(void) {
     if (ledpin >= 0) {
         int state = digitalRead(ledpin);
-        digitalWrite(ledpin, !state);
+        signaling_write(ledpin, !state);
     }
 }
 
 void Signaling::signal_failure_once(int ms) {
     if (ledpin >= 0) {
-        digitalWrite(ledpin, LOW);
+        signaling_write(ledpin, LOW);
         delay(ms);
-        digitalWrite(ledpin, HIGH);
+        signaling_write(ledpin, HIGH);
         delay(ms);
     }
 }
@@ -46,15 +62,15 @@ void Signaling::signal_failure_once(int ms) {
 void Signaling::signal_failure_count_once(uint8_t num) {
     if (ledpin >= 0) {
         for (uint8_t i = 0; i < num; i++) {
-            digitalWrite(ledpin, LOW);
+            signaling_write(ledpin, LOW);
             delay(500);
-            digitalWrite(ledpin, HIGH);
+            signaling_write(ledpin, HIGH);
             delay(500);
         }
         for (uint8_t i = 0; i < 20; i++) {
-            digitalWrite(ledpin, LOW);
+            signaling_write(ledpin, LOW);
             delay(50);
-            digitalWrite(ledpin, HIGH);
+            signaling_write(ledpin, HIGH);
             delay(50);
         }
     }
@@ -62,9 +78,9 @@ void Signaling::signal_failure_count_once(uint8_t num) {
 
 void Signaling::signal_failure_forever(int ms) {
     while (ledpin >= 0) {
-        digitalWrite(ledpin, LOW);
+        signaling_write(ledpin, LOW);
         delay(ms);
-        digitalWrite(ledpin, HIGH);
+        signaling_write(ledpin, HIGH);
         delay(ms);
     }
     while(1) {
@@ -75,15 +91,15 @@ void Signaling::signal_failure_forever(int ms) {
 void Signaling::signal_failure_count_forever(uint8_t num) {
     while (ledpin >= 0) {
         for (uint8_t i = 0; i < num; i++) {
-            digitalWrite(ledpin, LOW);
+            signaling_write(ledpin, LOW);
             delay(500);
-            digitalWrite(ledpin, HIGH);
+            signaling_write(ledpin, HIGH);
             delay(500);
         }
         for (uint8_t i = 0; i < 20; i++) {
-            digitalWrite(ledpin, LOW);
+            signaling_write(ledpin, LOW);
             delay(50);
-            digitalWrite(ledpin, HIGH);
+            signaling_write(ledpin, HIGH);
             delay(50);
         }
     }
@@ -21,7 +21,7 @@ RESET_REASON System::lastResetReason() {
     return static_cast<RESET_REASON>(info->reason);
 }
 
-bool lastResetReasonIsDeepSleepAwake() {
+bool System::lastResetReasonIsDeepSleepAwake() {
     return System::lastResetReason() == REASON_DEEP_SLEEP_AWAKE;
 }
 
@@ -52,7 +52,7 @@ RESET_REASON System::lastResetReason() {
     return rtc_get_reset_reason(0);
 }
 
-bool lastResetReasonIsDeepSleepAwake() {
+bool System::lastResetReasonIsDeepSleepAwake() {
     return System::lastResetReason() == DEEPSLEEP_RESET;
 }
 
@@ -67,7 +67,9 @@ String System::lastException() {
 #if defined(ESP8266) || defined(ESP32)
 
 void System::wifiOn() {
-    //WiFi.forceSleepWake();
+    #if defined(ESP8266)
+    WiFi.forceSleepWake();
+    #endif
     delay(1);
     WiFi.mode(WIFI_STA);
     delay(100);
@@ -80,9 +82,11 @@ void System::wifiOff() {
         delay(100);
     }
     WiFi.mode(WIFI_OFF);
+    #if defined(ESP8266)
+    // power down the modem, takes effect on next yield
+    WiFi.forceSleepBegin();
+    #endif
     delay(1);
-    //WiFi.forceSleepBegin();
-    delay(100);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,10 +35,12 @@ public:
     static String lastException();
     #endif
 
+    // Powers the WiFi modem up in station mode.
     static void wifiOn();
+    // Disconnects and powers the WiFi modem down.
     static void wifiOff();
 
-    static void panic();
+    [[ noreturn ]] static void panic();
 };
 
 #endif
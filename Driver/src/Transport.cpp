@@ -9,10 +9,14 @@
 
 extern const bool PRODUCTION;
 extern Notification notification;
+extern Profiler profiler;
+extern Energy energy;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-Transport::Transport(String server, int port, String database, String logger, String location) {
+Transport::Transport(const char *server, int port, const char *database, const char *logger,
+    const char *location)
+{
     this->server = server;
     this->port = port;
     this->user = "";
@@ -21,113 +25,523 @@ Transport::Transport(String server, int port, String database, String logger, St
     this->logger = logger;
     this->location = location;
     this->network = NULL;
+    this->compressed = false;
+    this->server_time = 0;
+    this->server_time_at = 0;
+    this->diagnostics = NULL;
+    this->diagnosed = false;
+    this->accounting = NULL;
+    this->accounted = false;
+    this->aggregate = NULL;
+    this->aggregated = 0;
+    this->aggregated_time = 0;
+    this->skipped = false;
 }
 
-bool Transport::begin(Network *network) {
+bool Transport::begin(Network *network, bool compressed) {
     this->network = network;
+    this->compressed = compressed;
     return true;
 }
 
+void Transport::diagnose(Profiler *diagnostics) {
+    this->diagnostics = diagnostics;
+}
+
+void Transport::account(Energy *accounting) {
+    this->accounting = accounting;
+}
+
+uint32_t Transport::serverTime(unsigned long &at) {
+    at = server_time_at;
+    return server_time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #if defined(ESP8266) || defined(ESP32)
 
-String format_fields(Readings &readings) {
-    String fields;
+static char transport_buffer[TRANSPORT_BUFFER_SIZE];
 
-    float voltage0 = readings.retrieve(Readings::voltage);
-    if (!isnan(voltage0)) {
-        if (fields.length() > 0) fields += ",";
-        fields += "voltage0=" + String(voltage0, 4);
-    }
+static uint8_t transport_compressed_buffer[TRANSPORT_COMPRESSED_BUFFER_SIZE];
+static Deflate transport_deflate;
 
-    float temperature0 = readings.retrieve(Readings::temperature);
-    if (!isnan(temperature0)) {
-        if (fields.length() > 0) fields += ",";
-        fields += "temperature0=" + String(temperature0, 4);
+bool Transport::encode(LineProtocol &line, Readings &readings, uint32_t unixtime) {
+    line.measurement("weather");
+    line.tag("location", location);
+    line.tag("logger", logger);
+    for (int i = 0; i <= Readings::READING_TYPE_MAX; i++) {
+        Readings::reading_type type = static_cast<Readings::reading_type>(i);
+        const char *key = Readings::descriptor(type).field;
+        if (key != NULL) {
+            line.field(key, readings.retrieve(type));
+        }
     }
+    if (unixtime > 0) {
+        line.timestamp(unixtime);
+    }
+    return line.end();
+}
 
-    float temperature0_1 = readings.retrieve(Readings::temperature_alternate);
-    if (!isnan(temperature0_1)) {
-        if (fields.length() > 0) fields += ",";
-        fields += "temperature0_1=" + String(temperature0_1, 4);
+bool Transport::encode(LineProtocol &line, Aggregate &aggregate, Readings::reading_type type) {
+    // field keys are the keys of the readings with a suffix per statistic
+    char key[32];
+    uint16_t n;
+    float mean, min, max, stddev;
+    const char *field = Readings::descriptor(type).field;
+    if (field == NULL || !aggregate.get(type, n, mean, min, max, stddev)) {
+        return true;
     }
+    line.measurement("weather_stats");
+    line.tag("location", location);
+    line.tag("logger", logger);
+    snprintf(key, sizeof(key), "%s_mean", field);
+    line.field(key, mean, 2);
+    snprintf(key, sizeof(key), "%s_min", field);
+    line.field(key, min, 2);
+    snprintf(key, sizeof(key), "%s_max", field);
+    line.field(key, max, 2);
+    snprintf(key, sizeof(key), "%s_stddev", field);
+    line.field(key, stddev, 2);
+    snprintf(key, sizeof(key), "%s_n", field);
+    line.field(key, n, 0);
+    line.timestamp(aggregated_time);
+    return line.end() || !line.overflow();
+}
 
-    float temperature1 = readings.retrieve(Readings::temperature_external);
-    if (!isnan(temperature1)) {
-        if (fields.length() > 0) fields += ",";
-        fields += "temperature1=" + String(temperature1, 4);
+bool Transport::encode(LineProtocol &line, Profiler &diagnostics) {
+    char version[8];
+    uint32_t unixtime;
+    uint16_t version_number;
+    uint32_t spans[Profiler::PHASE_MAX + 1];
+    bool fitted = true;
+    for (uint8_t index = 0; diagnostics.get(index, unixtime, version_number, spans); index++) {
+        if (unixtime == 0) {
+            continue;
+        }
+        snprintf(version, sizeof(version), "%u", version_number);
+        line.measurement("weather_diag");
+        line.tag("location", location);
+        line.tag("logger", logger);
+        line.tag("version", version);
+        for (uint8_t i = 0; i <= Profiler::PHASE_MAX; i++) {
+            if (spans[i] > 0) {
+                // milliseconds with microseconds as decimals
+                line.field(Profiler::name((Profiler::phase) i), spans[i] / 1000.0, 3);
+            }
+        }
+        line.timestamp(unixtime);
+        if (!line.end() && line.overflow()) {
+            fitted = false;
+        }
     }
+    return fitted;
+}
 
-    float humidity0 = readings.retrieve(Readings::humidity);
-    if (!isnan(humidity0)) {
-        if (fields.length() > 0) fields += ",";
-        fields += "humidity0=" + String(humidity0, 4);
+bool Transport::encode(LineProtocol &line, Energy &accounting) {
+    char version[8];
+    uint32_t unixtime;
+    uint16_t version_number;
+    uint32_t cycles;
+    float charge;
+    float cycle_charge;
+    uint16_t voltage;
+    if (!accounting.get(unixtime, version_number, cycles, charge, cycle_charge, voltage) ||
+        unixtime == 0) {
+        return true;
+    }
+    snprintf(version, sizeof(version), "%u", version_number);
+    line.measurement("weather_energy");
+    line.tag("location", location);
+    line.tag("logger", logger);
+    line.tag("version", version);
+    line.field("charge", charge, 4); // mAh since power on
+    line.field("charge_cycle", cycle_charge * 1000.0, 1); // µAh of the last cycle
+    line.field("cycles", cycles, 0);
+    if (voltage > 0) {
+        line.field("voltage", voltage, 0); // mV
     }
+    line.timestamp(unixtime);
+    return line.end();
+}
+
+// Source of a single readings without timestamp.
+class TransportReadingsSource : public TransportSource {
+public:
+    TransportReadingsSource(Readings &readings) : readings(readings), done(false) { }
 
-    float humidity0_1 = readings.retrieve(Readings::humidity_alternate);
-    if (!isnan(humidity0_1)) {
-        if (fields.length() > 0) fields += ",";
-        fields += "humidity0_1=" + String(humidity0_1, 4);
+    Readings *next(uint32_t &unixtime) {
+        if (done) {
+            return NULL;
+        }
+        unixtime = 0;
+        done = true;
+        return &readings;
     }
 
-    float pressure0 = readings.retrieve(Readings::pressure);
-    if (!isnan(pressure0)) {
-        if (fields.length() > 0) fields += ",";
-        fields += "pressure0=" + String(pressure0, 4);
+private:
+    Readings &readings;
+    bool done;
+};
+
+// Source of all readings of a batch, timestamped by their age.
+class TransportBatchSource : public TransportSource {
+public:
+    TransportBatchSource(Batch &batch, uint32_t unixtime)
+        : batch(batch), unixtime(unixtime), index(0) { }
+
+    Readings *next(uint32_t &unixtime) {
+        unsigned long age;
+        if (!batch.get(index, readings, age)) {
+            return NULL;
+        }
+        unixtime = this->unixtime - age;
+        index++;
+        return &readings;
     }
 
-    return fields;
-}
+private:
+    Readings readings;
+    Batch &batch;
+    uint32_t unixtime;
+    uint8_t index;
+};
 
-bool Transport::send(Readings &readings) {
-    bool result = false;
+// Source of pending readings of a journal.
+class TransportJournalSource : public TransportSource {
+public:
+    TransportJournalSource(Journal &journal) : journal(journal) {
+        journal.rewind();
+    }
 
-    if (network) {
-        std::unique_ptr<Client> networkClient = network->createClient();
+    Readings *next(uint32_t &unixtime) {
+        return journal.next(readings, unixtime) ? &readings : NULL;
+    }
 
-        Client *networkClientPtr = networkClient.get();
-        if (networkClientPtr) {
+private:
+    Readings readings;
+    Journal &journal;
+};
 
-            HttpClient httpClient = HttpClient(*networkClientPtr, server, port);
+bool Transport::send(Readings &readings) {
+    TransportReadingsSource source(readings);
+    return send(source);
+}
 
-            String measurement = "weather";
-            String tag_set = "location=" + location + ",logger=" + logger;
-            String field_set = format_fields(readings);
+bool Transport::send(Batch &batch, uint32_t unixtime) {
+    TransportBatchSource source(batch, unixtime);
+    return send(source);
+}
 
-            if (field_set.length() > 0) {
-                notification.info(F("*TRANSPORT: database="), database);
-                notification.info(F("*TRANSPORT: measurement="), measurement);
-                notification.info(F("*TRANSPORT: tag_set="), tag_set);
-                notification.info(F("*TRANSPORT: field_set="), field_set);
+// Source of no readings, for requests of other lines only.
+class TransportEmptySource : public TransportSource {
+public:
+    Readings *next(uint32_t &) {
+        return NULL;
+    }
+};
 
-                String data = measurement + "," + tag_set + " " + field_set + "\n";
+bool Transport::send(Aggregate &aggregate, uint32_t unixtime) {
+    // lines of the reading types are merged by the server only with the same timestamp
+    aggregated_time = aggregate.start() > 0 ? aggregate.start() : unixtime;
+    if (aggregated_time == 0) {
+        notification.warn(F("*TRANSPORT: No time for statistics!"));
+        return false;
+    }
+    TransportEmptySource source;
+    this->aggregate = &aggregate;
+    this->aggregated = 0;
+    bool result = send(source);
+    this->aggregate = NULL;
+    return result;
+}
 
-                String requestPath = "/write?db=" + database + "&precision=s&user=" + user;
-                httpClient.beginRequest();
-                httpClient.post(requestPath);
-                httpClient.sendHeader("Content-Type", "application/x-www-form-urlencoded");
-                httpClient.sendHeader("Content-Length", data.length());
-                httpClient.sendHeader("User-Agent", logger);
-                httpClient.beginBody();
-                httpClient.print(data);
-                httpClient.endRequest();
+bool Transport::send(Journal &journal) {
+    TransportJournalSource source(journal);
+    bool result = send(source);
+    if (result) {
+        journal.consume();
+    }
+    return result;
+}
 
-                int statusCode = httpClient.responseStatusCode();
-                if (statusCode == 204) {
-                    result = true;
-                }
-                else {
-                    notification.warn(F("*TRANSPORT: Failed with status code "), String(statusCode));
+bool Transport::fill(LineProtocol &line, TransportSource &source,
+    Readings *&readings, uint32_t &unixtime, bool &carry)
+{
+    line.clear();
+    if (carry) {
+        carry = false;
+        encode(line, *readings, unixtime);
+        if (line.overflow()) {
+            notification.warn(F("*TRANSPORT: Skipped line exceeding buffer!"));
+            skipped = true;
+            line.clear();
+        }
+    }
+    while ((readings = source.next(unixtime)) != NULL) {
+        encode(line, *readings, unixtime);
+        if (line.overflow()) {
+            carry = true;
+            return true;
+        }
+    }
+    // statistics follow the last readings, one line per reading type
+    if (aggregate != NULL) {
+        while (aggregated <= Readings::READING_TYPE_MAX) {
+            if (!encode(line, *aggregate, static_cast<Readings::reading_type>(aggregated))) {
+                if (line.lines() > 0) {
+                    return true;
                 }
+                notification.warn(F("*TRANSPORT: Skipped line exceeding buffer!"));
+                skipped = true;
+                line.clear();
             }
-            else {
-                notification.info(F("*TRANSPORT: Empty field set!"));
-                result = true;
+            aggregated++;
+        }
+    }
+    // wakes of the diagnostics follow the last readings, if they fit
+    if (diagnostics != NULL) {
+        diagnosed = encode(line, *diagnostics);
+    }
+    if (accounting != NULL) {
+        accounted = encode(line, *accounting);
+    }
+    return false;
+}
+
+// Writes the given lines as one chunk of a request using chunked transfer encoding.
+static void transport_write_chunk(HttpClient &httpClient, LineProtocol &line) {
+    if (line.length() > 0) {
+        httpClient.print((unsigned long) line.length(), HEX);
+        httpClient.print("\r\n");
+        httpClient.print(line.c_str());
+        httpClient.print("\r\n");
+    }
+}
+
+// Returns the time of the given HTTP date (for example "Sun, 06 Nov 1994 08:49:37 GMT") as
+// seconds since 1970-01-01, or 0 if invalid.
+static uint32_t transport_parse_date(const char *date) {
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char month_name[4];
+    int day, year, hour, minute, second;
+    if (sscanf(date, " %*3s, %d %3s %d %d:%d:%d",
+        &day, month_name, &year, &hour, &minute, &second) != 6) {
+        return 0;
+    }
+    const char *month_found = strstr(months, month_name);
+    if (month_found == NULL || (month_found - months) % 3 != 0 || strlen(month_name) != 3 ||
+        year < 2000) {
+        return 0;
+    }
+    // days since 1970-01-01 of the given civil date
+    int month = (month_found - months) / 3 + 1;
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int year_of_era = y - era * 400;
+    int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    uint32_t days = era * 146097 + day_of_era - 719468;
+    return days * 86400UL + hour * 3600UL + minute * 60UL + second;
+}
+
+// Reads the remaining response headers and returns the time of the Date header, or 0 if none.
+static uint32_t transport_read_date(HttpClient &httpClient) {
+    char line[48];
+    size_t size = 0;
+    uint32_t time = 0;
+    while (!httpClient.endOfHeadersReached()) {
+        int c = httpClient.readHeader();
+        if (c < 0) {
+            break;
+        }
+        if (c == '\n') {
+            line[size] = '\0';
+            if (strncasecmp(line, "Date:", 5) == 0) {
+                time = transport_parse_date(line + 5);
             }
+            size = 0;
+        }
+        else if (c != '\r' && size < sizeof(line) - 1) {
+            line[size++] = c;
+        }
+    }
+    return time;
+}
+
+// Body of a request, which is sent with its length if it fits into the given buffer and is
+// streamed using chunked transfer encoding otherwise.
+class TransportBody : public Print {
+public:
+    TransportBody(HttpClient &httpClient, uint8_t *buffer, size_t capacity)
+        : httpClient(httpClient), buffer(buffer), capacity(capacity), size(0), chunked(false) { }
+
+    size_t write(uint8_t c) {
+        if (size == capacity) {
+            flush();
+        }
+        buffer[size++] = c;
+        return 1;
+    }
+
+    // Sends the buffered data as one chunk.
+    void flush(void) {
+        if (!chunked) {
+            httpClient.sendHeader("Transfer-Encoding", "chunked");
+            httpClient.beginBody();
+            chunked = true;
+        }
+        if (size > 0) {
+            httpClient.print((unsigned long) size, HEX);
+            httpClient.print("\r\n");
+            httpClient.write(buffer, size);
+            httpClient.print("\r\n");
+            size = 0;
+        }
+    }
+
+    // Sends the remaining data and ends the body.
+    void end(void) {
+        if (chunked) {
+            flush();
+            httpClient.print("0\r\n\r\n");
+        }
+        else {
+            httpClient.sendHeader("Content-Length", (int) size);
+            httpClient.beginBody();
+            httpClient.write(buffer, size);
+        }
+    }
+
+private:
+    HttpClient &httpClient;
+    uint8_t *buffer;
+    size_t capacity;
+    size_t size;
+    bool chunked;
+};
+
+unsigned int Transport::compress(HttpClient &httpClient, LineProtocol &line,
+    TransportSource &source, Readings *&readings, uint32_t &unixtime, bool &carry, bool more)
+{
+    httpClient.sendHeader("Content-Encoding", "gzip");
+    TransportBody body(httpClient,
+        transport_compressed_buffer, sizeof(transport_compressed_buffer)
+    );
+    transport_deflate.begin(body);
+    transport_deflate.write(line.c_str(), line.length());
+    unsigned int lines = line.lines();
+    while (more) {
+        more = fill(line, source, readings, unixtime, carry);
+        lines += line.lines();
+        transport_deflate.write(line.c_str(), line.length());
+    }
+    transport_deflate.end();
+    body.end();
+
+    notification.info(F("*TRANSPORT: size="), transport_deflate.sizeIn());
+    notification.info(F("*TRANSPORT: compressed="), transport_deflate.sizeOut());
+    return lines;
+}
+
+bool Transport::send(TransportSource &source) {
+    if (!network) {
+        return false;
+    }
+
+    LineProtocol line(transport_buffer, sizeof(transport_buffer));
+    Readings *readings = NULL;
+    uint32_t unixtime = 0;
+    bool carry = false;
+    diagnosed = false;
+    accounted = false;
+    skipped = false;
+
+    bool more = fill(line, source, readings, unixtime, carry);
+    if (!more && (line.lines() == 0)) {
+        notification.info(F("*TRANSPORT: Empty field set!"));
+        return !skipped;
+    }
+
+    notification.info(F("*TRANSPORT: database="), database);
+    if (!PRODUCTION) {
+        notification.info(F("*TRANSPORT: data="), line.c_str());
+    }
+
+    char requestPath[128];
+    snprintf(requestPath, sizeof(requestPath), "/write?db=%s&precision=s&user=%s",
+        database, user
+    );
+
+    HttpClient httpClient = HttpClient(network->client(), server, port);
+
+    profiler.start(Profiler::connect);
+    httpClient.beginRequest();
+    httpClient.post(requestPath);
+    profiler.stop(Profiler::connect);
+    profiler.start(Profiler::request);
+    energy.start(Energy::transmit);
+    httpClient.sendHeader("Content-Type", "application/x-www-form-urlencoded");
+    httpClient.sendHeader("User-Agent", logger);
+
+    unsigned int lines = line.lines();
+    if (compressed && (more || lines > 1)) {
+        // single lines are not worth compressing
+        lines = compress(httpClient, line, source, readings, unixtime, carry, more);
+    }
+    else if (!more) {
+        // all lines fit into the buffer
+        httpClient.sendHeader("Content-Length", (int) line.length());
+        httpClient.beginBody();
+        httpClient.print(line.c_str());
+    }
+    else {
+        // stream lines in chunks
+        httpClient.sendHeader("Transfer-Encoding", "chunked");
+        httpClient.beginBody();
+        transport_write_chunk(httpClient, line);
+        while (more) {
+            more = fill(line, source, readings, unixtime, carry);
+            lines += line.lines();
+            transport_write_chunk(httpClient, line);
+        }
+        httpClient.print("0\r\n\r\n");
+    }
+    httpClient.endRequest();
+    unsigned long request_sent = millis();
+    energy.stop(Energy::transmit);
+    profiler.stop(Profiler::request);
+
+    notification.info(F("*TRANSPORT: lines="), lines);
+
+    bool result = false;
+    profiler.start(Profiler::response);
+    int statusCode = httpClient.responseStatusCode();
+    if (statusCode == 204) {
+        // skipped lines are not sent, so the request is not complete
+        result = !skipped;
+    }
+    else {
+        NOTIFICATION_WARN(F("*TRANSPORT: Failed with status code "), String(statusCode));
+    }
+    if (statusCode > 0) {
+        // the server took its time about halfway between request and response
+        unsigned long response_received = millis();
+        uint32_t time = transport_read_date(httpClient);
+        if (time > 0) {
+            server_time = time;
+            server_time_at = response_received - (response_received - request_sent) / 2;
         }
-        networkClient.release();
     }
+    httpClient.stop();
+    profiler.stop(Profiler::response);
 
+    if (result && diagnosed) {
+        diagnostics->clear();
+        diagnostics = NULL;
+    }
+    if (result && accounted) {
+        accounting = NULL;
+    }
     return result;
 }
 
@@ -139,5 +553,21 @@ bool Transport::send(Readings &readings) {
     return false;
 }
 
+bool Transport::send(Batch &batch, uint32_t unixtime) {
+    return false;
+}
+
+bool Transport::send(Aggregate &aggregate, uint32_t unixtime) {
+    return false;
+}
+
+bool Transport::send(Journal &journal) {
+    return false;
+}
+
+bool Transport::send(TransportSource &source) {
+    return false;
+}
+
 #endif
 ///////////////////////////////////////////////////////////////////////////////////////////////////
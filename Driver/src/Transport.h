@@ -8,38 +8,138 @@
 // Class to transport all sensor readings of the Weather Station to a server. The readings will
 // be posted to an Influxdb’s REST api.
 // This is a no-op if not run on ESP8266 or ESP32.
+//
+// Requests are encoded into a static buffer, sending does not allocate memory. Requests larger
+// than the buffer are streamed using chunked transfer encoding, one buffer at a time. Requests
+// with more than one line may be compressed using gzip.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Network.h"
 
 #include "Readings.h"
+#include "Batch.h"
+#include "Aggregate.h"
+#include "Journal.h"
+#include "LineProtocol.h"
+#include "Deflate.h"
+#include "Profiler.h"
+#include "Energy.h"
+
+class HttpClient;
+
+// Size of the buffer for encoding requests (and size of chunks).
+#define TRANSPORT_BUFFER_SIZE 1024
+// Size of the buffer for compressed requests (and size of chunks).
+#define TRANSPORT_COMPRESSED_BUFFER_SIZE 512
+
+// Interface of a source of readings to send.
+class TransportSource {
+public:
+    // Returns the next readings to send and gives their time (seconds since 1970-01-01, 0 for
+    // none). Returns NULL if there are no more readings. The readings are valid until the next
+    // call.
+    virtual Readings *next(uint32_t &unixtime) = 0;
+};
 
 class Transport {
 public:
     // Constructs a transporter to the given server at the given port for the given database.
     // Logger is an arbitrary identifier for a specific Weather station.
-    Transport(String server, int port, String database, String logger, String location);
+    // Note: The given strings are not copied and must outlive the transporter.
+    Transport(const char *server, int port, const char *database, const char *logger,
+        const char *location);
 
     // Begin with the given network manager. Must be called before any other method.
-    bool begin(Network *network);
+    // Requests are compressed if compressed is true.
+    bool begin(Network *network, bool compressed = false);
 
     // Sends the given readings to the previously specified server using the previously specified
     // network manager.
     bool send(Readings &readings);
 
+    // Sends all readings kept in the given batch as one request. Each reading is timestamped
+    // using its age and the given current time (seconds since 1970-01-01).
+    bool send(Batch &batch, uint32_t unixtime);
+
+    // Sends the statistics of the current window of the given aggregate as measurement
+    // weather_stats, timestamped with the start of the window or with the given current time
+    // (seconds since 1970-01-01), if the window started without time. Each reading type is sent
+    // as a line of its own with the same timestamp, which the server merges into one point. Fails
+    // without any time.
+    bool send(Aggregate &aggregate, uint32_t unixtime);
+
+    // Sends pending readings of the given journal as one request and marks them as replayed.
+    bool send(Journal &journal);
+
+    // Sends all readings of the given source as one request.
+    bool send(TransportSource &source);
+
+    // Sends the wakes kept by the given profiler as measurement weather_diag with the next
+    // request, which clears them if sent. Wakes without time are skipped.
+    void diagnose(Profiler *diagnostics);
+
+    // Sends the running total of the given energy accounting as measurement weather_energy with
+    // the next request. Nothing is sent before the first cycle was accounted.
+    void account(Energy *accounting);
+
+    // Returns the time given by the server with the last response (seconds since 1970-01-01)
+    // and gives the millis() when the server took that time. Returns 0 if there was none.
+    uint32_t serverTime(unsigned long &at);
+
 private:
-    String server;
+    const char *server;
     int port;
 
-    String user;
-    String token;
+    const char *user;
+    const char *token;
 
-    String database;
+    const char *database;
 
-    String logger;
-    String location;
+    const char *logger;
+    const char *location;
 
     Network *network;
+    bool compressed;
+
+    uint32_t server_time;
+    unsigned long server_time_at;
+
+    Profiler *diagnostics;
+    bool diagnosed; // wakes of the diagnostics are encoded into the current request
+
+    Energy *accounting;
+    bool accounted; // total of the accounting is encoded into the current request
+
+    Aggregate *aggregate; // statistics to encode into the current request, if any
+    uint8_t aggregated; // reading types of the statistics encoded into the current request
+    uint32_t aggregated_time; // timestamp of the statistics
+
+    bool skipped; // a line exceeding the buffer was skipped, the current request fails
+
+    // Encodes the given readings as one line with the given timestamp (0 for none).
+    bool encode(LineProtocol &line, Readings &readings, uint32_t unixtime);
+
+    // Encodes the statistics of the given reading type in the current window of the given
+    // aggregate as one line. Returns false if it does not fit.
+    bool encode(LineProtocol &line, Aggregate &aggregate, Readings::reading_type type);
+
+    // Encodes the wakes kept by the given profiler as one line each. Returns false if not all fit.
+    bool encode(LineProtocol &line, Profiler &diagnostics);
+
+    // Encodes the running total of the given energy accounting as one line. Returns false if it
+    // does not fit.
+    bool encode(LineProtocol &line, Energy &accounting);
+
+    // Encodes readings of the given source, then the statistics, until the buffer is full.
+    // Returns true if there are more lines, which are encoded first on the next call (see carry
+    // and aggregated). Lines, which do not fit into the empty buffer, are skipped.
+    bool fill(LineProtocol &line, TransportSource &source,
+        Readings *&readings, uint32_t &unixtime, bool &carry);
+
+    // Compresses and writes the body of a request starting with the given lines. Returns the
+    // number of lines.
+    unsigned int compress(HttpClient &httpClient, LineProtocol &line, TransportSource &source,
+        Readings *&readings, uint32_t &unixtime, bool &carry, bool more);
 };
 
 #endif
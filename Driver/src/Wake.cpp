@@ -0,0 +1,96 @@
+#include <Arduino.h>
+
+#include "Wake.h"
+
+#include "Memory.h"
+#include "Notification.h"
+#include "System.h"
+
+extern Memory memory;
+extern Notification notification;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    uint32_t remaining; // remaining sleep in milliseconds
+    uint8_t radio; // radio is enabled on the wake after the remaining sleep
+    uint8_t radio_enabled; // radio is enabled on this wake
+    uint16_t reserved;
+} wake_t;
+
+static_assert(sizeof(wake_t) <= MEMORY_WAKE_SIZE, "Wake block too small");
+
+static wake_t wake;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Sleeps for the given duration at most WAKE_SLEEP_MAX and keeps the remaining sleep.
+static void wake_sleep(unsigned long sleep_millis, bool radio);
+
+Wake::Wake(void) {
+}
+
+bool Wake::begin(void) {
+    #if defined(ESP8266) || defined(ESP32)
+    bool awake = System::lastResetReasonIsDeepSleepAwake();
+    #else
+    bool awake = false;
+    #endif
+    if (!awake || !memory.load(Memory::wake, &wake, sizeof(wake))) {
+        // the radio is enabled after power on or reset
+        memset(&wake, 0, sizeof(wake));
+        wake.radio_enabled = true;
+        return true;
+    }
+    if (wake.remaining > 0) {
+        notification.info_millis(F("*WAKE: Continue sleeping for "), wake.remaining);
+        wake_sleep(wake.remaining, wake.radio);
+    }
+    return true;
+}
+
+bool Wake::isRadioEnabled(void) {
+    return wake.radio_enabled;
+}
+
+void Wake::sleep(unsigned long sleep_millis, bool radio) {
+    wake_sleep(sleep_millis, radio);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(ESP8266)
+
+static void wake_sleep(unsigned long sleep_millis, bool radio) {
+    unsigned long chunk = std::min(sleep_millis, WAKE_SLEEP_MAX);
+    wake.remaining = sleep_millis - chunk;
+    wake.radio = radio;
+    wake.radio_enabled = (wake.remaining == 0) && radio;
+    wake.reserved = 0;
+    memory.save(Memory::wake, &wake, sizeof(wake));
+    notification.flush();
+    ESP.deepSleep((uint64_t) chunk * 1000, wake.radio_enabled ? WAKE_RF_DEFAULT : WAKE_RF_DISABLED);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#elif defined(ESP32)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void wake_sleep(unsigned long sleep_millis, bool radio) {
+    // the radio is enabled on demand and deep sleep is not limited
+    memset(&wake, 0, sizeof(wake));
+    wake.radio_enabled = true;
+    memory.save(Memory::wake, &wake, sizeof(wake));
+    notification.flush();
+    ESP.deepSleep((uint64_t) sleep_millis * 1000);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#else
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void wake_sleep(unsigned long sleep_millis, bool radio) {
+    delay(sleep_millis);
+}
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////////////
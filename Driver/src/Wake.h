@@ -0,0 +1,34 @@
+#ifndef __WAKE_H__
+#define __WAKE_H__
+
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Operating Support:
+// Class to plan deep sleep. Before sleeping it is decided, whether the next wake needs the radio,
+// which is disabled otherwise (saving RF calibration and power up of the radio). Sleeps longer
+// than WAKE_SLEEP_MAX are chained: intermediate wakes just count down the remaining sleep in RTC
+// memory and go back to sleep at once.
+// Falls back to delay if not run on ESP8266 or ESP32 (the radio is always enabled then).
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Longest single deep sleep in milliseconds (ESP8266 is limited to about 71 minutes).
+#define WAKE_SLEEP_MAX (60UL * 60 * 1000)
+
+class Wake {
+public:
+    Wake(void);
+
+    // Begin managing wakes. Continues sleeping if this wake only counts down a long sleep, so
+    // this does not return then. Must be called before any other method.
+    bool begin(void);
+
+    // Checks if the radio is enabled on this wake.
+    bool isRadioEnabled(void);
+
+    // Sleeps for the given duration and resets. The radio is enabled on the next wake if radio
+    // is true.
+    void sleep(unsigned long sleep_millis, bool radio);
+};
+
+#endif
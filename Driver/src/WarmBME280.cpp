@@ -0,0 +1,73 @@
+#include <Arduino.h>
+
+#include "WarmBME280.h"
+
+#include "Memory.h"
+#include "System.h"
+
+extern Memory memory;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Registers of BME280
+#define BME280_REGISTER_CONTROL_HUMIDITY 0xF2
+#define BME280_REGISTER_CONFIG 0xF5
+
+typedef struct {
+    uint8_t address;
+    uint8_t chipid;
+    uint8_t control_humidity;
+    uint8_t control;
+    uint8_t config;
+    uint8_t reserved[3];
+    bme280_calib_data calibration;
+} bme280_snapshot_t;
+
+static_assert(sizeof(bme280_snapshot_t) <= MEMORY_BME280_SIZE, "BME280 block too small");
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool WarmBME280::restore(uint8_t address, TwoWire *wire) {
+    #if defined(ESP8266) || defined(ESP32)
+    if (!System::lastResetReasonIsDeepSleepAwake()) {
+        return false;
+    }
+    bme280_snapshot_t snapshot;
+    if (!memory.load(Memory::bme280, &snapshot, sizeof(snapshot)) || snapshot.address != address) {
+        return false;
+    }
+    _i2caddr = address;
+    _wire = wire;
+    _sensorID = snapshot.chipid;
+    _bme280_calib = snapshot.calibration;
+    _humReg.osrs_h = snapshot.control_humidity & 0x07;
+    _measReg.osrs_t = (snapshot.control >> 5) & 0x07;
+    _measReg.osrs_p = (snapshot.control >> 2) & 0x07;
+    _measReg.mode = snapshot.control & 0x03;
+    _configReg.t_sb = (snapshot.config >> 5) & 0x07;
+    _configReg.filter = (snapshot.config >> 2) & 0x07;
+    _configReg.spi3w_en = snapshot.config & 0x01;
+
+    // humidity control takes effect with the next write to the control register, which starts
+    // the next measurement, so the control register itself is not written here
+    write8(BME280_REGISTER_CONTROL_HUMIDITY, _humReg.get());
+    write8(BME280_REGISTER_CONFIG, _configReg.get());
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+bool WarmBME280::save(void) {
+    bme280_snapshot_t snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.address = _i2caddr;
+    snapshot.chipid = _sensorID;
+    snapshot.control_humidity = _humReg.get();
+    snapshot.control = _measReg.get();
+    snapshot.config = _configReg.get();
+    snapshot.calibration = _bme280_calib;
+    return memory.save(Memory::bme280, &snapshot, sizeof(snapshot));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,34 @@
+#ifndef __WARM_BME280_H__
+#define __WARM_BME280_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_BME280.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Weather Station:
+// Class to operate the BME280 sensor with a warm start after deep sleep. After a full
+// initialization by the library, chip id, trimming coefficients and configuration are saved to
+// RTC memory. After waking from deep sleep these are restored instead of probing the sensor,
+// resetting it and reading the coefficients again. Only the configuration registers are written,
+// because the sensor may have been powered down meanwhile.
+//
+// For example:
+//   if (!bme280.restore(address)) {
+//       bme280.begin(address);
+//       bme280.setSampling(...);
+//       bme280.save();
+//   }
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class WarmBME280 : public Adafruit_BME280 {
+public:
+    // Restores the sensor at the given address from RTC memory. Returns false if not woken from
+    // deep sleep or if there is no valid snapshot for this address.
+    bool restore(uint8_t address, TwoWire *wire = &Wire);
+
+    // Saves the current state of the sensor to RTC memory. Call after begin and setSampling.
+    bool save(void);
+};
+
+#endif
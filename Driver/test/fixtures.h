@@ -0,0 +1,60 @@
+#ifndef __TEST_FIXTURES_H__
+#define __TEST_FIXTURES_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Helpers shared by the tests: readings of a station, a source of readings for sending and the
+// CPU time for benchmarks.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <time.h>
+
+#include "Readings.h"
+#include "Transport.h"
+
+namespace fixtures {
+
+// Returns readings with the given temperature (°C) and supply voltage (mV), and constant
+// pressure and humidity.
+inline Readings readings_of(float temperature, float voltage = 3300.0) {
+    Readings readings;
+    readings.store(temperature, Readings::temperature);
+    readings.store(101325.0, Readings::pressure);
+    readings.store(55.5, Readings::humidity);
+    readings.store(voltage, Readings::voltage);
+    return readings;
+}
+
+// Source of the given number of readings, one per minute from 2020-09-13. Does not allocate
+// memory.
+class CountingSource : public TransportSource {
+public:
+    CountingSource(unsigned int count) : count(count), index(0) { }
+
+    Readings *next(uint32_t &unixtime) {
+        if (index == count) {
+            return NULL;
+        }
+        readings = readings_of(15.0 + (index % 100) / 10.0);
+        unixtime = 1600000000 + index * 60;
+        index++;
+        return &readings;
+    }
+
+private:
+    Readings readings;
+    unsigned int count;
+    unsigned int index;
+};
+
+// Returns the CPU time of the test program in nanoseconds.
+inline uint64_t cpu_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef __TEST_HEAP_H__
+#define __TEST_HEAP_H__
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Counts heap allocations of a test program by replacing malloc and friends of the C library
+// (glibc only). Include in exactly one file of a test.
+//
+// For example:
+//   heap::start();
+//   ... code under test ...
+//   heap::stop();
+//   TEST_ASSERT_EQUAL(0, heap::allocations);
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <malloc.h>
+#include <stddef.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+}
+
+namespace heap {
+
+static bool tracking = false;
+static unsigned long allocations = 0; // number of allocations while tracking
+static long current = 0; // bytes allocated since start, less bytes freed
+static long peak = 0; // largest number of bytes allocated since start
+
+// Starts counting allocations.
+static void start(void) {
+    allocations = 0;
+    current = 0;
+    peak = 0;
+    tracking = true;
+}
+
+// Stops counting allocations.
+static void stop(void) {
+    tracking = false;
+}
+
+static void allocated(void *pointer) {
+    if (tracking && pointer != NULL) {
+        allocations++;
+        current += malloc_usable_size(pointer);
+        if (current > peak) {
+            peak = current;
+        }
+    }
+}
+
+static void freed(void *pointer) {
+    if (tracking && pointer != NULL) {
+        current -= malloc_usable_size(pointer);
+    }
+}
+
+}
+
+extern "C" {
+
+void *malloc(size_t size) {
+    void *pointer = __libc_malloc(size);
+    heap::allocated(pointer);
+    return pointer;
+}
+
+void *calloc(size_t count, size_t size) {
+    void *pointer = __libc_calloc(count, size);
+    heap::allocated(pointer);
+    return pointer;
+}
+
+void *realloc(void *pointer, size_t size) {
+    heap::freed(pointer);
+    pointer = __libc_realloc(pointer, size);
+    heap::allocated(pointer);
+    return pointer;
+}
+
+void free(void *pointer) {
+    heap::freed(pointer);
+    __libc_free(pointer);
+}
+
+}
+
+#endif
@@ -0,0 +1,227 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include "Hardware.h"
+
+#include "Aggregate.h"
+#include "Memory.h"
+#include "Readings.h"
+
+#include "../fixtures.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of the statistics of windows: mean and standard deviation of varying readings against
+// their closed form, minimum and maximum packed like readings, windows aligned to the wall-clock
+// and over at their boundaries, and statistics kept across deep sleep.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+extern Memory memory;
+
+using fixtures::readings_of;
+
+// Start of the window of 15 minutes around 2020-09-13 12:26:40.
+#define WINDOW_START 1599999300
+
+static const float temperatures[] = { 12.34, -3.5, 20.0, 7.25, 15.875, -0.01, 9.99, 18.5 };
+#define TEMPERATURES (sizeof(temperatures) / sizeof(temperatures[0]))
+
+// Adds the temperatures above, one per minute from the given time.
+static void add_temperatures(Aggregate &aggregate, uint32_t unixtime) {
+    for (unsigned int i = 0; i < TEMPERATURES; i++) {
+        Readings readings = readings_of(temperatures[i], 3000.0 + i * 10.0);
+        aggregate.add(readings, unixtime > 0 ? unixtime + i * 60 : 0);
+    }
+}
+
+void setUp(void) {
+    native::power_on(NULL);
+    memory.begin();
+}
+
+void tearDown(void) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_mean_and_stddev(void) {
+    Aggregate aggregate(900);
+    aggregate.begin();
+    add_temperatures(aggregate, WINDOW_START + 100);
+
+    double sum = 0.0;
+    for (unsigned int i = 0; i < TEMPERATURES; i++) {
+        sum += temperatures[i];
+    }
+    double expected_mean = sum / TEMPERATURES;
+    double squares = 0.0;
+    for (unsigned int i = 0; i < TEMPERATURES; i++) {
+        squares += (temperatures[i] - expected_mean) * (temperatures[i] - expected_mean);
+    }
+    double expected_stddev = sqrt(squares / (TEMPERATURES - 1));
+
+    uint16_t n;
+    float mean, min, max, stddev;
+    TEST_ASSERT_TRUE(aggregate.get(Readings::temperature, n, mean, min, max, stddev));
+    TEST_ASSERT_EQUAL(TEMPERATURES, n);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, expected_mean, mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, expected_stddev, stddev);
+
+    // voltages 3000, 3010, ... 3070 mV
+    TEST_ASSERT_TRUE(aggregate.get(Readings::voltage, n, mean, min, max, stddev));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 3035.0, mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, sqrt(4200.0 / 7.0), stddev);
+
+    // constant readings do not vary
+    TEST_ASSERT_TRUE(aggregate.get(Readings::pressure, n, mean, min, max, stddev));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 101325.0, mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0.0, stddev);
+
+    // readings not taken have no statistics
+    TEST_ASSERT_FALSE(aggregate.get(Readings::illuminance, n, mean, min, max, stddev));
+    TEST_ASSERT_EQUAL(0, n);
+}
+
+void test_single_value(void) {
+    Aggregate aggregate(900);
+    aggregate.begin();
+    Readings readings = readings_of(21.5);
+    aggregate.add(readings, WINDOW_START);
+
+    uint16_t n;
+    float mean, min, max, stddev;
+    TEST_ASSERT_TRUE(aggregate.get(Readings::temperature, n, mean, min, max, stddev));
+    TEST_ASSERT_EQUAL(1, n);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 21.5, mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 21.5, min);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 21.5, max);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, stddev);
+}
+
+void test_min_and_max_packed(void) {
+    Aggregate aggregate(900);
+    aggregate.begin();
+    add_temperatures(aggregate, WINDOW_START);
+
+    uint16_t n;
+    float mean, min, max, stddev;
+    TEST_ASSERT_TRUE(aggregate.get(Readings::temperature, n, mean, min, max, stddev));
+    // temperatures are packed in steps of 0.01 °C
+    TEST_ASSERT_FLOAT_WITHIN(0.005, -3.5, min);
+    TEST_ASSERT_FLOAT_WITHIN(0.005, 20.0, max);
+
+    // pressure is packed in steps of 2 Pa, the rounding of a constant value must not cross the
+    // mean
+    TEST_ASSERT_TRUE(aggregate.get(Readings::pressure, n, mean, min, max, stddev));
+    TEST_ASSERT_TRUE(min <= mean);
+    TEST_ASSERT_TRUE(max >= mean);
+    TEST_ASSERT_FLOAT_WITHIN(1.0, 101325.0, min);
+    TEST_ASSERT_FLOAT_WITHIN(1.0, 101325.0, max);
+
+    // values beyond the range of packing are clamped
+    Aggregate extremes(900);
+    extremes.begin();
+    extremes.clear();
+    Readings readings = readings_of(400.0);
+    extremes.add(readings, WINDOW_START);
+    readings = readings_of(-400.0);
+    extremes.add(readings, WINDOW_START);
+    TEST_ASSERT_TRUE(extremes.get(Readings::temperature, n, mean, min, max, stddev));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0.0, mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, -327.67, min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 327.67, max);
+}
+
+void test_window_boundaries(void) {
+    Aggregate aggregate(900);
+    aggregate.begin();
+    TEST_ASSERT_FALSE(aggregate.isDue(WINDOW_START + 900));
+
+    // the window starts at a multiple of its duration, not with the first readings
+    Readings readings = readings_of(15.0);
+    aggregate.add(readings, WINDOW_START + 700);
+    TEST_ASSERT_EQUAL(WINDOW_START, aggregate.start());
+    TEST_ASSERT_FALSE(aggregate.isDue(WINDOW_START + 700));
+    TEST_ASSERT_FALSE(aggregate.isDue(WINDOW_START + 899));
+    TEST_ASSERT_TRUE(aggregate.isDue(WINDOW_START + 900));
+    TEST_ASSERT_TRUE(aggregate.isDue(WINDOW_START + 3600));
+    // the clock was set back
+    TEST_ASSERT_TRUE(aggregate.isDue(WINDOW_START - 1));
+    // without time the window is never over
+    TEST_ASSERT_FALSE(aggregate.isDue(0));
+
+    // readings of a later window are added to the window which is over until it is cleared
+    aggregate.add(readings, WINDOW_START + 960);
+    TEST_ASSERT_EQUAL(WINDOW_START, aggregate.start());
+    TEST_ASSERT_EQUAL(2, aggregate.count());
+
+    // the next readings roll over into the window of their time
+    aggregate.clear();
+    TEST_ASSERT_EQUAL(0, aggregate.count());
+    TEST_ASSERT_FALSE(aggregate.isDue(WINDOW_START + 1800));
+    aggregate.add(readings, WINDOW_START + 1799);
+    TEST_ASSERT_EQUAL(WINDOW_START + 900, aggregate.start());
+    TEST_ASSERT_FALSE(aggregate.isDue(WINDOW_START + 1799));
+    TEST_ASSERT_TRUE(aggregate.isDue(WINDOW_START + 1800));
+}
+
+void test_window_without_time(void) {
+    Aggregate aggregate(900);
+    aggregate.begin();
+    add_temperatures(aggregate, 0);
+    TEST_ASSERT_EQUAL(0, aggregate.start());
+    TEST_ASSERT_FALSE(aggregate.isDue(0));
+    // the window is over as soon as the time is known
+    TEST_ASSERT_TRUE(aggregate.isDue(WINDOW_START + 1));
+}
+
+void test_kept_across_deep_sleep(void) {
+    Aggregate aggregate(900);
+    aggregate.begin();
+    for (unsigned int i = 0; i < TEMPERATURES; i++) {
+        Readings readings = readings_of(temperatures[i]);
+        aggregate.add(readings, WINDOW_START + i * 60);
+        native::wake();
+        aggregate.begin();
+    }
+
+    // a new aggregate after waking finds the statistics in RTC memory
+    Aggregate woken(900);
+    woken.begin();
+    TEST_ASSERT_EQUAL(TEMPERATURES, woken.count());
+    TEST_ASSERT_EQUAL(WINDOW_START, woken.start());
+    uint16_t n;
+    float mean, min, max, stddev;
+    TEST_ASSERT_TRUE(woken.get(Readings::temperature, n, mean, min, max, stddev));
+    TEST_ASSERT_EQUAL(TEMPERATURES, n);
+    TEST_ASSERT_FLOAT_WITHIN(0.005, -3.5, min);
+    TEST_ASSERT_FLOAT_WITHIN(0.005, 20.0, max);
+}
+
+void test_invalid_after_power_on(void) {
+    Aggregate aggregate(900);
+    aggregate.begin();
+    add_temperatures(aggregate, WINDOW_START);
+
+    native::power_on(NULL);
+    memory.begin();
+    Aggregate powered(900);
+    powered.begin();
+    TEST_ASSERT_EQUAL(0, powered.count());
+    TEST_ASSERT_EQUAL(0, powered.start());
+    TEST_ASSERT_FALSE(powered.isDue(WINDOW_START + 900));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mean_and_stddev);
+    RUN_TEST(test_single_value);
+    RUN_TEST(test_min_and_max_packed);
+    RUN_TEST(test_window_boundaries);
+    RUN_TEST(test_window_without_time);
+    RUN_TEST(test_kept_across_deep_sleep);
+    RUN_TEST(test_invalid_after_power_on);
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include "Hardware.h"
+
+#include "Batch.h"
+#include "Memory.h"
+#include "Readings.h"
+
+#include "../fixtures.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of the flush policy of batched readings: a batch is due after the configured number of
+// measuring cycles, a full batch drops its oldest record and records keep their age across
+// deep sleep.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+extern Memory memory;
+
+using fixtures::readings_of;
+
+static float temperature_at(Batch &batch, uint8_t index, unsigned long &age) {
+    Readings readings;
+    if (!batch.get(index, readings, age)) {
+        return NAN;
+    }
+    return readings.retrieve(Readings::temperature);
+}
+
+void setUp(void) {
+    native::power_on(NULL);
+    memory.begin();
+}
+
+void tearDown(void) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_batch_due_after_cycles(void) {
+    Batch batch(4);
+    batch.begin();
+    TEST_ASSERT_EQUAL(0, batch.count());
+    TEST_ASSERT_FALSE(batch.isDue());
+
+    for (int cycle = 0; cycle < 3; cycle++) {
+        Readings readings = readings_of(20.0 + cycle);
+        batch.add(readings);
+        TEST_ASSERT_FALSE(batch.isDue());
+    }
+    // the radio is brought up for the cycle, which will complete the batch
+    TEST_ASSERT_TRUE(batch.isDue(1));
+
+    Readings readings = readings_of(23.0);
+    batch.add(readings);
+    TEST_ASSERT_TRUE(batch.isDue());
+    TEST_ASSERT_EQUAL(4, batch.count());
+}
+
+void test_batch_cycles_constrained(void) {
+    Batch single(0);
+    single.begin();
+    TEST_ASSERT_FALSE(single.isDue());
+    TEST_ASSERT_TRUE(single.isDue(1));
+
+    // never more cycles than records fit
+    Batch many(100);
+    many.begin();
+    many.clear();
+    for (int cycle = 0; cycle < BATCH_CAPACITY; cycle++) {
+        TEST_ASSERT_FALSE(many.isDue());
+        Readings readings = readings_of(20.0);
+        many.add(readings);
+    }
+    TEST_ASSERT_TRUE(many.isDue());
+}
+
+void test_batch_drops_oldest_if_full(void) {
+    Batch batch(BATCH_CAPACITY);
+    batch.begin();
+    for (int cycle = 0; cycle < BATCH_CAPACITY + 2; cycle++) {
+        Readings readings = readings_of(10.0 + cycle);
+        batch.add(readings);
+    }
+    TEST_ASSERT_EQUAL(BATCH_CAPACITY, batch.count());
+
+    unsigned long age;
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 12.0, temperature_at(batch, 0, age));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 10.0 + BATCH_CAPACITY + 1,
+        temperature_at(batch, BATCH_CAPACITY - 1, age));
+    TEST_ASSERT_FLOAT_IS_NAN(temperature_at(batch, BATCH_CAPACITY, age));
+}
+
+void test_batch_cleared_after_flush(void) {
+    Batch batch(2);
+    batch.begin();
+    Readings readings = readings_of(20.0);
+    batch.add(readings);
+    batch.add(readings);
+    TEST_ASSERT_TRUE(batch.isDue());
+
+    batch.clear();
+    TEST_ASSERT_EQUAL(0, batch.count());
+    TEST_ASSERT_FALSE(batch.isDue());
+    TEST_ASSERT_FALSE(batch.isDue(1));
+}
+
+void test_batch_kept_across_deep_sleep(void) {
+    Batch batch(4);
+    batch.begin();
+    for (int cycle = 0; cycle < 3; cycle++) {
+        Readings readings = readings_of(20.0 + cycle);
+        batch.add(readings);
+        // a minute of deep sleep between the cycles
+        batch.elapse(60000);
+        native::wake();
+        batch.begin();
+    }
+
+    // a new batch object after waking finds the records in RTC memory
+    Batch woken(4);
+    woken.begin();
+    TEST_ASSERT_EQUAL(3, woken.count());
+    TEST_ASSERT_TRUE(woken.isDue(1));
+
+    unsigned long age;
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 20.0, temperature_at(woken, 0, age));
+    TEST_ASSERT_EQUAL(180, age);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 22.0, temperature_at(woken, 2, age));
+    TEST_ASSERT_EQUAL(60, age);
+}
+
+void test_batch_invalid_after_power_on(void) {
+    Batch batch(4);
+    batch.begin();
+    Readings readings = readings_of(20.0);
+    batch.add(readings);
+
+    // RTC memory holds garbage after power on
+    native::power_on(NULL);
+    Batch fresh(4);
+    fresh.begin();
+    TEST_ASSERT_EQUAL(0, fresh.count());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_due_after_cycles);
+    RUN_TEST(test_batch_cycles_constrained);
+    RUN_TEST(test_batch_drops_oldest_if_full);
+    RUN_TEST(test_batch_cleared_after_flush);
+    RUN_TEST(test_batch_kept_across_deep_sleep);
+    RUN_TEST(test_batch_invalid_after_power_on);
+    return UNITY_END();
+}
@@ -0,0 +1,241 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include <stdlib.h>
+#include <zlib.h>
+
+#include <string>
+
+#include "Deflate.h"
+
+#include "../fixtures.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of the gzip compressor: its output is inflated with zlib, which checks the header, the
+// checksum and the size, and compared with the input. Inputs are random and line protocol data
+// of sizes around the window and given in pieces of different sizes, so matches cross the ends
+// of the window and of the writes. The benchmark gives the ratio and the CPU time for typical
+// requests, next to those of zlib.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Output of the compressor into a string.
+class StringOutput : public Print {
+public:
+    std::string data;
+
+    size_t write(uint8_t c) {
+        data.push_back(c);
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) {
+        data.append(reinterpret_cast<const char *>(buffer), size);
+        return size;
+    }
+};
+
+static Deflate compressor;
+
+// Compresses the given data given in pieces of the given size (all at once for 0).
+static std::string compress(const std::string &data, size_t piece = 0) {
+    StringOutput output;
+    compressor.begin(output);
+    if (piece == 0) {
+        compressor.write(data.data(), data.size());
+    }
+    else {
+        for (size_t position = 0; position < data.size(); position += piece) {
+            compressor.write(data.data() + position, std::min(piece, data.size() - position));
+        }
+    }
+    compressor.end();
+    TEST_ASSERT_EQUAL(data.size(), compressor.sizeIn());
+    TEST_ASSERT_EQUAL(output.data.size(), compressor.sizeOut());
+    return output.data;
+}
+
+// Inflates the given gzip data with zlib. Fails if the data is not a valid gzip stream.
+static std::string inflate(const std::string &data) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    TEST_ASSERT_EQUAL(Z_OK, inflateInit2(&stream, 16 + MAX_WBITS));
+    stream.next_in = (Bytef *) data.data();
+    stream.avail_in = data.size();
+    std::string result;
+    char buffer[4096];
+    int status;
+    do {
+        stream.next_out = (Bytef *) buffer;
+        stream.avail_out = sizeof(buffer);
+        status = ::inflate(&stream, Z_NO_FLUSH);
+        result.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    while (status == Z_OK);
+    inflateEnd(&stream);
+    TEST_ASSERT_EQUAL_MESSAGE(Z_STREAM_END, status, stream.msg ? stream.msg : "inflate");
+    // nothing after the trailer
+    TEST_ASSERT_EQUAL(0, stream.avail_in);
+    return result;
+}
+
+static void round_trip(const std::string &data, size_t piece = 0) {
+    std::string result = inflate(compress(data, piece));
+    TEST_ASSERT_EQUAL(data.size(), result.size());
+    TEST_ASSERT_TRUE(data == result);
+}
+
+static std::string random_data(size_t size, int symbols) {
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (char) (rand() % symbols);
+    }
+    return data;
+}
+
+// Returns lines of readings like the transport sends them, one per minute.
+static std::string line_protocol(unsigned int lines) {
+    std::string data;
+    char line[256];
+    for (unsigned int i = 0; i < lines; i++) {
+        snprintf(line, sizeof(line),
+            "weather,location=terrace,logger=ESP12648430 temperature0=%.4f,temperature1=%.4f,"
+            "pressure=%.4f,humidity=%.4f,voltage=%.4f %u\n",
+            15.0 + (rand() % 300) / 100.0, 14.0 + (rand() % 300) / 100.0,
+            1013.0 + (rand() % 500) / 100.0, 50.0 + (rand() % 1000) / 100.0,
+            3000.0 + rand() % 200, 1600000000 + i * 60);
+        data += line;
+    }
+    return data;
+}
+
+// Sizes around the ends of the window and the window buffer.
+static const size_t EDGES[] = {
+    0, 1, 2, 3, 257, 258, 259, DEFLATE_WINDOW - 1, DEFLATE_WINDOW, DEFLATE_WINDOW + 1,
+    2 * DEFLATE_WINDOW - 1, 2 * DEFLATE_WINDOW, 2 * DEFLATE_WINDOW + 1, 3 * DEFLATE_WINDOW + 7,
+    70000
+};
+
+void setUp(void) {
+    srand(1);
+}
+
+void tearDown(void) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_empty(void) {
+    round_trip(std::string());
+}
+
+void test_random(void) {
+    for (size_t size : EDGES) {
+        round_trip(random_data(size, 256));
+    }
+}
+
+void test_random_few_symbols(void) {
+    // many short matches
+    for (size_t size : EDGES) {
+        round_trip(random_data(size, 3));
+    }
+}
+
+void test_runs(void) {
+    // longest matches at the smallest distance
+    for (size_t size : EDGES) {
+        round_trip(std::string(size, 'a'));
+    }
+}
+
+void test_line_protocol(void) {
+    for (unsigned int lines : { 1, 2, 4, 6, 7, 50, 500 }) {
+        round_trip(line_protocol(lines));
+    }
+}
+
+void test_pieces(void) {
+    std::string data = line_protocol(40) + random_data(3 * DEFLATE_WINDOW, 4) + line_protocol(5);
+    for (size_t piece : { 1, 7, 100, 258, DEFLATE_WINDOW - 1, DEFLATE_WINDOW + 1, 1024 }) {
+        round_trip(data, piece);
+    }
+}
+
+void test_reused(void) {
+    // the state of the last stream must not leak into the next
+    std::string first = line_protocol(20);
+    std::string second = line_protocol(20);
+    compress(first);
+    std::string compressed = compress(second);
+    TEST_ASSERT_TRUE(inflate(compressed) == second);
+    TEST_ASSERT_TRUE(compress(second) == compressed);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+#define BENCHMARK_REPEAT 200
+
+using fixtures::cpu_ns;
+
+static std::string gzip(const std::string &data, int level) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string result(deflateBound(&stream, data.size()), '\0');
+    stream.next_in = (Bytef *) data.data();
+    stream.avail_in = data.size();
+    stream.next_out = (Bytef *) &result[0];
+    stream.avail_out = result.size();
+    ::deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result;
+}
+
+void test_benchmark(void) {
+    // a batch, a replay of the journal after an outage of some hours and a long outage
+    for (unsigned int lines : { 6, 100, 1000 }) {
+        std::string data = line_protocol(lines);
+
+        size_t size = 0;
+        uint64_t start = cpu_ns();
+        for (int i = 0; i < BENCHMARK_REPEAT; i++) {
+            size = compress(data).size();
+        }
+        uint64_t ns = (cpu_ns() - start) / BENCHMARK_REPEAT;
+
+        size_t size_zlib = 0;
+        start = cpu_ns();
+        for (int i = 0; i < BENCHMARK_REPEAT; i++) {
+            size_zlib = gzip(data, Z_DEFAULT_COMPRESSION).size();
+        }
+        uint64_t ns_zlib = (cpu_ns() - start) / BENCHMARK_REPEAT;
+
+        char message[200];
+        snprintf(message, sizeof(message),
+            "%u lines, %zu bytes: deflate %zu bytes (%.1f %%), %.1f us; "
+            "zlib %zu bytes (%.1f %%), %.1f us",
+            lines, data.size(), size, 100.0 * size / data.size(), ns / 1000.0,
+            size_zlib, 100.0 * size_zlib / data.size(), ns_zlib / 1000.0);
+        TEST_MESSAGE(message);
+
+        // lines repeat measurement, tags and keys
+        TEST_ASSERT_LESS_THAN(data.size() / 2, size);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty);
+    RUN_TEST(test_random);
+    RUN_TEST(test_random_few_symbols);
+    RUN_TEST(test_runs);
+    RUN_TEST(test_line_protocol);
+    RUN_TEST(test_pieces);
+    RUN_TEST(test_reused);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,200 @@
+#include <Arduino.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <unity.h>
+
+#include <unistd.h>
+
+#include "Hardware.h"
+
+#include "DS18B20Probes.h"
+#include "Files.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of the slots and the cache of DS18B20 probes: a search fills free slots and frees slots
+// of probes not found, cached probes are not searched after deep sleep unless one did not respond,
+// resolutions are written to the EEPROM of the probes only if changed, and probes powered by the
+// data line are detected with cached ROM addresses, too.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static char fs_root[32];
+
+static Files files;
+
+// The probes as operated by the driver after a reset, with the given number of slots of 10 bit
+// resolution.
+struct Probes {
+    OneWire wire;
+    DallasTemperature sensors;
+    DS18B20Probes probes;
+
+    Probes(uint8_t count, uint8_t resolution = 10) : wire(D6), sensors(&wire), probes(&sensors) {
+        for (uint8_t slot = 0; slot < count; slot++) {
+            probes.configure(slot, resolution, 0.01, 100.0);
+        }
+        TEST_ASSERT_TRUE(probes.begin(count, &files));
+    }
+};
+
+void setUp(void) {
+    strlcpy(fs_root, "/tmp/native_fs_XXXXXX", sizeof(fs_root));
+    TEST_ASSERT_NOT_NULL(mkdtemp(fs_root));
+    native::model.fs_root = fs_root;
+    native::model.ds18b20_count = 2;
+    native::model.ds18b20_parasite = false;
+    native::power_on(NULL);
+    files.begin();
+
+    // the EEPROM of the probes holds the resolution of power on
+    OneWire wire(D6);
+    DallasTemperature sensors(&wire);
+    sensors.setResolution(12);
+}
+
+void tearDown(void) {
+    files.remove("ds18b20");
+    rmdir(fs_root);
+    native::model.fs_root = NULL;
+    native::model.ds18b20_count = 1;
+    native::model.ds18b20_parasite = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_search_fills_slots(void) {
+    Probes probes(3);
+    TEST_ASSERT_EQUAL(1, native::hardware->ds18b20_searches);
+    // the second probe reads 2 °C less in the model
+    TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature, probes.probes.read(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature - 2.0, probes.probes.read(1));
+    TEST_ASSERT_TRUE(isnan(probes.probes.read(2)));
+
+    // more probes than slots
+    native::model.ds18b20_count = 3;
+    files.remove("ds18b20");
+    Probes fewer(2);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature, fewer.probes.read(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature - 2.0, fewer.probes.read(1));
+}
+
+void test_cached_after_deep_sleep(void) {
+    {
+        Probes probes(3);
+    }
+    TEST_ASSERT_EQUAL(1, native::hardware->ds18b20_searches);
+
+    // a free slot is not searched after deep sleep
+    native::wake();
+    Probes woken(3);
+    TEST_ASSERT_EQUAL(1, native::hardware->ds18b20_searches);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature - 2.0, woken.probes.read(1));
+
+    // but after power on, a probe may have been attached
+    native::power_on(NULL);
+    Probes powered(3);
+    TEST_ASSERT_EQUAL(1, native::hardware->ds18b20_searches);
+}
+
+void test_stale_searched_and_freed(void) {
+    {
+        Probes probes(2);
+    }
+
+    // the second probe is removed and does not respond
+    native::model.ds18b20_count = 1;
+    native::wake();
+    {
+        Probes woken(2);
+        TEST_ASSERT_EQUAL(1, native::hardware->ds18b20_searches);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature, woken.probes.read(0));
+        TEST_ASSERT_TRUE(isnan(woken.probes.read(1)));
+    }
+
+    // the next wake searches the bus and frees its slot, the first probe keeps its slot
+    native::wake();
+    {
+        Probes woken(2);
+        TEST_ASSERT_EQUAL(2, native::hardware->ds18b20_searches);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature, woken.probes.read(0));
+        TEST_ASSERT_TRUE(isnan(woken.probes.read(1)));
+    }
+
+    // a free slot does not respond, no search on the next wake
+    native::wake();
+    {
+        Probes woken(2);
+        TEST_ASSERT_EQUAL(2, native::hardware->ds18b20_searches);
+    }
+
+    // the probe attached again fills the free slot after power on
+    native::model.ds18b20_count = 2;
+    native::power_on(NULL);
+    Probes powered(2);
+    TEST_ASSERT_EQUAL(1, native::hardware->ds18b20_searches);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature - 2.0, powered.probes.read(1));
+}
+
+void test_resolution_written_if_changed(void) {
+    {
+        Probes probes(2, 10);
+        TEST_ASSERT_EQUAL(2, native::hardware->ds18b20_writes);
+        TEST_ASSERT_EQUAL(188 + 20, probes.probes.maxMillis());
+    }
+
+    // not written again on the next wake
+    native::wake();
+    {
+        Probes woken(2, 10);
+        TEST_ASSERT_EQUAL(2, native::hardware->ds18b20_writes);
+    }
+
+    // a changed configuration is written once
+    native::wake();
+    {
+        Probes woken(2, 11);
+        TEST_ASSERT_EQUAL(4, native::hardware->ds18b20_writes);
+        TEST_ASSERT_EQUAL(375 + 20, woken.probes.maxMillis());
+    }
+
+    // probes found with the configured resolution are not written
+    files.remove("ds18b20");
+    native::power_on(NULL);
+    Probes powered(2, 11);
+    TEST_ASSERT_EQUAL(1, native::hardware->ds18b20_searches);
+    TEST_ASSERT_EQUAL(0, native::hardware->ds18b20_writes);
+}
+
+void test_parasite_power_with_cache(void) {
+    native::model.ds18b20_parasite = true;
+    {
+        Probes probes(2);
+        TEST_ASSERT_TRUE(probes.sensors.isParasitePowerMode());
+    }
+
+    // cached probes are detected as powered by the data line, too
+    native::wake();
+    Probes woken(2);
+    TEST_ASSERT_TRUE(woken.sensors.isParasitePowerMode());
+    TEST_ASSERT_FLOAT_WITHIN(0.01, native::model.temperature, woken.probes.read(0));
+
+    // externally powered probes are not searched
+    native::model.ds18b20_parasite = false;
+    native::wake();
+    uint32_t searches = native::hardware->ds18b20_searches;
+    Probes powered(2);
+    TEST_ASSERT_FALSE(powered.sensors.isParasitePowerMode());
+    TEST_ASSERT_EQUAL(searches, native::hardware->ds18b20_searches);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_search_fills_slots);
+    RUN_TEST(test_cached_after_deep_sleep);
+    RUN_TEST(test_stale_searched_and_freed);
+    RUN_TEST(test_resolution_written_if_changed);
+    RUN_TEST(test_parasite_power_with_cache);
+    return UNITY_END();
+}
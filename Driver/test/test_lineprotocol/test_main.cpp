@@ -0,0 +1,273 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <unity.h>
+
+#include <string>
+
+#include "Hardware.h"
+#include "Influx.h"
+
+#include "LineProtocol.h"
+#include "Network.h"
+#include "Readings.h"
+#include "Transport.h"
+
+#include "../fixtures.h"
+#include "../heap.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of the line protocol encoder: escaping, formatting of floats, discarding of lines which
+// do not fit and carrying readings over from one buffer to the next when sending. The benchmark
+// counts the allocations and the time to encode a line of readings, compared with building the
+// same line by concatenation of Strings.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static std::string request;
+
+static std::string capture(const std::string &data) {
+    request = data;
+    return "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n";
+}
+
+using fixtures::CountingSource;
+using fixtures::cpu_ns;
+using fixtures::readings_of;
+
+// Returns the body of the given request decoded from chunked transfer encoding. Fails if a
+// chunk does not end with a complete line.
+static std::string dechunk(const std::string &data, unsigned int &chunks) {
+    std::string body;
+    size_t position = data.find("\r\n\r\n") + 4;
+    chunks = 0;
+    while (true) {
+        size_t size = strtoul(data.c_str() + position, NULL, 16);
+        position = data.find("\r\n", position) + 2;
+        if (size == 0) {
+            break;
+        }
+        std::string chunk = data.substr(position, size);
+        TEST_ASSERT_EQUAL('\n', chunk[chunk.size() - 1]);
+        body += chunk;
+        position += size + 2;
+        chunks++;
+    }
+    return body;
+}
+
+void setUp(void) {
+    native::model.responder = capture;
+    native::power_on(NULL);
+    request.clear();
+}
+
+void tearDown(void) {
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_escaping(void) {
+    char buffer[128];
+    LineProtocol line(buffer, sizeof(buffer));
+    line.measurement("weather station,1");
+    line.tag("lo=cation", "ter race,1");
+    line.field("temp=0 1,x", 1.5, 1);
+    TEST_ASSERT_TRUE(line.end());
+    TEST_ASSERT_EQUAL_STRING(
+        "weather\\ station\\,1,lo\\=cation=ter\\ race\\,1 temp\\=0\\ 1\\,x=1.5\n", line.c_str());
+}
+
+void test_float_formatting(void) {
+    char buffer[256];
+    LineProtocol line(buffer, sizeof(buffer));
+    line.measurement("m");
+    line.field("a", 15.9);
+    line.field("b", -0.5, 1);
+    line.field("c", 0.05, 2);
+    line.field("d", 1013.6, 0);
+    line.field("e", 0.125, 2);
+    line.field("f", -273.15, 2);
+    line.field("g", 0.1234567, 9);
+    line.field("h", NAN);
+    line.field("i", INFINITY);
+    line.field("j", 0.0, 3);
+    TEST_ASSERT_TRUE(line.end());
+    TEST_ASSERT_EQUAL_STRING(
+        "m a=15.9000,b=-0.5,c=0.05,d=1014,e=0.13,f=-273.15,g=0.123457,j=0.000\n",
+        line.c_str());
+}
+
+void test_timestamp(void) {
+    char buffer[64];
+    LineProtocol line(buffer, sizeof(buffer));
+    line.measurement("m");
+    line.field("a", 1.0, 0);
+    line.timestamp(1600000000);
+    TEST_ASSERT_TRUE(line.end());
+    TEST_ASSERT_EQUAL_STRING("m a=1 1600000000\n", line.c_str());
+}
+
+void test_line_without_fields_discarded(void) {
+    char buffer[64];
+    LineProtocol line(buffer, sizeof(buffer));
+    line.measurement("m");
+    line.field("a", 1.0, 0);
+    line.end();
+    line.measurement("n");
+    line.tag("t", "v");
+    line.field("b", NAN);
+    TEST_ASSERT_FALSE(line.end());
+    TEST_ASSERT_FALSE(line.overflow());
+    TEST_ASSERT_EQUAL(1, line.lines());
+    TEST_ASSERT_EQUAL_STRING("m a=1\n", line.c_str());
+}
+
+void test_overflowed_line_discarded(void) {
+    char buffer[24];
+    LineProtocol line(buffer, sizeof(buffer));
+    line.measurement("m");
+    line.field("a", 1.0, 0);
+    TEST_ASSERT_TRUE(line.end());
+    line.measurement("measurement");
+    line.field("field", 12345.0, 4);
+    TEST_ASSERT_FALSE(line.end());
+    TEST_ASSERT_TRUE(line.overflow());
+    TEST_ASSERT_EQUAL(1, line.lines());
+    TEST_ASSERT_EQUAL(6, line.length());
+    TEST_ASSERT_EQUAL_STRING("m a=1\n", line.c_str());
+
+    // a line, which fits, is still encoded after an overflow
+    line.measurement("n");
+    line.field("b", 2.0, 0);
+    TEST_ASSERT_TRUE(line.end());
+    TEST_ASSERT_EQUAL_STRING("m a=1\nn b=2\n", line.c_str());
+
+    line.clear();
+    TEST_ASSERT_FALSE(line.overflow());
+    TEST_ASSERT_EQUAL(0, line.lines());
+    TEST_ASSERT_EQUAL_STRING("", line.c_str());
+}
+
+void test_line_exactly_filling_buffer(void) {
+    // "m a=1\n" and the terminating null character
+    char buffer[7];
+    LineProtocol line(buffer, sizeof(buffer));
+    line.measurement("m");
+    line.field("a", 1.0, 0);
+    TEST_ASSERT_TRUE(line.end());
+    TEST_ASSERT_FALSE(line.overflow());
+    TEST_ASSERT_EQUAL_STRING("m a=1\n", line.c_str());
+}
+
+void test_carry_over_between_fills(void) {
+    WiFi.begin("test", "test");
+    WiFi.waitForConnectResult();
+    Network network("test");
+    Transport transport("localhost", 8086, "test", "ESP1", "terrace");
+    transport.begin(&network, false);
+
+    // many more lines than fit into one buffer
+    const unsigned int count = 40;
+    CountingSource source(count);
+    TEST_ASSERT_TRUE(transport.send(source));
+
+    unsigned int chunks;
+    dechunk(request, chunks);
+    TEST_ASSERT_GREATER_THAN(1, chunks);
+
+    // every line arrives once and in order, none is lost at the end of a buffer
+    native::influx::write_t result = native::influx::handle(request);
+    TEST_ASSERT_EQUAL(204, result.status);
+    TEST_ASSERT_EQUAL(count, result.lines);
+    TEST_ASSERT_EQUAL(count, result.points.size());
+    for (unsigned int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL((1600000000LL + i * 60) * 1000000000LL, result.points[i].timestamp);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+#define BENCHMARK_LINES 10000
+
+// Encodes the given readings like Transport encoded them before the line protocol encoder.
+static String encode_by_strings(Readings &readings) {
+    String fields = "";
+    for (int i = 0; i <= Readings::READING_TYPE_MAX; i++) {
+        Readings::reading_type type = static_cast<Readings::reading_type>(i);
+        const char *key = Readings::descriptor(type).field;
+        float value = readings.retrieve(type);
+        if (key != NULL && !isnan(value)) {
+            if (fields.length() > 0) {
+                fields += ",";
+            }
+            fields += String(key) + "=" + String(value, 4);
+        }
+    }
+    return String("weather") + "," + "location=terrace,logger=ESP12648430" + " " + fields + "\n";
+}
+
+void test_benchmark_allocations(void) {
+    Readings readings = readings_of(15.9);
+    char buffer[TRANSPORT_BUFFER_SIZE];
+    LineProtocol line(buffer, sizeof(buffer));
+    size_t length = 0;
+
+    heap::start();
+    uint64_t start = cpu_ns();
+    for (int i = 0; i < BENCHMARK_LINES; i++) {
+        line.clear();
+        line.measurement("weather");
+        line.tag("location", "terrace");
+        line.tag("logger", "ESP12648430");
+        for (int t = 0; t <= Readings::READING_TYPE_MAX; t++) {
+            Readings::reading_type type = static_cast<Readings::reading_type>(t);
+            const char *key = Readings::descriptor(type).field;
+            if (key != NULL) {
+                line.field(key, readings.retrieve(type));
+            }
+        }
+        line.end();
+        length += line.length();
+    }
+    uint64_t encoder_ns = cpu_ns() - start;
+    heap::stop();
+    unsigned long encoder_allocations = heap::allocations;
+
+    heap::start();
+    start = cpu_ns();
+    for (int i = 0; i < BENCHMARK_LINES; i++) {
+        String string = encode_by_strings(readings);
+        length += string.length();
+    }
+    uint64_t strings_ns = cpu_ns() - start;
+    heap::stop();
+    unsigned long strings_allocations = heap::allocations;
+
+    char message[160];
+    snprintf(message, sizeof(message),
+        "line protocol: %.2f allocations/line, %.0f ns/line; strings: %.2f allocations/line, "
+        "%.0f ns/line (%zu bytes)",
+        (double) encoder_allocations / BENCHMARK_LINES, (double) encoder_ns / BENCHMARK_LINES,
+        (double) strings_allocations / BENCHMARK_LINES, (double) strings_ns / BENCHMARK_LINES,
+        length);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL(0, encoder_allocations);
+    TEST_ASSERT_GREATER_THAN(0, strings_allocations);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_escaping);
+    RUN_TEST(test_float_formatting);
+    RUN_TEST(test_timestamp);
+    RUN_TEST(test_line_without_fields_discarded);
+    RUN_TEST(test_overflowed_line_discarded);
+    RUN_TEST(test_line_exactly_filling_buffer);
+    RUN_TEST(test_carry_over_between_fills);
+    RUN_TEST(test_benchmark_allocations);
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include "Hardware.h"
+
+#include "Memory.h"
+#include "Readings.h"
+#include "Scheduler.h"
+
+#include "../fixtures.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of the adaptive measuring interval: stable readings stretch the interval step by step up
+// to its maximum, fast changes shorten it down to its minimum and a low supply voltage stretches
+// it further. The rate of change is taken over the time, which passed between the readings. The
+// previous readings are kept across deep sleep.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+extern Memory memory;
+
+#define INTERVAL 60000UL
+#define INTERVAL_MIN (INTERVAL / 4)
+#define INTERVAL_MAX (INTERVAL * 3)
+
+static Scheduler *scheduler;
+
+using fixtures::readings_of;
+
+// Returns the next interval and sleeps for it.
+static unsigned long next(float temperature, float voltage = 3300.0) {
+    Readings readings = readings_of(temperature, voltage);
+    unsigned long interval = scheduler->next(readings);
+    scheduler->elapse(interval);
+    return interval;
+}
+
+void setUp(void) {
+    native::power_on(NULL);
+    memory.begin();
+    scheduler = new Scheduler(INTERVAL, INTERVAL_MIN, INTERVAL_MAX);
+    scheduler->rate(Readings::temperature, 2.0);
+    scheduler->rate(Readings::humidity, 10.0);
+    scheduler->voltage(3200, 2900, 4);
+    scheduler->begin();
+}
+
+void tearDown(void) {
+    delete scheduler;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_first_cycle(void) {
+    // without previous readings there is no rate of change
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.0));
+}
+
+void test_stretch_while_stable(void) {
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.0));
+    TEST_ASSERT_EQUAL(INTERVAL * 3 / 2, next(20.0));
+    TEST_ASSERT_EQUAL(INTERVAL * 9 / 4, next(20.0));
+    // capped at the maximum
+    TEST_ASSERT_EQUAL(INTERVAL_MAX, next(20.0));
+    TEST_ASSERT_EQUAL(INTERVAL_MAX, next(20.0));
+}
+
+void test_stretch_below_stable_rate(void) {
+    // 0.01 °C per minute is 0.6 °C per hour, below half of the fast rate
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.0));
+    TEST_ASSERT_EQUAL(INTERVAL * 3 / 2, next(20.01));
+}
+
+void test_base_between_stable_and_fast(void) {
+    // 1.5 °C per hour is neither stable nor fast
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.0));
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.025));
+}
+
+void test_shorten_while_fast(void) {
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.0));
+    TEST_ASSERT_EQUAL(INTERVAL * 3 / 2, next(20.0));
+    // 0.2 °C in 90 seconds is 8 °C per hour, four times the fast rate
+    TEST_ASSERT_EQUAL(INTERVAL / 4, next(20.2));
+    // even faster changes do not shorten below the minimum
+    TEST_ASSERT_EQUAL(INTERVAL_MIN, next(25.0));
+}
+
+void test_stretch_starts_over_after_change(void) {
+    next(20.0);
+    next(20.0);
+    next(20.0);
+    TEST_ASSERT_EQUAL(INTERVAL_MAX, next(20.0));
+    // 0.25 °C in 3 minutes is 5 °C per hour
+    TEST_ASSERT_EQUAL(INTERVAL * 2 / 5, next(20.25));
+    // stretched from the base interval again
+    TEST_ASSERT_EQUAL(INTERVAL * 3 / 2, next(20.25));
+    TEST_ASSERT_EQUAL(INTERVAL * 9 / 4, next(20.25));
+}
+
+void test_voltage_stretch(void) {
+    // above full: not stretched
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.0, 3200.0));
+    native::power_on(NULL);
+    scheduler->begin();
+    // halfway between full and low: stretched by half of the factor
+    TEST_ASSERT_EQUAL(INTERVAL * 5 / 2, next(20.0, 3050.0));
+    native::power_on(NULL);
+    scheduler->begin();
+    // below low: fully stretched
+    TEST_ASSERT_EQUAL(INTERVAL * 4, next(20.0, 2800.0));
+}
+
+void test_voltage_stretch_steps(void) {
+    // the stable stretch takes its steps while the voltage stretches the interval
+    TEST_ASSERT_EQUAL(INTERVAL * 4, next(20.0, 2800.0));
+    TEST_ASSERT_EQUAL(INTERVAL * 3 / 2 * 4, next(20.0, 2800.0));
+    TEST_ASSERT_EQUAL(INTERVAL * 9 / 4 * 4, next(20.0, 2800.0));
+    TEST_ASSERT_EQUAL(INTERVAL_MAX * 4, next(20.0, 2800.0));
+}
+
+void test_rate_over_elapsed_time(void) {
+    Readings readings = readings_of(20.0);
+    TEST_ASSERT_EQUAL(INTERVAL, scheduler->next(readings));
+    // slept ten times as long as planned: 0.2 °C in 10 minutes is 1.2 °C per hour, not fast
+    scheduler->elapse(INTERVAL * 10);
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.2));
+}
+
+void test_voltage_stretch_cap(void) {
+    next(20.0, 2800.0);
+    next(20.0, 2800.0);
+    next(20.0, 2800.0);
+    // the stable stretch is capped at the maximum before the voltage stretches it
+    TEST_ASSERT_EQUAL(INTERVAL_MAX * 4, next(20.0, 2800.0));
+    TEST_ASSERT_EQUAL(INTERVAL_MAX * 4, next(20.0, 2800.0));
+    // the voltage recovers
+    TEST_ASSERT_EQUAL(INTERVAL_MAX, next(20.0, 3300.0));
+}
+
+void test_kept_across_deep_sleep(void) {
+    TEST_ASSERT_EQUAL(INTERVAL, next(20.0));
+    native::wake();
+
+    Scheduler woken(INTERVAL, INTERVAL_MIN, INTERVAL_MAX);
+    woken.rate(Readings::temperature, 2.0);
+    woken.begin();
+    Readings readings = readings_of(20.0);
+    TEST_ASSERT_EQUAL(INTERVAL * 3 / 2, woken.next(readings));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_cycle);
+    RUN_TEST(test_stretch_while_stable);
+    RUN_TEST(test_stretch_below_stable_rate);
+    RUN_TEST(test_base_between_stable_and_fast);
+    RUN_TEST(test_shorten_while_fast);
+    RUN_TEST(test_stretch_starts_over_after_change);
+    RUN_TEST(test_voltage_stretch);
+    RUN_TEST(test_voltage_stretch_steps);
+    RUN_TEST(test_rate_over_elapsed_time);
+    RUN_TEST(test_voltage_stretch_cap);
+    RUN_TEST(test_kept_across_deep_sleep);
+    return UNITY_END();
+}
@@ -0,0 +1,77 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "Hardware.h"
+#include "Simulator.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of the driver running wake after wake in the simulation. The spans of the network must
+// reach the server, although most wakes only read sensors and the spans of few wakes are kept.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static char fs_root[32];
+
+// Returns the value of the given key of the report of the last simulation (-1 if missing).
+static long report(const char *key) {
+    char *text = NULL;
+    size_t size = 0;
+    FILE *file = open_memstream(&text, &size);
+    native::print_report(file);
+    fclose(file);
+    std::string prefix = std::string("\n") + key + "=";
+    std::string lines = "\n" + std::string(text, size);
+    free(text);
+    size_t position = lines.find(prefix);
+    return position == std::string::npos ? -1 : atol(lines.c_str() + position + prefix.size());
+}
+
+void setUp(void) {
+    strlcpy(fs_root, "/tmp/native_fs_XXXXXX", sizeof(fs_root));
+    TEST_ASSERT_NOT_NULL(mkdtemp(fs_root));
+    native::model.fs_root = fs_root;
+    native::model.responder = native::stand_in;
+    native::model.serial_echo = false;
+    native::power_on(NULL);
+}
+
+void tearDown(void) {
+    DIR *dir = opendir(fs_root);
+    if (dir != NULL) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] != '.') {
+                unlink((std::string(fs_root) + "/" + entry->d_name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(fs_root);
+    native::model.fs_root = NULL;
+    native::model.responder = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_network_spans_sent(void) {
+    native::simulation.wakes = 40;
+    native::simulate(false);
+    TEST_ASSERT_GREATER_THAN(0, report("requests"));
+    TEST_ASSERT_GREATER_THAN(0, report("diagnostics"));
+    // lines of spans with the fields associate and request
+    TEST_ASSERT_GREATER_THAN(0, report("radio_diagnostics"));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_network_spans_sent);
+    return UNITY_END();
+}
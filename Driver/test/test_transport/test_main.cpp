@@ -0,0 +1,307 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <unity.h>
+
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "Hardware.h"
+#include "Influx.h"
+
+#include "Aggregate.h"
+#include "Memory.h"
+#include "Network.h"
+#include "Readings.h"
+#include "Transport.h"
+
+#include "../fixtures.h"
+#include "../heap.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Native Support:
+// Tests of sending batches of readings in chunks against a stand-in server on localhost, which
+// runs in a child process and decodes requests like InfluxDB. The peak of the heap while sending
+// must not grow with the number of readings, as only one buffer of lines is kept at a time.
+// Statistics of all reading types exceed the buffer, so they are sent across chunks, all lines
+// with the same timestamp. The time of the server is taken from valid Date headers of responses
+// only.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+extern Memory memory;
+
+using fixtures::CountingSource;
+
+// Heap, which may be used in addition while sending a larger batch (bytes).
+#define TRANSPORT_HEAP_GROWTH_MAX 256
+
+static pid_t server = -1;
+static int server_results = -1; // pipe of the number of points written per request
+
+// Answers requests on the given socket like InfluxDB and writes the number of points of each
+// request to the given pipe.
+static void serve(int listener, int results) {
+    while (true) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            _exit(0);
+        }
+        std::string data;
+        char buffer[4096];
+        long size;
+        while ((size = native::influx::request_size(data)) == 0) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                break;
+            }
+            data.append(buffer, n);
+        }
+        uint32_t points = 0;
+        if (size > 0) {
+            native::influx::write_t result = native::influx::handle(data.substr(0, size));
+            std::string response = native::influx::response(result, time(NULL));
+            send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+            points = result.status == 204 ? result.points.size() : 0;
+        }
+        close(fd);
+        if (write(results, &points, sizeof(points)) != sizeof(points)) {
+            _exit(1);
+        }
+    }
+}
+
+// Starts the stand-in server and directs connections of the virtual hardware to it.
+static void start_server(void) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    TEST_ASSERT_EQUAL(0, bind(listener, (struct sockaddr *) &address, sizeof(address)));
+    TEST_ASSERT_EQUAL(0, listen(listener, 4));
+    TEST_ASSERT_EQUAL(0, getsockname(listener, (struct sockaddr *) &address, &length));
+
+    int results[2];
+    TEST_ASSERT_EQUAL(0, pipe(results));
+    server = fork();
+    if (server == 0) {
+        close(results[0]);
+        serve(listener, results[1]);
+    }
+    close(listener);
+    close(results[1]);
+    server_results = results[0];
+
+    native::model.responder = NULL;
+    native::model.server_host = "127.0.0.1";
+    native::model.server_port = ntohs(address.sin_port);
+}
+
+static void stop_server(void) {
+    if (server > 0) {
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+        close(server_results);
+        server = -1;
+    }
+}
+
+// Returns the number of points written by the last request.
+static uint32_t server_points(void) {
+    uint32_t points = 0;
+    TEST_ASSERT_EQUAL(sizeof(points), read(server_results, &points, sizeof(points)));
+    return points;
+}
+
+// Sends the given number of readings and gives the peak of the heap while sending.
+static void send_readings(Transport &transport, unsigned int count, long &peak) {
+    CountingSource source(count);
+    heap::start();
+    bool sent = transport.send(source);
+    heap::stop();
+    peak = heap::peak;
+    TEST_ASSERT_TRUE(sent);
+    TEST_ASSERT_EQUAL(count, server_points());
+}
+
+static void test_heap_flat(bool compressed) {
+    start_server();
+    WiFi.begin("test", "test");
+    WiFi.waitForConnectResult();
+    Network network("test");
+    Transport transport("localhost", 8086, "test", "ESP1", "terrace");
+    transport.begin(&network, compressed);
+
+    long peaks[3];
+    send_readings(transport, 10, peaks[0]);
+    send_readings(transport, 100, peaks[1]);
+    send_readings(transport, 1000, peaks[2]);
+    stop_server();
+
+    char message[96];
+    snprintf(message, sizeof(message), "peak of heap: %ld bytes (10), %ld bytes (100), "
+        "%ld bytes (1000 readings)", peaks[0], peaks[1], peaks[2]);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_OR_EQUAL(peaks[0] + TRANSPORT_HEAP_GROWTH_MAX, peaks[1]);
+    TEST_ASSERT_LESS_OR_EQUAL(peaks[0] + TRANSPORT_HEAP_GROWTH_MAX, peaks[2]);
+}
+
+void setUp(void) {
+    native::power_on(NULL);
+}
+
+void tearDown(void) {
+    stop_server();
+    native::model.server_host = NULL;
+    native::model.server_port = 0;
+    native::model.responder = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void test_chunked_heap_flat(void) {
+    test_heap_flat(false);
+}
+
+void test_compressed_heap_flat(void) {
+    test_heap_flat(true);
+}
+
+void test_single_line_sent(void) {
+    start_server();
+    WiFi.begin("test", "test");
+    WiFi.waitForConnectResult();
+    Network network("test");
+    Transport transport("localhost", 8086, "test", "ESP1", "terrace");
+    transport.begin(&network, true);
+
+    Readings readings;
+    readings.store(15.0, Readings::temperature);
+    TEST_ASSERT_TRUE(transport.send(readings));
+    TEST_ASSERT_EQUAL(1, server_points());
+}
+
+void test_statistics_split(void) {
+    memory.begin();
+    Aggregate aggregate(900);
+    aggregate.begin();
+    unsigned int types = 0;
+    Readings readings;
+    for (int i = 0; i <= Readings::READING_TYPE_MAX; i++) {
+        Readings::reading_type type = static_cast<Readings::reading_type>(i);
+        readings.store(-1234.5678 + i, type);
+        types += Readings::descriptor(type).field != NULL ? 1 : 0;
+    }
+    for (unsigned int cycle = 0; cycle < 10; cycle++) {
+        aggregate.add(readings, 1600000000 + cycle * 60);
+    }
+
+    start_server();
+    WiFi.begin("test", "test");
+    WiFi.waitForConnectResult();
+    Network network("test");
+    Transport transport("localhost", 8086, "test", "ESP1", "terrace");
+    transport.begin(&network, false);
+
+    // one line per reading type, all with the start of the window
+    TEST_ASSERT_TRUE(transport.send(aggregate, 1600000900));
+    TEST_ASSERT_EQUAL(types, server_points());
+}
+
+static std::string request;
+
+static std::string capture(const std::string &data) {
+    request = data;
+    return "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n";
+}
+
+// Sends the statistics of the given aggregate at the given time and checks, that all lines
+// have the given timestamp.
+static void send_statistics_at(Aggregate &aggregate, uint32_t unixtime, uint32_t timestamp) {
+    request.clear();
+    native::model.responder = capture;
+    WiFi.begin("test", "test");
+    WiFi.waitForConnectResult();
+    Network network("test");
+    Transport transport("localhost", 8086, "test", "ESP1", "terrace");
+    transport.begin(&network, false);
+    TEST_ASSERT_TRUE(transport.send(aggregate, unixtime));
+
+    native::influx::write_t result = native::influx::handle(request);
+    TEST_ASSERT_EQUAL(204, result.status);
+    TEST_ASSERT_GREATER_THAN(1, result.points.size());
+    for (size_t i = 0; i < result.points.size(); i++) {
+        TEST_ASSERT_EQUAL(timestamp * 1000000000LL, result.points[i].timestamp);
+    }
+}
+
+void test_statistics_timestamp(void) {
+    memory.begin();
+    Aggregate aggregate(900);
+    aggregate.begin();
+    Readings readings = fixtures::readings_of(15.0);
+    aggregate.add(readings, 1600000000);
+    aggregate.add(readings, 1600000060);
+
+    // the start of the window, not the time of sending
+    send_statistics_at(aggregate, 1600000960, 1599999300);
+
+    // a window started without time takes the time of sending
+    aggregate.clear();
+    aggregate.add(readings, 0);
+    send_statistics_at(aggregate, 1600000960, 1600000960);
+
+    // not sent without any time
+    Transport transport("localhost", 8086, "test", "ESP1", "terrace");
+    TEST_ASSERT_FALSE(transport.send(aggregate, 0));
+}
+
+// Answers requests with the date of the response set below.
+static const char *response_date = NULL;
+
+static std::string respond_with_date(const std::string &) {
+    return std::string("HTTP/1.1 204 No Content\r\nDate: ") + response_date +
+        "\r\nContent-Length: 0\r\n\r\n";
+}
+
+static uint32_t server_time_for(const char *date) {
+    response_date = date;
+    native::model.responder = respond_with_date;
+    WiFi.begin("test", "test");
+    WiFi.waitForConnectResult();
+    Network network("test");
+    Transport transport("localhost", 8086, "test", "ESP1", "terrace");
+    transport.begin(&network, false);
+    Readings readings = fixtures::readings_of(15.0);
+    TEST_ASSERT_TRUE(transport.send(readings));
+    unsigned long at;
+    return transport.serverTime(at);
+}
+
+void test_server_time(void) {
+    TEST_ASSERT_EQUAL(1609459200, server_time_for("Fri, 01 Jan 2021 00:00:00 GMT"));
+    TEST_ASSERT_EQUAL(1638316800, server_time_for("Wed, 01 Dec 2021 00:00:00 GMT"));
+    // month names are matched as a whole only
+    TEST_ASSERT_EQUAL(0, server_time_for("Fri, 01 anF 2021 00:00:00 GMT"));
+    TEST_ASSERT_EQUAL(0, server_time_for("Fri, 01 Foo 2021 00:00:00 GMT"));
+    TEST_ASSERT_EQUAL(0, server_time_for("01.01.2021"));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_chunked_heap_flat);
+    RUN_TEST(test_compressed_heap_flat);
+    RUN_TEST(test_single_line_sent);
+    RUN_TEST(test_statistics_split);
+    RUN_TEST(test_statistics_timestamp);
+    RUN_TEST(test_server_time);
+    return UNITY_END();
+}